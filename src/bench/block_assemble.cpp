@@ -67,6 +67,8 @@ static void AssembleBlock(benchmark::State& state)
     SelectParams(CBaseChainParams::REGTEST);
 
     InitScriptExecutionCache();
+    InitZerocoinProofCache();
+    InitRangeProofCache();
 
     boost::thread_group thread_group;
     CScheduler scheduler;
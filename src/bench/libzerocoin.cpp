@@ -0,0 +1,304 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <hash.h>
+#include <key.h>
+#include <libzerocoin/Accumulator.h>
+#include <libzerocoin/CoinSpend.h>
+#include <libzerocoin/Params.h>
+#include <libzerocoin/SerialNumberSoK_small.h>
+#include <random.h>
+#include <veil/zerocoin/zchain.h>
+
+#include <boost/thread.hpp>
+
+static const libzerocoin::ZerocoinParams* BenchZerocoinParams()
+{
+    static std::unique_ptr<const CChainParams> chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    return chainParams->Zerocoin_Params();
+}
+
+// The SoK group generators raised to random exponents mod q, the shape of the products in getFinal_gh
+static void SetupSoKMultiExp(size_t nSize, CBN_vector& vBases, CBN_vector& vExps)
+{
+    const libzerocoin::IntegerGroupParams& group = BenchZerocoinParams()->serialNumberSoKCommitmentGroup;
+    vBases.assign(group.gis.begin(), group.gis.begin() + nSize);
+    vExps.clear();
+    for (size_t i = 0; i < nSize; i++)
+        vExps.emplace_back(CBigNum::randBignum(group.groupOrder));
+}
+
+static void PowModProduct(benchmark::State& state, size_t nSize)
+{
+    CBN_vector vBases, vExps;
+    SetupSoKMultiExp(nSize, vBases, vExps);
+    const CBigNum& p = BenchZerocoinParams()->serialNumberSoKCommitmentGroup.modulus;
+
+    while (state.KeepRunning()) {
+        CBigNum ret = CBigNum(1);
+        for (size_t i = 0; i < nSize; i++)
+            ret = ret.mul_mod(vBases[i].pow_mod(vExps[i], p), p);
+    }
+}
+
+static void MultiPowMod(benchmark::State& state, size_t nSize)
+{
+    CBN_vector vBases, vExps;
+    SetupSoKMultiExp(nSize, vBases, vExps);
+    const CBigNum& p = BenchZerocoinParams()->serialNumberSoKCommitmentGroup.modulus;
+
+    while (state.KeepRunning()) {
+        CBigNum ret = CBigNum::multi_pow_mod(vBases, vExps, p);
+    }
+}
+
+static const uint32_t BENCH_COINS = 16;
+
+// A ZQ_TEN coin derived from nSeed like CzWallet::SeedToZerocoin() derives deterministic mints: the serial
+// comes from a key pair, then the randomness is rehashed until the commitment is a prime in the coin range
+static libzerocoin::PrivateCoin DeriveBenchCoin(uint32_t nSeed)
+{
+    const libzerocoin::ZerocoinParams* params = BenchZerocoinParams();
+    const libzerocoin::IntegerGroupParams& group = params->coinCommitmentGroup;
+
+    uint256 nSeedPrivKey = ArithToUint256(arith_uint256(nSeed));
+    CKey key;
+    CBigNum bnSerial;
+    do {
+        nSeedPrivKey = Hash(nSeedPrivKey.begin(), nSeedPrivKey.end());
+    } while (!libzerocoin::GenerateKeyPair(group.groupOrder, nSeedPrivKey, key, bnSerial));
+
+    CBigNum bnRandomness;
+    for (arith_uint256 nAttempt = 0; ; nAttempt++) {
+        uint256 hashAttempt = ArithToUint256(nAttempt);
+        bnRandomness.setuint256(Hash(nSeedPrivKey.begin(), nSeedPrivKey.end(), hashAttempt.begin(), hashAttempt.end()));
+        bnRandomness = bnRandomness % group.groupOrder;
+
+        CBigNum bnValue = libzerocoin::Commitment(&group, bnSerial, bnRandomness).getCommitmentValue();
+        if (bnValue >= params->accumulatorParams.minCoinValue && bnValue <= params->accumulatorParams.maxCoinValue &&
+                bnValue.isPrime(ZEROCOIN_MINT_PRIME_PARAM))
+            break;
+    }
+
+    libzerocoin::PrivateCoin coin(params, libzerocoin::CoinDenomination::ZQ_TEN, bnSerial, bnRandomness);
+    coin.setPrivKey(key.GetPrivKey());
+    coin.setVersion(libzerocoin::PrivateCoin::CURRENT_VERSION);
+    return coin;
+}
+
+// The coins of the benches, derived once from fixed seeds so that every run works on the same values
+static const std::vector<libzerocoin::PrivateCoin>& BenchCoins()
+{
+    static std::vector<libzerocoin::PrivateCoin> vCoins;
+    if (vCoins.empty()) {
+        for (uint32_t i = 0; i < BENCH_COINS; i++)
+            vCoins.push_back(DeriveBenchCoin(i));
+    }
+    return vCoins;
+}
+
+// Enough signatures of knowledge over the bench coins to give ThreadedBatchVerify() four groups
+static const size_t BENCH_SOK_PROOFS = 28;
+
+static const std::vector<libzerocoin::SerialNumberSoKProof>& BenchSoKProofs()
+{
+    static std::vector<libzerocoin::SerialNumberSoKProof> vProofs;
+    if (vProofs.empty()) {
+        const libzerocoin::ZerocoinParams* params = BenchZerocoinParams();
+        const std::vector<libzerocoin::PrivateCoin>& vCoins = BenchCoins();
+        for (size_t i = 0; i < BENCH_SOK_PROOFS; i++) {
+            const libzerocoin::PrivateCoin& coin = vCoins[i % vCoins.size()];
+            libzerocoin::Commitment commitment(&params->serialNumberSoKCommitmentGroup, coin.getPublicCoin().getValue());
+            uint256 msghash = ArithToUint256(arith_uint256(i));
+            libzerocoin::SerialNumberSoK_small sok(params, coin, commitment, msghash);
+            vProofs.emplace_back(sok, coin.getSerialNumber(), commitment.getCommitmentValue(), msghash);
+        }
+    }
+    return vProofs;
+}
+
+// The bench coins accumulated on top of an empty checkpoint
+static const libzerocoin::Accumulator& BenchAccumulator()
+{
+    static std::unique_ptr<libzerocoin::Accumulator> accumulator;
+    if (!accumulator) {
+        accumulator.reset(new libzerocoin::Accumulator(BenchZerocoinParams(), libzerocoin::CoinDenomination::ZQ_TEN));
+        for (const libzerocoin::PrivateCoin& coin : BenchCoins())
+            *accumulator += coin.getPublicCoin();
+    }
+    return *accumulator;
+}
+
+static void ZerocoinSoKProve(benchmark::State& state)
+{
+    const libzerocoin::ZerocoinParams* params = BenchZerocoinParams();
+    const libzerocoin::PrivateCoin& coin = BenchCoins()[0];
+    libzerocoin::Commitment commitment(&params->serialNumberSoKCommitmentGroup, coin.getPublicCoin().getValue());
+    uint256 msghash = ArithToUint256(arith_uint256(1));
+
+    while (state.KeepRunning()) {
+        libzerocoin::SerialNumberSoK_small sok(params, coin, commitment, msghash);
+    }
+}
+
+static void ZerocoinSoKVerify(benchmark::State& state)
+{
+    const libzerocoin::ZerocoinParams* params = BenchZerocoinParams();
+    const libzerocoin::PrivateCoin& coin = BenchCoins()[0];
+    libzerocoin::Commitment commitment(&params->serialNumberSoKCommitmentGroup, coin.getPublicCoin().getValue());
+    uint256 msghash = ArithToUint256(arith_uint256(1));
+    libzerocoin::SerialNumberSoK_small sok(params, coin, commitment, msghash);
+
+    while (state.KeepRunning()) {
+        bool fValid = sok.Verify(coin.getSerialNumber(), commitment.getCommitmentValue(), msghash);
+        assert(fValid);
+    }
+}
+
+// Verification of a batch of signatures of knowledge, dominated by the vector math of the inner product argument
+static void ZerocoinSoKBatchVerify(benchmark::State& state, size_t nSize)
+{
+    std::vector<const libzerocoin::SerialNumberSoKProof*> vProofs;
+    for (size_t i = 0; i < nSize; i++)
+        vProofs.push_back(&BenchSoKProofs()[i]);
+
+    while (state.KeepRunning()) {
+        bool fValid = libzerocoin::SerialNumberSoKProof::BatchVerify(vProofs);
+        assert(fValid);
+    }
+}
+
+// The proofs split over the batch verify queue, with the calling thread joining nThreads - 1 workers
+static void ZerocoinThreadedBatchVerify(benchmark::State& state, int nThreads)
+{
+    const std::vector<libzerocoin::SerialNumberSoKProof>& vProofs = BenchSoKProofs();
+
+    boost::thread_group threadGroup;
+    for (int i = 0; i < nThreads - 1; i++)
+        threadGroup.create_thread(&ThreadBatchVerify);
+
+    while (state.KeepRunning()) {
+        bool fValid = ThreadedBatchVerify(&vProofs, nThreads);
+        assert(fValid);
+    }
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+}
+
+static void ZerocoinAccumulatorIncrement(benchmark::State& state)
+{
+    libzerocoin::Accumulator accumulator(BenchZerocoinParams(), libzerocoin::CoinDenomination::ZQ_TEN);
+    const CBigNum& bnValue = BenchCoins()[0].getPublicCoin().getValue();
+
+    while (state.KeepRunning()) {
+        accumulator.increment(bnValue);
+    }
+}
+
+static void ZerocoinWitnessAddElement(benchmark::State& state)
+{
+    const libzerocoin::ZerocoinParams* params = BenchZerocoinParams();
+    libzerocoin::Accumulator checkpoint(params, libzerocoin::CoinDenomination::ZQ_TEN);
+    libzerocoin::AccumulatorWitness witness(params, checkpoint, BenchCoins()[0].getPublicCoin());
+    const libzerocoin::PublicCoin& pubcoin = BenchCoins()[1].getPublicCoin();
+
+    while (state.KeepRunning()) {
+        witness.AddElement(pubcoin);
+    }
+}
+
+static void ZerocoinCoinSpend(benchmark::State& state)
+{
+    const libzerocoin::ZerocoinParams* params = BenchZerocoinParams();
+    libzerocoin::Accumulator accumulator = BenchAccumulator();
+    libzerocoin::Accumulator checkpoint(params, libzerocoin::CoinDenomination::ZQ_TEN);
+    const libzerocoin::PrivateCoin& coin = BenchCoins()[0];
+    libzerocoin::AccumulatorWitness witness(params, checkpoint, coin.getPublicCoin());
+    for (const libzerocoin::PrivateCoin& other : BenchCoins())
+        witness.AddElement(other.getPublicCoin());
+    uint256 checksum = ArithToUint256(arith_uint256(1));
+    uint256 ptxHash = ArithToUint256(arith_uint256(2));
+
+    while (state.KeepRunning()) {
+        libzerocoin::CoinSpend spend(params, coin, accumulator, checksum, witness, ptxHash, libzerocoin::SpendType::SPEND);
+    }
+}
+
+// The inputs of a zerocoin spend transaction, built like CreateZerocoinSpendTransaction() does on nThreads threads
+static const size_t BENCH_SPEND_INPUTS = 4;
+
+static void ZerocoinCreateCoinSpends(benchmark::State& state, int nThreads)
+{
+    const libzerocoin::ZerocoinParams* params = BenchZerocoinParams();
+    const std::vector<libzerocoin::PrivateCoin>& vCoins = BenchCoins();
+    libzerocoin::Accumulator checkpoint(params, libzerocoin::CoinDenomination::ZQ_TEN);
+    std::vector<libzerocoin::Accumulator> vAccumulators(BENCH_SPEND_INPUTS, BenchAccumulator());
+    std::vector<libzerocoin::AccumulatorWitness> vWitnesses;
+    for (size_t i = 0; i < BENCH_SPEND_INPUTS; i++) {
+        vWitnesses.emplace_back(params, checkpoint, vCoins[i].getPublicCoin());
+        for (const libzerocoin::PrivateCoin& other : vCoins)
+            vWitnesses.back().AddElement(other.getPublicCoin());
+    }
+    uint256 checksum = ArithToUint256(arith_uint256(1));
+    uint256 ptxHash = ArithToUint256(arith_uint256(2));
+
+    while (state.KeepRunning()) {
+        std::vector<CoinSpendJob> vJobs(BENCH_SPEND_INPUTS);
+        for (size_t i = 0; i < BENCH_SPEND_INPUTS; i++) {
+            vJobs[i].coin = &vCoins[i];
+            vJobs[i].accumulator = &vAccumulators[i];
+            vJobs[i].nChecksum = checksum;
+            vJobs[i].witness = &vWitnesses[i];
+        }
+        bool fValid = ThreadedCreateCoinSpends(params, vJobs, ptxHash, nThreads);
+        assert(fValid);
+    }
+}
+
+static void ZerocoinMintPrivateCoin(benchmark::State& state)
+{
+    const libzerocoin::ZerocoinParams* params = BenchZerocoinParams();
+
+    while (state.KeepRunning()) {
+        libzerocoin::PrivateCoin coin(params, libzerocoin::CoinDenomination::ZQ_TEN, true);
+    }
+}
+
+static void ZerocoinPowModProduct16(benchmark::State& state) { PowModProduct(state, 16); }
+static void ZerocoinPowModProduct512(benchmark::State& state) { PowModProduct(state, ZKP_N); }
+static void ZerocoinMultiPowMod16(benchmark::State& state) { MultiPowMod(state, 16); }
+static void ZerocoinMultiPowMod512(benchmark::State& state) { MultiPowMod(state, ZKP_N); }
+
+BENCHMARK(ZerocoinPowModProduct16, 200);
+BENCHMARK(ZerocoinPowModProduct512, 5);
+BENCHMARK(ZerocoinMultiPowMod16, 500);
+BENCHMARK(ZerocoinMultiPowMod512, 20);
+static void ZerocoinSoKBatchVerify1(benchmark::State& state) { ZerocoinSoKBatchVerify(state, 1); }
+static void ZerocoinSoKBatchVerify4(benchmark::State& state) { ZerocoinSoKBatchVerify(state, 4); }
+static void ZerocoinSoKBatchVerify16(benchmark::State& state) { ZerocoinSoKBatchVerify(state, 16); }
+static void ZerocoinThreadedBatchVerify1(benchmark::State& state) { ZerocoinThreadedBatchVerify(state, 1); }
+static void ZerocoinThreadedBatchVerify2(benchmark::State& state) { ZerocoinThreadedBatchVerify(state, 2); }
+static void ZerocoinThreadedBatchVerify4(benchmark::State& state) { ZerocoinThreadedBatchVerify(state, 4); }
+static void ZerocoinCreateCoinSpends1(benchmark::State& state) { ZerocoinCreateCoinSpends(state, 1); }
+static void ZerocoinCreateCoinSpends4(benchmark::State& state) { ZerocoinCreateCoinSpends(state, 4); }
+
+BENCHMARK(ZerocoinSoKProve, 2);
+BENCHMARK(ZerocoinSoKVerify, 2);
+BENCHMARK(ZerocoinSoKBatchVerify1, 2);
+BENCHMARK(ZerocoinSoKBatchVerify4, 1);
+BENCHMARK(ZerocoinSoKBatchVerify16, 1);
+BENCHMARK(ZerocoinThreadedBatchVerify1, 1);
+BENCHMARK(ZerocoinThreadedBatchVerify2, 1);
+BENCHMARK(ZerocoinThreadedBatchVerify4, 1);
+BENCHMARK(ZerocoinAccumulatorIncrement, 200);
+BENCHMARK(ZerocoinWitnessAddElement, 200);
+BENCHMARK(ZerocoinCoinSpend, 1);
+BENCHMARK(ZerocoinCreateCoinSpends1, 1);
+BENCHMARK(ZerocoinCreateCoinSpends4, 1);
+BENCHMARK(ZerocoinMintPrivateCoin, 5);
@@ -4,6 +4,7 @@
 
 #include <bloom.h>
 
+#include <memusage.h>
 #include <primitives/transaction.h>
 #include <hash.h>
 #include <script/script.h>
@@ -322,3 +323,57 @@ void CRollingBloomFilter::reset()
         *it = 0;
     }
 }
+
+CBlockedBloomFilter::CBlockedBloomFilter(size_t nElements)
+{
+    nTweak0 = GetRand(std::numeric_limits<uint64_t>::max());
+    nTweak1 = GetRand(std::numeric_limits<uint64_t>::max());
+    Reset(nElements);
+}
+
+void CBlockedBloomFilter::Reset(size_t nElements)
+{
+    nBlocks = std::max<size_t>(1, (nElements * BITS_PER_ELEMENT + BLOCK_BITS - 1) / BLOCK_BITS);
+    nCapacity = nBlocks * BLOCK_BITS / BITS_PER_ELEMENT;
+    nInserted = 0;
+    vData.assign(nBlocks * BLOCK_WORDS, 0);
+}
+
+// The high half of the salted hash picks the block, the low bits give the start and step of the double hashing inside it
+void CBlockedBloomFilter::GetPositions(const uint256& hash, size_t& nBlock, uint32_t& nBit0, uint32_t& nStep) const
+{
+    uint64_t nHash = SipHashUint256(nTweak0, nTweak1, hash);
+    nBlock = (size_t)(((nHash >> 32) * nBlocks) >> 32) * BLOCK_WORDS;
+    nBit0 = nHash & (BLOCK_BITS - 1);
+    nStep = ((nHash >> 9) & (BLOCK_BITS - 1)) | 1;
+}
+
+void CBlockedBloomFilter::insert(const uint256& hash)
+{
+    size_t nBlock;
+    uint32_t nBit0, nStep;
+    GetPositions(hash, nBlock, nBit0, nStep);
+    for (int i = 0; i < HASH_FUNCS; i++) {
+        uint32_t nBit = (nBit0 + i * nStep) & (BLOCK_BITS - 1);
+        vData[nBlock + (nBit >> 6)] |= (uint64_t)1 << (nBit & 63);
+    }
+    nInserted++;
+}
+
+bool CBlockedBloomFilter::contains(const uint256& hash) const
+{
+    size_t nBlock;
+    uint32_t nBit0, nStep;
+    GetPositions(hash, nBlock, nBit0, nStep);
+    for (int i = 0; i < HASH_FUNCS; i++) {
+        uint32_t nBit = (nBit0 + i * nStep) & (BLOCK_BITS - 1);
+        if (!((vData[nBlock + (nBit >> 6)] >> (nBit & 63)) & 1))
+            return false;
+    }
+    return true;
+}
+
+size_t CBlockedBloomFilter::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(vData);
+}
@@ -6,6 +6,7 @@
 #define BITCOIN_BLOOM_H
 
 #include <serialize.h>
+#include <uint256.h>
 
 #include <vector>
 
@@ -140,4 +141,45 @@ private:
     int nHashFuncs;
 };
 
+/**
+ * BlockedBloomFilter is a probabilistic set of 256-bit hashes that never forgets an element.
+ * Every element sets its bits inside a single 64 byte block, so a lookup touches one cache line.
+ *
+ * Elements can't be removed, a removed element only raises the false positive rate until the
+ * filter is rebuilt. The false positive rate also grows quickly once more than capacity()
+ * elements are inserted, so the owner should rebuild it with Reset() to a larger size.
+ *
+ * It needs 2 bytes per element, for a false positive rate of about 0.1%.
+ */
+class CBlockedBloomFilter
+{
+public:
+    // Like CRollingBloomFilter, don't create global objects before the randomizer is initialized
+    explicit CBlockedBloomFilter(size_t nElements = 0);
+
+    void insert(const uint256& hash);
+    bool contains(const uint256& hash) const;
+
+    //! Empties the filter and sizes it for nElements
+    void Reset(size_t nElements);
+    size_t size() const { return nInserted; }
+    size_t capacity() const { return nCapacity; }
+    size_t DynamicMemoryUsage() const;
+
+private:
+    static const int BITS_PER_ELEMENT = 16;
+    static const int BLOCK_BITS = 512;
+    static const int BLOCK_WORDS = BLOCK_BITS / 64;
+    static const int HASH_FUNCS = 8;
+
+    std::vector<uint64_t> vData;
+    size_t nBlocks;
+    size_t nCapacity;
+    size_t nInserted;
+    uint64_t nTweak0;
+    uint64_t nTweak1;
+
+    void GetPositions(const uint256& hash, size_t& nBlock, uint32_t& nBit0, uint32_t& nStep) const;
+};
+
 #endif // BITCOIN_BLOOM_H
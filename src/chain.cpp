@@ -8,6 +8,9 @@
 #include "hash.h"
 #include <libzerocoin/Denominations.h>
 
+#include <mutex>
+#include <set>
+
 /**
  * CChain implementation
  */
@@ -243,7 +246,9 @@ const CBlockIndex* LastCommonAncestor(const CBlockIndex* pa, const CBlockIndex*
 
 void CBlockIndex::AddAccumulator(libzerocoin::CoinDenomination denom, CBigNum bnAccumulator)
 {
+    std::map<libzerocoin::CoinDenomination, uint256> mapAccumulatorHashes = GetAccumulatorHashes();
     mapAccumulatorHashes[denom] = SerializeHash(bnAccumulator);
+    SetAccumulatorHashes(mapAccumulatorHashes);
 }
 
 void CBlockIndex::AddAccumulator(AccumulatorMap mapAccumulator)
@@ -253,3 +258,14 @@ void CBlockIndex::AddAccumulator(AccumulatorMap mapAccumulator)
         AddAccumulator(denom, bnAccumulator);
     }
 }
+
+const std::map<libzerocoin::CoinDenomination, uint256>* InternAccumulatorHashes(const std::map<libzerocoin::CoinDenomination, uint256>& mapAccumulatorHashes)
+{
+    // Local statics, so block indexes that are constructed during static initialization can use them.
+    // The entries are never erased, so the pointers stay valid for the lifetime of the process.
+    static std::mutex mutexAccumulatorHashes;
+    static std::set<std::map<libzerocoin::CoinDenomination, uint256>> setAccumulatorHashes;
+
+    std::lock_guard<std::mutex> lock(mutexAccumulatorHashes);
+    return &*setAccumulatorHashes.insert(mapAccumulatorHashes).first;
+}
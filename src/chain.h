@@ -170,6 +170,10 @@ enum BlockMemFlags: uint32_t {
     POS_BADWEIGHT = (1 << 0),
 };
 
+/** Returns the shared copy of the accumulator checkpoint hashes. A checkpoint only changes every 10 blocks, so the
+ * block indexes that have the same checkpoint point to the same copy instead of each holding a map. */
+const std::map<libzerocoin::CoinDenomination, uint256>* InternAccumulatorHashes(const std::map<libzerocoin::CoinDenomination, uint256>& mapAccumulatorHashes);
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -241,9 +245,13 @@ public:
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     int32_t nSequenceId;
 
-    //! zerocoin specific fields
-    std::map<libzerocoin::CoinDenomination, int64_t> mapZerocoinSupply;
-    std::vector<libzerocoin::CoinDenomination> vMintDenominationsInBlock;
+    //! zerocoin specific fields, in the order of zerocoinDenomList
+    int64_t nZerocoinSupply[libzerocoin::ZEROCOIN_DENOM_COUNT];
+    uint32_t nMintsInBlock[libzerocoin::ZEROCOIN_DENOM_COUNT];
+
+    //! (memory only) Number of mints of each denomination in the chain up to and including this block,
+    //! in the order of zerocoinDenomList
+    int64_t nChainMints[libzerocoin::ZEROCOIN_DENOM_COUNT];
 
     //! (memory only) Maximum nTime in the chain up to and including this block.
     unsigned int nTimeMax;
@@ -252,7 +260,7 @@ public:
     uint32_t nMemFlags;
 
     //! Hash value for the accumulator. Can be used to access the zerocoindb for the accumulator value
-    std::map<libzerocoin::CoinDenomination ,uint256> mapAccumulatorHashes;
+    const std::map<libzerocoin::CoinDenomination ,uint256>* pmapAccumulatorHashes;
 
     uint256 hashMerkleRoot;
     uint256 hashWitnessMerkleRoot;
@@ -288,21 +296,24 @@ public:
 
         nAnonOutputs = 0;
 
-        mapAccumulatorHashes.clear();
         hashMerkleRoot = uint256();
         hashWitnessMerkleRoot = uint256();
 
-        for (auto& denom : libzerocoin::zerocoinDenomList) {
-            mapAccumulatorHashes[denom] = uint256();
-        }
+        static const std::map<libzerocoin::CoinDenomination ,uint256>* pmapAccumulatorHashesNull = []() {
+            std::map<libzerocoin::CoinDenomination ,uint256> mapAccumulatorHashes;
+            for (auto& denom : libzerocoin::zerocoinDenomList)
+                mapAccumulatorHashes[denom] = uint256();
+            return InternAccumulatorHashes(mapAccumulatorHashes);
+        }();
+        pmapAccumulatorHashes = pmapAccumulatorHashesNull;
 
         // Start supply of each denomination with 0s
-        for (auto& denom : libzerocoin::zerocoinDenomList) {
-            mapZerocoinSupply.insert(std::make_pair(denom, 0));
+        for (int i = 0; i < libzerocoin::ZEROCOIN_DENOM_COUNT; i++) {
+            nZerocoinSupply[i] = 0;
+            nMintsInBlock[i] = 0;
+            nChainMints[i] = 0;
         }
 
-        vMintDenominationsInBlock.clear();
-
         nVersion       = 0;
         hashVeilData   = uint256();
         hashMerkleRoot = uint256();
@@ -389,14 +400,29 @@ public:
     /** Returns the hash of the accumulator for the specified denomination. If it doesn't exist then a new uint256 is returned*/
     uint256 GetAccumulatorHash(libzerocoin::CoinDenomination denom) const
     {
-        if(mapAccumulatorHashes.find(denom) != mapAccumulatorHashes.end()) {
-            return mapAccumulatorHashes.find(denom)->second;
+        auto it = pmapAccumulatorHashes->find(denom);
+        if (it != pmapAccumulatorHashes->end()) {
+            return it->second;
         }
         else {
             return uint256();
         }
     }
 
+    const std::map<libzerocoin::CoinDenomination ,uint256>& GetAccumulatorHashes() const
+    {
+        return *pmapAccumulatorHashes;
+    }
+
+    void SetAccumulatorHashes(const std::map<libzerocoin::CoinDenomination ,uint256>& mapAccumulatorHashes)
+    {
+        // Most blocks carry the checkpoint of the previous block
+        if (pprev && *pprev->pmapAccumulatorHashes == mapAccumulatorHashes)
+            pmapAccumulatorHashes = pprev->pmapAccumulatorHashes;
+        else
+            pmapAccumulatorHashes = InternAccumulatorHashes(mapAccumulatorHashes);
+    }
+
     static constexpr int nMedianTimeSpan = 11;
 
     int64_t GetMedianTimePast() const
@@ -431,17 +457,52 @@ public:
     int64_t GetZerocoinSupply() const
     {
         int64_t nTotal = 0;
-        for (auto& denom : libzerocoin::zerocoinDenomList) {
-            nTotal += libzerocoin::ZerocoinDenominationToAmount(denom) * mapZerocoinSupply.at(denom);
+        for (int i = 0; i < libzerocoin::ZEROCOIN_DENOM_COUNT; i++) {
+            nTotal += libzerocoin::ZerocoinDenominationToAmount(libzerocoin::zerocoinDenomList[i]) * nZerocoinSupply[i];
         }
 
         return nTotal;
     }
 
+    int64_t GetZerocoinSupply(libzerocoin::CoinDenomination denom) const
+    {
+        int nIndex = libzerocoin::ZerocoinDenominationToIndex(denom);
+        return nIndex >= 0 ? nZerocoinSupply[nIndex] : 0;
+    }
+
+    /** Returns how many mints of the denomination are in this block */
+    int GetBlockMints(libzerocoin::CoinDenomination denom) const
+    {
+        int nIndex = libzerocoin::ZerocoinDenominationToIndex(denom);
+        return nIndex >= 0 ? nMintsInBlock[nIndex] : 0;
+    }
+
     bool MintedDenomination(libzerocoin::CoinDenomination denom) const
     {
-        return std::find(vMintDenominationsInBlock.begin(), vMintDenominationsInBlock.end(), denom)
-                        != vMintDenominationsInBlock.end();
+        return GetBlockMints(denom) > 0;
+    }
+
+    bool HasMints() const
+    {
+        for (int i = 0; i < libzerocoin::ZEROCOIN_DENOM_COUNT; i++) {
+            if (nMintsInBlock[i])
+                return true;
+        }
+        return false;
+    }
+
+    /** Sets the mint counts of the chain from the ones of the previous block and the mints of this block */
+    void SetChainMints()
+    {
+        for (int i = 0; i < libzerocoin::ZEROCOIN_DENOM_COUNT; i++)
+            nChainMints[i] = (pprev ? pprev->nChainMints[i] : 0) + nMintsInBlock[i];
+    }
+
+    /** Returns how many mints of the denomination are in the chain up to and including this block */
+    int64_t GetChainMints(libzerocoin::CoinDenomination denom) const
+    {
+        int nIndex = libzerocoin::ZerocoinDenominationToIndex(denom);
+        return nIndex >= 0 ? nChainMints[nIndex] : 0;
     }
 
     std::string ToString() const
@@ -543,9 +604,34 @@ public:
         READWRITE(nTime);
         READWRITE(nBits);
         READWRITE(nNonce);
+
+        // The zerocoin fields are kept in arrays in memory, but stay in their original format on disk
+        std::map<libzerocoin::CoinDenomination, uint256> mapAccumulatorHashes;
+        std::map<libzerocoin::CoinDenomination, int64_t> mapZerocoinSupply;
+        std::vector<libzerocoin::CoinDenomination> vMintDenominationsInBlock;
+        if (!ser_action.ForRead()) {
+            mapAccumulatorHashes = GetAccumulatorHashes();
+            for (int i = 0; i < libzerocoin::ZEROCOIN_DENOM_COUNT; i++) {
+                mapZerocoinSupply[libzerocoin::zerocoinDenomList[i]] = nZerocoinSupply[i];
+                vMintDenominationsInBlock.insert(vMintDenominationsInBlock.end(), nMintsInBlock[i], libzerocoin::zerocoinDenomList[i]);
+            }
+        }
         READWRITE(mapAccumulatorHashes);
         READWRITE(mapZerocoinSupply);
         READWRITE(vMintDenominationsInBlock);
+        if (ser_action.ForRead()) {
+            pmapAccumulatorHashes = InternAccumulatorHashes(mapAccumulatorHashes);
+            for (const auto& supply : mapZerocoinSupply) {
+                int nIndex = libzerocoin::ZerocoinDenominationToIndex(supply.first);
+                if (nIndex >= 0)
+                    nZerocoinSupply[nIndex] = supply.second;
+            }
+            for (const auto& denom : vMintDenominationsInBlock) {
+                int nIndex = libzerocoin::ZerocoinDenominationToIndex(denom);
+                if (nIndex >= 0)
+                    nMintsInBlock[nIndex]++;
+            }
+        }
         READWRITE(fProofOfFullNode);
 
         //Proof of stake
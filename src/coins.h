@@ -127,6 +127,23 @@ public:
     }
 };
 
+class SaltedKeyImageHasher
+{
+private:
+    /** Salt */
+    const uint64_t k0, k1;
+
+public:
+    SaltedKeyImageHasher();
+
+    /** Key images are curve points that anyone can grind, so they are hashed with a salt like outpoints */
+    size_t operator()(const CCmpPubKey& ki) const {
+        uint256 x;
+        memcpy(x.begin(), ki.begin() + 1, 32);
+        return SipHashUint256Extra(k0, k1, x, ki[0]);
+    }
+};
+
 struct CCoinsCacheEntry
 {
     Coin coin; // The actual cached data.
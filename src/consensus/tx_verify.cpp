@@ -290,7 +290,36 @@ bool CheckStandardOutput(CValidationState &state, const Consensus::Params& conse
     return CheckValue(state, p->nValue, nValueOut);
 }
 
-bool CheckBlindOutput(CValidationState &state, const CTxOutCT *p)
+bool CRangeProofCheck::operator()()
+{
+    uint64_t min_value, max_value;
+    if (secp256k1_rangeproof_verify(secp256k1_ctx_blind, &min_value, &max_value, commitment, vRangeproof->data(),
+            vRangeproof->size(), nullptr, 0, secp256k1_generator_h) != 1)
+        return false;
+
+    if (fCacheStore)
+        SetRangeProofVerified(hashCacheEntry);
+    return true;
+}
+
+/** Verifies a range proof unless it is in the cache already, or appends it to pvChecks when given. Proofs verified here are cached. */
+static bool CheckRangeProof(const secp256k1_pedersen_commitment &commitment, const std::vector<uint8_t> &vRangeproof,
+        std::vector<CRangeProofCheck> *pvChecks)
+{
+    uint256 hashCacheEntry = GetRangeProofCacheEntry(commitment, vRangeproof);
+    if (IsRangeProofVerified(hashCacheEntry))
+        return true;
+
+    CRangeProofCheck check(&commitment, &vRangeproof, hashCacheEntry, /*fCacheStore*/!pvChecks);
+    if (pvChecks) {
+        pvChecks->emplace_back();
+        check.swap(pvChecks->back());
+        return true;
+    }
+    return check();
+}
+
+bool CheckBlindOutput(CValidationState &state, const CTxOutCT *p, std::vector<CRangeProofCheck> *pvRangeProofChecks)
 {
     if (p->vData.size() < 33 || p->vData.size() > 33 + 5)
         return state.DoS(100, false, REJECT_INVALID, "bad-ctout-ephem-size");
@@ -303,17 +332,13 @@ bool CheckBlindOutput(CValidationState &state, const CTxOutCT *p)
     if (/*todo: fBusyImporting && */ fSkipRangeproof)
         return true;
 
-    uint64_t min_value, max_value;
-    int rv = secp256k1_rangeproof_verify(secp256k1_ctx_blind, &min_value, &max_value, &p->commitment, p->vRangeproof.data(),
-            p->vRangeproof.size(), nullptr, 0, secp256k1_generator_h);
-
-    if (rv != 1)
+    if (!CheckRangeProof(p->commitment, p->vRangeproof, pvRangeProofChecks))
         return state.DoS(100, false, REJECT_INVALID, "bad-ctout-rangeproof-verify");
 
     return true;
 }
 
-bool CheckAnonOutput(CValidationState &state, const CTxOutRingCT *p)
+bool CheckAnonOutput(CValidationState &state, const CTxOutRingCT *p, std::vector<CRangeProofCheck> *pvRangeProofChecks)
 {
     if (p->vData.size() < 33 || p->vData.size() > 33 + 5)
         return state.DoS(100, false, REJECT_INVALID, "bad-rctout-ephem-size");
@@ -325,11 +350,7 @@ bool CheckAnonOutput(CValidationState &state, const CTxOutRingCT *p)
     if (/* todo: fBusyImporting && */ fSkipRangeproof)
         return true;
 
-    uint64_t min_value, max_value;
-    int rv = secp256k1_rangeproof_verify(secp256k1_ctx_blind, &min_value, &max_value, &p->commitment, p->vRangeproof.data(),
-            p->vRangeproof.size(), nullptr, 0, secp256k1_generator_h);
-
-    if (rv != 1)
+    if (!CheckRangeProof(p->commitment, p->vRangeproof, pvRangeProofChecks))
         return state.DoS(100, false, REJECT_INVALID, "bad-rctout-rangeproof-verify");
 
     return true;
@@ -347,7 +368,8 @@ bool CheckDataOutput(CValidationState &state, const CTxOutData *p)
     return true;
 }
 
-bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fSkipZerocoinMintIsPrime)
+bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fSkipZerocoinMintIsPrime,
+        std::vector<CRangeProofCheck>* pvRangeProofChecks)
 {
     // Basic checks that don't depend on any context
     if (tx.vin.empty())
@@ -388,12 +410,12 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fSki
                 break;
             }
             case OUTPUT_CT:
-                if (!CheckBlindOutput(state, (CTxOutCT*) txout.get()))
+                if (!CheckBlindOutput(state, (CTxOutCT*) txout.get(), pvRangeProofChecks))
                     return false;
                 nCTOut++;
                 break;
             case OUTPUT_RINGCT:
-                if (!CheckAnonOutput(state, (CTxOutRingCT*) txout.get()))
+                if (!CheckAnonOutput(state, (CTxOutRingCT*) txout.get(), pvRangeProofChecks))
                     return false;
                 nRingCTOut++;
                 break;
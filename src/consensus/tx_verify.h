@@ -6,6 +6,9 @@
 #define BITCOIN_CONSENSUS_TX_VERIFY_H
 
 #include <amount.h>
+#include <uint256.h>
+
+#include <secp256k1_rangeproof.h>
 
 #include <stdint.h>
 #include <vector>
@@ -19,8 +22,40 @@ class CValidationState;
 
 /** Transaction validation functions */
 
-/** Context-independent validity checks */
-bool CheckTransaction(const CTransaction& tx, CValidationState& state, bool fSkipZerocoinMintIsPrime=false);
+/**
+ * Closure representing the range proof verification of one CT or RingCT output.
+ * Note that this stores pointers into the output, so the transaction must outlive the check.
+ */
+class CRangeProofCheck
+{
+private:
+    const secp256k1_pedersen_commitment *commitment;
+    const std::vector<uint8_t> *vRangeproof;
+    uint256 hashCacheEntry;
+    bool fCacheStore;
+
+public:
+    CRangeProofCheck() : commitment(nullptr), vRangeproof(nullptr), fCacheStore(false) {}
+    CRangeProofCheck(const secp256k1_pedersen_commitment *commitmentIn, const std::vector<uint8_t> *vRangeproofIn,
+            const uint256 &hashCacheEntryIn, bool fCacheStoreIn) :
+        commitment(commitmentIn), vRangeproof(vRangeproofIn), hashCacheEntry(hashCacheEntryIn), fCacheStore(fCacheStoreIn) {}
+
+    bool operator()();
+
+    void swap(CRangeProofCheck &check) {
+        std::swap(commitment, check.commitment);
+        std::swap(vRangeproof, check.vRangeproof);
+        std::swap(hashCacheEntry, check.hashCacheEntry);
+        std::swap(fCacheStore, check.fCacheStore);
+    }
+};
+
+/**
+ * Context-independent validity checks.
+ * With pvRangeProofChecks the range proofs that are not cached yet are appended to it instead of being verified here.
+ */
+bool CheckTransaction(const CTransaction& tx, CValidationState& state, bool fSkipZerocoinMintIsPrime=false,
+        std::vector<CRangeProofCheck>* pvRangeProofChecks=nullptr);
 bool CheckZerocoinMint(const CTxOut& txout, CBigNum& bnValue, CValidationState& state, bool fSkipZerocoinMintIsPrime);
 bool CheckZerocoinSpend(const CTransaction& tx, CValidationState& state);
 
@@ -54,6 +54,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <veil/ringct/anon.h>
+#include <veil/zerocoin/accumulatormap.h>
 #include <veil/zerocoin/zchain.h>
 #include <veil/zerocoin/witness.h>
 #include <veil/zerocoin/precompute.h>
@@ -447,6 +448,7 @@ void SetupServerArgs()
     hidden_args.emplace_back("-sysperms");
 #endif
     gArgs.AddArg("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-zerocoinfixedbasemem=<n>", strprintf("Memory in MiB used for precomputed zerocoin generator tables, 0 to disable (default: %u)", libzerocoin::DEFAULT_FIXEDBASE_CACHE_BYTES >> 20), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-threadbatchverify", strprintf("How many threads to run when batch verifying zeroknowledge proofs (default: %u)", DEFAULT_BATCHVERIFY_THREADS), false, OptionsCategory::OPTIONS);
 
     gArgs.AddArg("-addnode=<ip>", "Add a node to connect to and attempt to keep the connection open (see the `addnode` RPC command help for more info). This option can be specified multiple times to add multiple nodes.", false, OptionsCategory::CONNECTION);
@@ -530,6 +532,9 @@ void SetupServerArgs()
     gArgs.AddArg("-logtimestamps", strprintf("Prepend debug output with timestamp (default: %u)", DEFAULT_LOGTIMESTAMPS), false, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-mocktime=<n>", "Replace actual time with <n> seconds since epoch (default: 0)", true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-maxzerocoinproofcachesize=<n>", strprintf("Limit the size of the cache of verified zerocoin spend proofs to <n> MiB (default: %u)", DEFAULT_MAX_ZEROCOIN_PROOF_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-maxanonoutputcachesize=<n>", strprintf("Keep up to <n> MiB of the most recent anon outputs in memory (default: %u)", DEFAULT_MAX_ANON_OUTPUT_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-maxrangeproofcachesize=<n>", strprintf("Limit the size of the cache of verified range proofs to <n> MiB (default: %u)", DEFAULT_MAX_RANGEPROOF_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-maxtxfee=<amt>", strprintf("Maximum total fees (in %s) to use in a single wallet transaction or raw transaction; setting this too low may abort large transactions (default: %s)",
@@ -1324,13 +1329,34 @@ bool AppInitMain()
 
     InitSignatureCache();
     InitScriptExecutionCache();
+    InitZerocoinProofCache();
+    InitRangeProofCache();
 
-    LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
+    LogPrintf("Using %u threads for script, ring signature and range proof verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
-        for (int i=0; i<nScriptCheckThreads-1; i++)
+        for (int i=0; i<nScriptCheckThreads-1; i++) {
             threadGroup.create_thread(&ThreadScriptCheck);
+            threadGroup.create_thread(&ThreadAnonCheck);
+            threadGroup.create_thread(&ThreadRangeProofCheck);
+        }
     }
 
+    // The accumulators of the denominations are calculated concurrently, the calling thread is one of the workers
+    int nAccumulateThreads = std::min<int>(nScriptCheckThreads, libzerocoin::zerocoinDenomList.size());
+    for (int i = 0; i < nAccumulateThreads - 1; i++)
+        threadGroup.create_thread(&ThreadAccumulate);
+
+    int64_t nFixedBaseMem = gArgs.GetArg("-zerocoinfixedbasemem", libzerocoin::DEFAULT_FIXEDBASE_CACHE_BYTES >> 20);
+    Params().Zerocoin_Params()->fixedBaseCache->SetMaxBytes(std::max(nFixedBaseMem, (int64_t)0) << 20);
+
+    // The thread calling ThreadedBatchVerify() joins the pool as the last worker
+    int nBatchVerifyThreads = gArgs.GetArg("-threadbatchverify", DEFAULT_BATCHVERIFY_THREADS);
+    if (nBatchVerifyThreads > MAX_SCRIPTCHECK_THREADS)
+        nBatchVerifyThreads = MAX_SCRIPTCHECK_THREADS;
+    LogPrintf("Using %u threads for zerocoin batch verification\n", std::max(nBatchVerifyThreads, 1));
+    for (int i = 0; i < nBatchVerifyThreads - 1; i++)
+        threadGroup.create_thread(&ThreadBatchVerify);
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
@@ -1571,6 +1597,8 @@ bool AppInitMain()
                 //zerocoinDB
                 pzerocoinDB.reset();
                 pzerocoinDB.reset(new CZerocoinDB(0, false, fReindex));
+                if (!pzerocoinDB->LoadFilters())
+                    LogPrintf("%s: failed to load the zerocoin spend and mint filters\n", __func__);
 
 #ifdef ENABLE_WALLET
                 if(!gArgs.GetBoolArg("-disablewallet", DEFAULT_DISABLE_WALLET)){
@@ -1698,6 +1726,12 @@ bool AppInitMain()
                         break;
                     }
                 }
+
+                int64_t nAnonOutputCache = std::max((int64_t)0, gArgs.GetArg("-maxanonoutputcachesize", DEFAULT_MAX_ANON_OUTPUT_CACHE_SIZE)) << 20;
+                if (!pblocktree->LoadRCTOutputCache(chainActive.Tip() ? chainActive.Tip()->nAnonOutputs : 0, nAnonOutputCache))
+                    LogPrintf("%s: failed to load the anon output cache\n", __func__);
+                if (!pblocktree->LoadRCTKeyImages())
+                    LogPrintf("%s: failed to load the key image index\n", __func__);
             } catch (const std::exception& e) {
                 LogPrintf("%s\n", e.what());
                 strLoadError = _("Error opening block database");
@@ -1925,8 +1959,11 @@ bool AppInitMain()
         g_wallet_init_interface.Start(scheduler);
 
         //Start staking thread last
-        if (!gArgs.GetBoolArg("-disablewallet", DEFAULT_DISABLE_WALLET) && gArgs.GetBoolArg("-staking", true) && !gArgs.GetBoolArg("-exchangesandservicesmode", false))
+        if (!gArgs.GetBoolArg("-disablewallet", DEFAULT_DISABLE_WALLET) && gArgs.GetBoolArg("-staking", true) && !gArgs.GetBoolArg("-exchangesandservicesmode", false)) {
             threadGroupStaking.create_thread(&ThreadStakeMiner);
+            if (gArgs.GetArg("-stakeprepare", DEFAULT_STAKE_PREPARE) > 0)
+                threadGroupStaking.create_thread(&ThreadPrepareStakeSpends);
+        }
 
         LinkPrecomputeThreadGroup(&threadGroupPrecompute);
 
@@ -1956,7 +1993,7 @@ bool AppInitMain()
 
         auto pt = GetMainWallet();
         if (pprecompute && pt) {
-            pprecompute->SetBlocksPerCycle(gArgs.GetArg("-precomputeblockpercycle", DEFAULT_PRECOMPUTE_BPC));
+            pprecompute->ReadArgs();
             if (gArgs.GetBoolArg("-precompute", false)) {
                 // Start precomputing zerocoin proofs
                 std::string strStatus;
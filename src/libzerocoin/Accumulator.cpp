@@ -43,7 +43,7 @@ Accumulator::Accumulator(const ZerocoinParams* p, const CoinDenomination d, cons
 
 void Accumulator::increment(const CBigNum& bnValue) {
     // Compute new accumulator = "old accumulator"^{element} mod N
-    this->value = this->value.pow_mod(bnValue, this->params->accumulatorModulus);
+    this->value = this->params->pow_mod(this->value, bnValue);
 }
 
 bool Accumulator::accumulate(const PublicCoin& coin) {
@@ -140,4 +140,31 @@ AccumulatorWitness& AccumulatorWitness::operator =(AccumulatorWitness rhs) {
     return *this;
 }
 
+static void AccumulateAllButOne(const AccumulatorAndProofParams* params, const CBigNum& base, const std::vector<CBigNum>& vValues,
+                                size_t nBegin, size_t nEnd, std::vector<CBigNum>& vResult) {
+    if (nEnd - nBegin == 1) {
+        vResult[nBegin] = base;
+        return;
+    }
+
+    // Each half is missing the values of the other half
+    size_t nMid = nBegin + (nEnd - nBegin) / 2;
+    CBigNum bnLeft = base;
+    for (size_t i = nMid; i < nEnd; i++)
+        bnLeft = params->pow_mod(bnLeft, vValues[i]);
+    CBigNum bnRight = base;
+    for (size_t i = nBegin; i < nMid; i++)
+        bnRight = params->pow_mod(bnRight, vValues[i]);
+
+    AccumulateAllButOne(params, bnLeft, vValues, nBegin, nMid, vResult);
+    AccumulateAllButOne(params, bnRight, vValues, nMid, nEnd, vResult);
+}
+
+std::vector<CBigNum> AccumulateAllButOne(const AccumulatorAndProofParams* params, const CBigNum& base, const std::vector<CBigNum>& vValues) {
+    std::vector<CBigNum> vResult(vValues.size());
+    if (!vValues.empty())
+        AccumulateAllButOne(params, base, vValues, 0, vValues.size(), vResult);
+    return vResult;
+}
+
 } /* namespace libzerocoin */
@@ -156,5 +156,15 @@ private:
     PublicCoin element; // was const but changed to use setting in assignment
 };
 
+/** Computes the witnesses of a whole set of values at once: the i-th result is base raised to every
+ * value except vValues[i]. The set is split in halves and each half is raised to the values of the
+ * other one before recursing, which takes O(n log n) exponentiations instead of O(n^2).
+ * @param params     the accumulator parameters
+ * @param base       the accumulator value without any of the values
+ * @param vValues    the values to compute witnesses for
+ * @return the witness values, in the order of vValues
+ */
+std::vector<CBigNum> AccumulateAllButOne(const AccumulatorAndProofParams* params, const CBigNum& base, const std::vector<CBigNum>& vValues);
+
 } /* namespace libzerocoin */
 #endif /* ACCUMULATOR_H_ */
@@ -37,9 +37,9 @@ AccumulatorProofOfKnowledge::AccumulatorProofOfKnowledge(const AccumulatorAndPro
 	CBigNum r_2 = CBigNum::randBignum(params->accumulatorModulus/4);
 	CBigNum r_3 = CBigNum::randBignum(params->accumulatorModulus/4);
 
-	this->C_e = g_n.pow_mod(e, params->accumulatorModulus) * h_n.pow_mod(r_1, params->accumulatorModulus);
-	this->C_u = witness.getValue() * h_n.pow_mod(r_2, params->accumulatorModulus);
-	this->C_r = g_n.pow_mod(r_2, params->accumulatorModulus) * h_n.pow_mod(r_3, params->accumulatorModulus);
+	this->C_e = params->pow_mod(g_n, e) * params->pow_mod(h_n, r_1);
+	this->C_u = witness.getValue() * params->pow_mod(h_n, r_2);
+	this->C_r = params->pow_mod(g_n, r_2) * params->pow_mod(h_n, r_3);
 
 	CBigNum r_alpha = CBigNum::randBignum(params->maxCoinValue * CBigNum(2).pow(params->k_prime + params->k_dprime));
 	if(!(CBigNum::randBignum(CBigNum(3)) % 2)) {
@@ -74,14 +74,14 @@ AccumulatorProofOfKnowledge::AccumulatorProofOfKnowledge(const AccumulatorAndPro
 		r_delta = 0-r_delta;
 	}
 
-	this->st_1 = (sg.pow_mod(r_alpha, params->accumulatorPoKCommitmentGroup.modulus) * sh.pow_mod(r_phi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-	this->st_2 = (((commitmentToCoin.getCommitmentValue() * sg.inverse(params->accumulatorPoKCommitmentGroup.modulus)).pow_mod(r_gamma, params->accumulatorPoKCommitmentGroup.modulus)) * sh.pow_mod(r_psi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-	this->st_3 = ((sg * commitmentToCoin.getCommitmentValue()).pow_mod(r_sigma, params->accumulatorPoKCommitmentGroup.modulus) * sh.pow_mod(r_xi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
+	this->st_1 = (params->accumulatorPoKCommitmentGroup.pow_mod(sg, r_alpha) * params->accumulatorPoKCommitmentGroup.pow_mod(sh, r_phi)) % params->accumulatorPoKCommitmentGroup.modulus;
+	this->st_2 = ((params->accumulatorPoKCommitmentGroup.pow_mod(commitmentToCoin.getCommitmentValue() * sg.inverse(params->accumulatorPoKCommitmentGroup.modulus), r_gamma)) * params->accumulatorPoKCommitmentGroup.pow_mod(sh, r_psi)) % params->accumulatorPoKCommitmentGroup.modulus;
+	this->st_3 = (params->accumulatorPoKCommitmentGroup.pow_mod(sg * commitmentToCoin.getCommitmentValue(), r_sigma) * params->accumulatorPoKCommitmentGroup.pow_mod(sh, r_xi)) % params->accumulatorPoKCommitmentGroup.modulus;
 
-	this->t_1 = (h_n.pow_mod(r_zeta, params->accumulatorModulus) * g_n.pow_mod(r_epsilon, params->accumulatorModulus)) % params->accumulatorModulus;
-	this->t_2 = (h_n.pow_mod(r_eta, params->accumulatorModulus) * g_n.pow_mod(r_alpha, params->accumulatorModulus)) % params->accumulatorModulus;
-	this->t_3 = (C_u.pow_mod(r_alpha, params->accumulatorModulus) * ((h_n.inverse(params->accumulatorModulus)).pow_mod(r_beta, params->accumulatorModulus))) % params->accumulatorModulus;
-	this->t_4 = (C_r.pow_mod(r_alpha, params->accumulatorModulus) * ((h_n.inverse(params->accumulatorModulus)).pow_mod(r_delta, params->accumulatorModulus)) * ((g_n.inverse(params->accumulatorModulus)).pow_mod(r_beta, params->accumulatorModulus))) % params->accumulatorModulus;
+	this->t_1 = (params->pow_mod(h_n, r_zeta) * params->pow_mod(g_n, r_epsilon)) % params->accumulatorModulus;
+	this->t_2 = (params->pow_mod(h_n, r_eta) * params->pow_mod(g_n, r_alpha)) % params->accumulatorModulus;
+	this->t_3 = (params->pow_mod(C_u, r_alpha) * (params->pow_mod(h_n.inverse(params->accumulatorModulus), r_beta))) % params->accumulatorModulus;
+	this->t_4 = (params->pow_mod(C_r, r_alpha) * (params->pow_mod(h_n.inverse(params->accumulatorModulus), r_delta)) * (params->pow_mod(g_n.inverse(params->accumulatorModulus), r_beta))) % params->accumulatorModulus;
 
 	CHashWriter hasher(0,0);
 	hasher << *params << sg << sh << g_n << h_n << commitmentToCoin.getCommitmentValue() << C_e << C_u << C_r << st_1 << st_2 << st_3 << t_1 << t_2 << t_3 << t_4;
@@ -111,20 +111,18 @@ bool AccumulatorProofOfKnowledge:: Verify(const Accumulator& a, const CBigNum& v
 	CBigNum g_n = params->accumulatorQRNCommitmentGroup.g;
 	CBigNum h_n = params->accumulatorQRNCommitmentGroup.h;
 
-	//According to the proof, this hash should be of length k_prime bits.  It is currently greater than that, which should not be a problem, but we should check this.
 	CHashWriter hasher(0,0);
-	hasher << *params << sg << sh << g_n << h_n << valueOfCommitmentToCoin << C_e << C_u << C_r << st_1 << st_2 << st_3 << t_1 << t_2 << t_3 << t_4;
-
-	CBigNum c = CBigNum(hasher.GetHash()); //this hash should be of length k_prime bits
+	hasher << *params << sg << sh << g_n << h_n;
+	CBigNum c = calculateChallenge(hasher, a, valueOfCommitmentToCoin);
 
-	CBigNum st_1_prime = (valueOfCommitmentToCoin.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * sg.pow_mod(s_alpha, params->accumulatorPoKCommitmentGroup.modulus) * sh.pow_mod(s_phi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-	CBigNum st_2_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * ((valueOfCommitmentToCoin * sg.inverse(params->accumulatorPoKCommitmentGroup.modulus)).pow_mod(s_gamma, params->accumulatorPoKCommitmentGroup.modulus)) * sh.pow_mod(s_psi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-	CBigNum st_3_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * (sg * valueOfCommitmentToCoin).pow_mod(s_sigma, params->accumulatorPoKCommitmentGroup.modulus) * sh.pow_mod(s_xi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
+	CBigNum st_1_prime = (params->accumulatorPoKCommitmentGroup.pow_mod_public(valueOfCommitmentToCoin, c) * params->accumulatorPoKCommitmentGroup.pow_mod_public(sg, s_alpha) * params->accumulatorPoKCommitmentGroup.pow_mod_public(sh, s_phi)) % params->accumulatorPoKCommitmentGroup.modulus;
+	CBigNum st_2_prime = (params->accumulatorPoKCommitmentGroup.pow_mod_public(sg, c) * (params->accumulatorPoKCommitmentGroup.pow_mod_public(valueOfCommitmentToCoin * sg.inverse(params->accumulatorPoKCommitmentGroup.modulus), s_gamma)) * params->accumulatorPoKCommitmentGroup.pow_mod_public(sh, s_psi)) % params->accumulatorPoKCommitmentGroup.modulus;
+	CBigNum st_3_prime = (params->accumulatorPoKCommitmentGroup.pow_mod_public(sg, c) * params->accumulatorPoKCommitmentGroup.pow_mod_public(sg * valueOfCommitmentToCoin, s_sigma) * params->accumulatorPoKCommitmentGroup.pow_mod_public(sh, s_xi)) % params->accumulatorPoKCommitmentGroup.modulus;
 
-	CBigNum t_1_prime = (C_r.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_zeta, params->accumulatorModulus) * g_n.pow_mod(s_epsilon, params->accumulatorModulus)) % params->accumulatorModulus;
-	CBigNum t_2_prime = (C_e.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_eta, params->accumulatorModulus) * g_n.pow_mod(s_alpha, params->accumulatorModulus)) % params->accumulatorModulus;
-	CBigNum t_3_prime = ((a.getValue()).pow_mod(c, params->accumulatorModulus) * C_u.pow_mod(s_alpha, params->accumulatorModulus) * ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) % params->accumulatorModulus;
-	CBigNum t_4_prime = (C_r.pow_mod(s_alpha, params->accumulatorModulus) * ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_delta, params->accumulatorModulus)) * ((g_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) % params->accumulatorModulus;
+	CBigNum t_1_prime = (params->pow_mod(C_r, c) * params->pow_mod(h_n, s_zeta) * params->pow_mod(g_n, s_epsilon)) % params->accumulatorModulus;
+	CBigNum t_2_prime = (params->pow_mod(C_e, c) * params->pow_mod(h_n, s_eta) * params->pow_mod(g_n, s_alpha)) % params->accumulatorModulus;
+	CBigNum t_3_prime = (params->pow_mod(a.getValue(), c) * params->pow_mod(C_u, s_alpha) * (params->pow_mod(h_n.inverse(params->accumulatorModulus), s_beta))) % params->accumulatorModulus;
+	CBigNum t_4_prime = (params->pow_mod(C_r, s_alpha) * (params->pow_mod(h_n.inverse(params->accumulatorModulus), s_delta)) * (params->pow_mod(g_n.inverse(params->accumulatorModulus), s_beta))) % params->accumulatorModulus;
 
 	bool result = false;
 
@@ -144,4 +142,118 @@ bool AccumulatorProofOfKnowledge:: Verify(const Accumulator& a, const CBigNum& v
 	return result;
 }
 
+CBigNum AccumulatorProofOfKnowledge::calculateChallenge(const CHashWriter& hasherParams, const Accumulator& a, const CBigNum& valueOfCommitmentToCoin) const {
+	// hasherParams already holds the parameters and the generators, which are the same for every proof
+	//According to the proof, this hash should be of length k_prime bits.  It is currently greater than that, which should not be a problem, but we should check this.
+	CHashWriter hasher(hasherParams);
+	hasher << valueOfCommitmentToCoin << C_e << C_u << C_r << st_1 << st_2 << st_3 << t_1 << t_2 << t_3 << t_4;
+
+	return CBigNum(hasher.GetHash()); //this hash should be of length k_prime bits
+}
+
+bool AccumulatorProofOfKnowledge::BatchVerify(const Accumulator& a, const std::vector<std::pair<const AccumulatorProofOfKnowledge*, const CBigNum*>>& vProofs) {
+	if (vProofs.empty())
+		return true;
+
+	// Whatever the combined check does not accept is left to Verify, so the batch gives the same answers
+	auto fVerifyEach = [&a, &vProofs]() {
+		for (const auto& entry : vProofs) {
+			if (!entry.first->Verify(a, *entry.second))
+				return false;
+		}
+		return true;
+	};
+
+	const AccumulatorAndProofParams* params = vProofs[0].first->params;
+	const IntegerGroupParams& pokGroup = params->accumulatorPoKCommitmentGroup;
+	const CBigNum& p = pokGroup.modulus;
+	const CBigNum& N = params->accumulatorModulus;
+	const CBigNum& sg = pokGroup.g;
+	const CBigNum& sh = pokGroup.h;
+	const CBigNum& g_n = params->accumulatorQRNCommitmentGroup.g;
+	const CBigNum& h_n = params->accumulatorQRNCommitmentGroup.h;
+	const CBigNum bnRange = params->maxCoinValue * CBigNum(2).pow(params->k_prime + params->k_dprime + 1);
+	const CBigNum bnZero(0);
+	auto fInGroup = [&bnZero](const CBigNum& x, const CBigNum& m) { return x > bnZero && x < m; };
+	const CBN_vector vOrder(1, pokGroup.groupOrder);
+	auto fInSubgroup = [&vOrder, &p](const CBigNum& x) { return CBigNum::multi_pow_mod(CBN_vector(1, x), vOrder, p).isOne(); };
+
+	CHashWriter hasherParams(0,0);
+	hasherParams << *params << sg << sh << g_n << h_n;
+
+	// Every equation lhs = prod(base^exp) mod p is moved to prod(base^exp) * lhs^-1 = 1, raised to a random
+	// weight and multiplied with the others. The exponents of the generators are summed.
+	CBigNum e_sg(0), e_sh(0);
+	CBN_vector vBasesP, vExpsP;
+	vBasesP.reserve(4 * vProofs.size() + 2);
+	vExpsP.reserve(4 * vProofs.size() + 2);
+	for (const auto& entry : vProofs) {
+		const AccumulatorProofOfKnowledge& proof = *entry.first;
+		const CBigNum& V = *entry.second;
+
+		if (proof.params != params) {
+			if (!proof.Verify(a, V))
+				return false;
+			continue;
+		}
+
+		// Unreduced commitments never match the recomputed ones, and zero has no inverse to move it across
+		// the equation. No honest proof has any of these values.
+		if (!fInGroup(proof.st_1, p) || !fInGroup(proof.st_2, p) || !fInGroup(proof.st_3, p) ||
+				!fInGroup(proof.t_1, N) || !fInGroup(proof.t_2, N) || !fInGroup(proof.t_3, N) || !fInGroup(proof.t_4, N) ||
+				V % p == bnZero || proof.C_e % N == bnZero || proof.C_u % N == bnZero || proof.C_r % N == bnZero)
+			return fVerifyEach();
+
+		if (proof.s_alpha < -bnRange || proof.s_alpha > bnRange)
+			return fVerifyEach();
+
+		// The random weights cannot catch a factor of small order, which is easy to find mod p. With every
+		// base in the subgroup of prime order, the combined check holds only if each equation does.
+		if (!fInSubgroup(V) || !fInSubgroup(proof.st_1) || !fInSubgroup(proof.st_2) || !fInSubgroup(proof.st_3))
+			return fVerifyEach();
+
+		const CBigNum c = proof.calculateChallenge(hasherParams, a, V);
+
+		// Mod N the factor -1 cannot be ruled out, and a random combination misses two of them half of the
+		// time. Each equation is checked on its own, still sharing the squarings of its bases.
+		if (CBigNum::multi_pow_mod({proof.C_r, h_n, g_n}, {c, proof.s_zeta, proof.s_epsilon}, N) != proof.t_1 ||
+				CBigNum::multi_pow_mod({proof.C_e, h_n, g_n}, {c, proof.s_eta, proof.s_alpha}, N) != proof.t_2 ||
+				CBigNum::multi_pow_mod({a.getValue(), proof.C_u, h_n}, {c, proof.s_alpha, -proof.s_beta}, N) != proof.t_3 ||
+				CBigNum::multi_pow_mod({proof.C_r, h_n, g_n}, {proof.s_alpha, -proof.s_delta, -proof.s_beta}, N) != proof.t_4)
+			return fVerifyEach();
+
+		CBN_vector vWeights(3);
+		for (CBigNum& w : vWeights)
+			w = CBigNum::randKBitBignum(64);
+
+		// st_1 = V^c * sg^s_alpha * sh^s_phi
+		// st_2 = sg^c * (V * sg^-1)^s_gamma * sh^s_psi
+		// st_3 = sg^c * (sg * V)^s_sigma * sh^s_xi
+		e_sg += vWeights[0] * proof.s_alpha + vWeights[1] * (c - proof.s_gamma) + vWeights[2] * (c + proof.s_sigma);
+		e_sh += vWeights[0] * proof.s_phi + vWeights[1] * proof.s_psi + vWeights[2] * proof.s_xi;
+		vBasesP.push_back(V);
+		vExpsP.push_back(vWeights[0] * c + vWeights[1] * proof.s_gamma + vWeights[2] * proof.s_sigma);
+		vBasesP.push_back(proof.st_1);
+		vExpsP.push_back(-vWeights[0]);
+		vBasesP.push_back(proof.st_2);
+		vExpsP.push_back(-vWeights[1]);
+		vBasesP.push_back(proof.st_3);
+		vExpsP.push_back(-vWeights[2]);
+	}
+
+	if (vBasesP.empty())
+		return true;
+
+	// sg and sh have the order of the group, so their exponents can be reduced
+	vBasesP.push_back(sg);
+	vExpsP.push_back(e_sg % pokGroup.groupOrder);
+	vBasesP.push_back(sh);
+	vExpsP.push_back(e_sh % pokGroup.groupOrder);
+
+	if (!CBigNum::multi_pow_mod(vBasesP, vExpsP, p).isOne())
+		return fVerifyEach();
+
+	return true;
+}
+
 } /* namespace libzerocoin */
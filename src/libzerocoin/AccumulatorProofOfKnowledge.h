@@ -36,6 +36,16 @@ public:
 	/** Verifies that  a commitment c is accumulated in accumulated a
 	 */
 	bool Verify(const Accumulator& a,const CBigNum& valueOfCommitmentToCoin) const;
+
+	/** Verifies a batch of proofs made against the same accumulator a, with the answers of Verify.
+	 * The equations mod p of all proofs are combined with random 64 bit weights into one multi-exponentiation.
+	 * V and st_1..st_3 must be in the subgroup of prime order, so a proof that misses passes it with probability
+	 * about 2^-64. The equations mod N are checked one by one with a multi-exponentiation each, since -1 has
+	 * small order there. When any of these checks fails, every proof of the batch is checked with Verify.
+	 * @param a the accumulator
+	 * @param vProofs the proofs, each with the value of the commitment to its coin
+	 */
+	static bool BatchVerify(const Accumulator& a, const std::vector<std::pair<const AccumulatorProofOfKnowledge*, const CBigNum*>>& vProofs);
 	
 	ADD_SERIALIZE_METHODS;
   template <typename Stream, typename Operation>  inline void SerializationOp(Stream& s, Operation ser_action) {
@@ -62,6 +72,8 @@ public:
 	    READWRITE(s_psi);
   }	
 private:
+	CBigNum calculateChallenge(const CHashWriter& hasherParams, const Accumulator& a, const CBigNum& valueOfCommitmentToCoin) const;
+
 	const AccumulatorAndProofParams* params;
 
 	/* Return values for proof */
@@ -287,10 +287,10 @@ void ArithmeticCircuit::set_YDash()
 }
 
 
-void ArithmeticCircuit::set_Kconst(CBN_vector& YPowers, const CBigNum serial)
+void ArithmeticCircuit::set_Kconst(const CBN_vector& YPowers, const CBigNum& serial)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum a = params->coinCommitmentGroup.g;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& a = params->coinCommitmentGroup.g;
 
     K[4*ZKP_SERIALSIZE-2] = a.pow_mod(serial, q);
 
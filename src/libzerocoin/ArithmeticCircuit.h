@@ -42,7 +42,7 @@ public:
     CBigNum sumWiresDotWs(const int i);    // Evaluate the sums in Equation (1) of the paper
     CBigNum AiDotBiYDash(const int i);     // Evaluate dotProduct(A[i], hadamard(B[i], YDash)
     bool check();                          // perform tests on circuit assignment
-    void set_Kconst(CBN_vector& YPowers, const CBigNum serial);
+    void set_Kconst(const CBN_vector& YPowers, const CBigNum& serial);
 private:
     const ZerocoinParams* params;
     CBigNum serialNumber;       // coin serial number S
@@ -15,9 +15,9 @@
 
 using namespace libzerocoin;
 
-void Bulletproofs::Prove(const CBN_matrix ck_inner_g,
-        const CBigNum P_inner_prod, const CBigNum z,
-        const CBN_matrix a_sets, const CBN_matrix b_sets, const CBigNum y)
+void Bulletproofs::Prove(const CBN_matrix& ck_inner_g,
+        const CBigNum& P_inner_prod, const CBigNum& z,
+        const CBN_matrix& a_sets, const CBN_matrix& b_sets, const CBigNum& y)
 {
     // ----------------------------- **** INNER-PRODUCT PROVE **** ------------------------------
     // ------------------------------------------------------------------------------------------
@@ -28,9 +28,8 @@ void Bulletproofs::Prove(const CBN_matrix ck_inner_g,
     // @init    final_a, final_b        :  final witness
     // @init    pi                      :  final shifted commitments
 
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
-    const CBigNum u_inner_prod = params->serialNumberSoKCommitmentGroup.u_inner_prod;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& u_inner_prod = params->serialNumberSoKCommitmentGroup.u_inner_prod;
 
     int s = 2;
 
@@ -39,7 +38,7 @@ void Bulletproofs::Prove(const CBN_matrix ck_inner_g,
     hasher << u_inner_prod.ToString() << P_inner_prod.ToString() << z.ToString();
     CBigNum pre = CBigNum(hasher.GetHash()) % q;
 
-    CBigNum u_inner = u_inner_prod.pow_mod(pre,p);
+    CBigNum u_inner = params->serialNumberSoKCommitmentGroup.pow_mod_public(u_inner_prod, pre);
 
     // Starting the actual protocol
     CBN_matrix a_sets2 = splitIntoSets(a_sets, s);
@@ -115,8 +114,8 @@ void Bulletproofs::Prove(const CBN_matrix ck_inner_g,
 
 
 bool Bulletproofs::Verify(const ZerocoinParams* ZCp,
-        const CBN_matrix ck_inner_g, const CBN_matrix ck_inner_h,
-        CBigNum A, CBigNum B, CBigNum z)
+        const CBN_matrix& ck_inner_g, const CBN_matrix& ck_inner_h,
+        const CBigNum& A, const CBigNum& B, const CBigNum& z)
 {
     // ---------------------------- **** INNER-PRODUCT VERIFY **** ------------------------------
     // ------------------------------------------------------------------------------------------
@@ -126,9 +125,9 @@ bool Bulletproofs::Verify(const ZerocoinParams* ZCp,
     // @param   z       :  target value
     // @return  bool    :  result of the verification
 
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
-    const CBigNum u_inner_prod = params->serialNumberSoKCommitmentGroup.u_inner_prod;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& u_inner_prod = params->serialNumberSoKCommitmentGroup.u_inner_prod;
 
     CBigNum P_inner_prod = A.mul_mod(B, p);
 
@@ -137,17 +136,18 @@ bool Bulletproofs::Verify(const ZerocoinParams* ZCp,
     hasher << u_inner_prod.ToString() << P_inner_prod.ToString() << z.ToString();
     CBigNum x1 = CBigNum(hasher.GetHash()) % q;
 
-    CBigNum u_inner = u_inner_prod.pow_mod(x1,p);
+    CBigNum u_inner = params->serialNumberSoKCommitmentGroup.pow_mod_public(u_inner_prod, x1);
     CBigNum P_inner = P_inner_prod.mul_mod(u_inner.pow_mod(z,p),p);
 
     // Starting the actual protocol
     int N1 = pi[0].size();
-    CBigNum x, Ak, Bk;
+    CBigNum x;
     CBN_vector xlist;
+    xlist.reserve(N1);
 
     for(int i=0; i<N1; i++) {
-        Ak = pi[0][i];
-        Bk = pi[1][i];
+        const CBigNum& Ak = pi[0][i];
+        const CBigNum& Bk = pi[1][i];
 
         hasher << Ak.ToString() << Bk.ToString();
         x = CBigNum(hasher.GetHash()) % q;
@@ -167,7 +167,7 @@ bool Bulletproofs::Verify(const ZerocoinParams* ZCp,
 
 
 // Split set of 1 set (ck_inner_g) into set of many sets (g_sets)
-CBN_matrix Bulletproofs::splitIntoSets(const CBN_matrix ck_inner_g, const int s)
+CBN_matrix Bulletproofs::splitIntoSets(const CBN_matrix& ck_inner_g, const int s)
 {
     const int N1 = ck_inner_g[0].size() / 2;
 
@@ -180,6 +180,8 @@ CBN_matrix Bulletproofs::splitIntoSets(const CBN_matrix ck_inner_g, const int s)
     else if (s==2) {
         // allocate g_sets
         CBN_matrix g_sets(2, CBN_vector());
+        g_sets[0].reserve(N1);
+        g_sets[1].reserve(N1);
 
         for(int i=0; i<N1; i++) {
             g_sets[0].push_back(ck_inner_g[0][i]);
@@ -192,9 +194,9 @@ CBN_matrix Bulletproofs::splitIntoSets(const CBN_matrix ck_inner_g, const int s)
 }
 
 // Function for reduction when mu > 1
-pair<CBigNum, CBigNum> Bulletproofs::findcLcR(const CBN_matrix a_sets, const CBN_matrix b_sets)
+pair<CBigNum, CBigNum> Bulletproofs::findcLcR(const CBN_matrix& a_sets, const CBN_matrix& b_sets)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
 
     CBigNum cL = dotProduct(a_sets[0], b_sets[1], q);
     CBigNum cR = dotProduct(a_sets[1], b_sets[0], q);
@@ -206,12 +208,12 @@ pair<CBigNum, CBigNum> Bulletproofs::findcLcR(const CBN_matrix a_sets, const CBN
 
 // reduction used in innerProductProve when mu > 1
 pair<CBigNum, CBigNum> Bulletproofs::firstPreChallengeShifts(
-        const CBN_matrix g_sets, const CBigNum u_inner,
-        const CBN_matrix a_sets, const CBN_matrix b_sets, CBigNum cL, CBigNum cR,
-        const CBN_vector ymPowers)
+        const CBN_matrix& g_sets, const CBigNum& u_inner,
+        const CBN_matrix& a_sets, const CBN_matrix& b_sets, const CBigNum& cL, const CBigNum& cR,
+        const CBN_vector& ymPowers)
 {
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
 
     CBigNum Ak = u_inner.pow_mod(cL, p);
     const int n1 = g_sets[0].size();
@@ -230,11 +232,10 @@ pair<CBigNum, CBigNum> Bulletproofs::firstPreChallengeShifts(
 }
 
 pair<CBigNum, CBigNum> Bulletproofs::preChallengeShifts(
-        const CBN_matrix g_sets, const CBN_matrix h_sets, const CBigNum u_inner,
-        const CBN_matrix a_sets, const CBN_matrix b_sets, CBigNum cL, CBigNum cR)
+        const CBN_matrix& g_sets, const CBN_matrix& h_sets, const CBigNum& u_inner,
+        const CBN_matrix& a_sets, const CBN_matrix& b_sets, const CBigNum& cL, const CBigNum& cR)
 {
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
 
     CBigNum Ak = u_inner.pow_mod(cL, p);
     const int n1 = g_sets[0].size();
@@ -255,13 +256,14 @@ pair<CBigNum, CBigNum> Bulletproofs::preChallengeShifts(
 
 
 // Find the new gs and hs in the inner product reduction
-CBN_matrix Bulletproofs::first_get_new_hs(const CBN_matrix g_sets,
-        const CBigNum x, const int m2, const CBN_vector ymPowers)
+CBN_matrix Bulletproofs::first_get_new_hs(const CBN_matrix& g_sets,
+        const CBigNum& x, const int m2, const CBN_vector& ymPowers)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
     const int N1 = g_sets[0].size();
     CBN_matrix new_gs(1, CBN_vector());
+    new_gs[0].reserve(N1);
     CBigNum new_g, x1, x2;  // temp
 
     const CBigNum xn = x.pow_mod(-1,q);
@@ -272,19 +274,20 @@ CBN_matrix Bulletproofs::first_get_new_hs(const CBN_matrix g_sets,
 
         new_g = (g_sets[0][j].pow_mod(x1,p)).mul_mod(g_sets[1][j].pow_mod(x2,p),p);
 
-        new_gs[0].push_back(new_g);
+        new_gs[0].push_back(std::move(new_g));
     }
 
     return splitIntoSets(new_gs, m2);
 }
 
-CBN_matrix Bulletproofs::get_new_gs_hs(const CBN_matrix g_sets, const int sign,
-        const CBigNum x, const int m2)
+CBN_matrix Bulletproofs::get_new_gs_hs(const CBN_matrix& g_sets, const int sign,
+        const CBigNum& x, const int m2)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
     const int N1 = g_sets[0].size();
     CBN_matrix new_gs(1, CBN_vector());
+    new_gs[0].reserve(N1);
     CBigNum new_g;
 
     const CBigNum xn = x.pow_mod(-1,q);
@@ -299,7 +302,7 @@ CBN_matrix Bulletproofs::get_new_gs_hs(const CBN_matrix g_sets, const int sign,
         else
             throw std::runtime_error("wrong sign inside get_new_gs_hs: " + sign);
 
-        new_gs[0].push_back(new_g);
+        new_gs[0].push_back(std::move(new_g));
     }
 
     return splitIntoSets(new_gs, m2);
@@ -307,10 +310,10 @@ CBN_matrix Bulletproofs::get_new_gs_hs(const CBN_matrix g_sets, const int sign,
 
 
 // Get new as and bs in inner product reduction
-CBN_matrix Bulletproofs::get_new_as_bs(const CBN_matrix a_sets, const int sign,
-        const CBigNum x, const int m2)
+CBN_matrix Bulletproofs::get_new_as_bs(const CBN_matrix& a_sets, const int sign,
+        const CBigNum& x, const int m2)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
     const int N1 = a_sets[0].size();
     CBN_matrix a2(1, CBN_vector(N1));
     CBigNum aj;
@@ -325,7 +328,7 @@ CBN_matrix Bulletproofs::get_new_as_bs(const CBN_matrix a_sets, const int sign,
         else
             throw std::runtime_error("wrong sign inside get_new_as_bs: " + sign);
 
-        a2[0][j] = aj;
+        a2[0][j] = std::move(aj);
     }
 
     return splitIntoSets(a2, m2);
@@ -334,11 +337,11 @@ CBN_matrix Bulletproofs::get_new_as_bs(const CBN_matrix a_sets, const int sign,
 
 
 // Verify Commitments
-bool Bulletproofs::testComsCorrect(const CBN_vector gh_sets,
-        const CBigNum u_inner, const CBigNum P_inner,
-        const CBN_matrix final_a, const CBN_matrix final_b, const CBigNum z)
+bool Bulletproofs::testComsCorrect(const CBN_vector& gh_sets,
+        const CBigNum& u_inner, const CBigNum& P_inner,
+        const CBN_matrix& final_a, const CBN_matrix& final_b, const CBigNum& z)
 {
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
     CBigNum Ptest = gh_sets[0].pow_mod(final_a[0][0],p);
     Ptest = Ptest.mul_mod(gh_sets[1].pow_mod(final_b[0][0],p),p);
     Ptest = Ptest.mul_mod(u_inner.pow_mod(z,p),p);
@@ -347,46 +350,41 @@ bool Bulletproofs::testComsCorrect(const CBN_vector gh_sets,
 
 
 // Optimizations
-CBN_vector Bulletproofs::getFinal_gh(const CBN_vector gs, const CBN_vector hs, CBN_vector xlist)
+CBN_vector Bulletproofs::getFinal_gh(const CBN_vector& gs, const CBN_vector& hs, const CBN_vector& xlist_in)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
 
-    const int logn = xlist.size();
+    const int logn = xlist_in.size();
     const int n = gs.size();
+    const CBN_vector xlist(xlist_in.rbegin(), xlist_in.rend());
     CBN_vector xnlist;
-    CBigNum sg_i, sh_i, xg, xh;
+    CBigNum sg_i, sh_i;
     CBN_vector sg_expo, sh_expo;
-    std::vector<int> bi;
-
-    std::reverse(xlist.begin(), xlist.end());
 
+    xnlist.reserve(logn);
     for(int i=0; i<logn; i++)
         xnlist.push_back(xlist[i].pow_mod(-1,q));
 
-    std::vector< std::vector<int>> binary_lookup = findBinaryLookup(logn);
+    const std::vector< std::vector<int>> binary_lookup = findBinaryLookup(logn);
 
+    sg_expo.reserve(n);
+    sh_expo.reserve(n);
     for(int i=0; i<n; i++) {
         sg_i = CBigNum(1);
         sh_i = CBigNum(1);
-        bi = binary_lookup[i];
+        const std::vector<int>& bi = binary_lookup[i];
 
         for(int j=0; j<logn; j++) {
-
-            if (bi[j] == 1) {
-                xg = xlist[j];
-                xh = xnlist[j];
-            } else {
-                xg = xnlist[j];
-                xh = xlist[j];
-            }
+            const CBigNum& xg = (bi[j] == 1) ? xlist[j] : xnlist[j];
+            const CBigNum& xh = (bi[j] == 1) ? xnlist[j] : xlist[j];
 
             sg_i = sg_i.mul_mod(xg,q);
             sh_i = sh_i.mul_mod(xh,q);
         }
 
-        sg_expo.push_back(sg_i);
-        sh_expo.push_back(sh_i);
+        sg_expo.push_back(std::move(sg_i));
+        sh_expo.push_back(std::move(sh_i));
     }
 
     CBN_vector ghfinal(2, CBigNum(1));
@@ -412,16 +410,17 @@ std::vector< std::vector<int>> Bulletproofs::findBinaryLookup(const int range)
     return binary_lookup;
 }
 
-std::vector< std::vector<int>> Bulletproofs::binaryBigger(const std::vector< std::vector<int>> bin_lookup)
+std::vector< std::vector<int>> Bulletproofs::binaryBigger(const std::vector< std::vector<int>>& bin_lookup)
 {
     std::vector< std::vector<int>> bigger;
     std::vector<int> lookup;
 
+    bigger.reserve(2 * bin_lookup.size());
     for(int i=0; i<2; i++)
         for(int j=0; j<(int)bin_lookup.size(); j++) {
             lookup = bin_lookup[j];
             lookup.push_back(i);
-            bigger.push_back(lookup);
+            bigger.push_back(std::move(lookup));
         }
 
     return bigger;
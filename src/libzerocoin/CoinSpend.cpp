@@ -18,8 +18,14 @@
 namespace libzerocoin
 {
     CoinSpend::CoinSpend(const ZerocoinParams* params, const PrivateCoin& coin, Accumulator& a, const uint256& checksum,
-                     const AccumulatorWitness& witness, const uint256& ptxHash, const SpendType& spendType, const uint8_t v) : accChecksum(checksum),
-                                                                                  ptxHash(ptxHash),
+                     const AccumulatorWitness& witness, const uint256& ptxHash, const SpendType& spendType, const uint8_t v) :
+                                                                                  CoinSpend(params, coin, a, checksum, witness, spendType, v)
+{
+    Sign(coin, ptxHash);
+}
+
+CoinSpend::CoinSpend(const ZerocoinParams* params, const PrivateCoin& coin, Accumulator& a, const uint256& checksum,
+                     const AccumulatorWitness& witness, const SpendType& spendType, const uint8_t v) : accChecksum(checksum),
                                                                                   coinSerialNumber(coin.getSerialNumber()),
                                                                                   accumulatorPoK(&params->accumulatorParams),
                                                                                   commitmentPoK(&params->serialNumberSoKCommitmentGroup,
@@ -56,18 +62,24 @@ namespace libzerocoin
     // 3. Proves that the committed public coin is in the Accumulator (PoK of "witness")
     this->accumulatorPoK = AccumulatorProofOfKnowledge(&params->accumulatorParams, fullCommitmentToCoinUnderAccParams, witness, a);
 
-    // 4. Proves that the coin is correct w.r.t. serial number and hidden coin secret
-    // (This proof is bound to the coin 'metadata', i.e., transaction hash)
+    // 4. Commits to the circuit of the proof that the coin is correct w.r.t. serial number and hidden coin secret.
+    // The proof is bound to the coin 'metadata', i.e., transaction hash, when it is completed in Sign()
+    this->smallSoK = SerialNumberSoK_small(params, coin, fullCommitmentToCoinUnderSerialParams);
+
+    if (version == V4_LIMP) {
+        pubcoinSig = PubcoinSignature(params, coin.getPublicCoin().getValue(), fullCommitmentToCoinUnderSerialParams);
+    }
+}
+
+void CoinSpend::Sign(const PrivateCoin& coin, const uint256& ptxHash)
+{
+    this->ptxHash = ptxHash;
     hashSig = signatureHash();
-    this->smallSoK = SerialNumberSoK_small(params, coin, fullCommitmentToCoinUnderSerialParams, hashSig);
+    this->smallSoK.Prove(hashSig);
 
     this->pubkey = coin.getPubKey();
     if (!coin.sign(hashSig, this->vchSig))
         throw std::runtime_error("Coinspend failed to sign signature hash");
-
-    if (version == V4_LIMP) {
-        pubcoinSig = PubcoinSignature(params, coin.getPublicCoin().getValue(), fullCommitmentToCoinUnderSerialParams);
-    }
 }
 
 bool CoinSpend::Verify(const Accumulator& a, std::string& strError, bool verifySoK, bool verifyPubcoin) const
@@ -132,6 +144,31 @@ std::string CoinSpend::ToString() const
     return ss.str();
 }
 
+bool CoinSpend::BatchVerify(const Accumulator& a, const std::vector<const CoinSpend*>& vSpends, std::string& strError)
+{
+    std::vector<std::pair<const AccumulatorProofOfKnowledge*, const CBigNum*>> vAccumulatorProofs;
+    vAccumulatorProofs.reserve(vSpends.size());
+    for (const CoinSpend* spend : vSpends) {
+        if (a.getDenomination() != spend->denomination) {
+            strError = "CoinsSpend::BatchVerify: failed, denominations do not match";
+            return false;
+        }
+        // The commitment proofs only carry their challenge, which leaves nothing to combine
+        if (!spend->commitmentPoK.Verify(spend->serialCommitmentToCoinValue, spend->accCommitmentToCoinValue)) {
+            strError = "CoinsSpend::BatchVerify: commitmentPoK failed";
+            return false;
+        }
+        vAccumulatorProofs.emplace_back(&spend->accumulatorPoK, &spend->accCommitmentToCoinValue);
+    }
+
+    if (!AccumulatorProofOfKnowledge::BatchVerify(a, vAccumulatorProofs)) {
+        strError = "CoinsSpend::BatchVerify: accumulatorPoK failed";
+        return false;
+    }
+
+    return true;
+}
+
 bool CoinSpend::HasValidSerial(ZerocoinParams* params) const
 {
     if (coinSerialNumber.bitSize() > 256)
@@ -80,6 +80,18 @@ public:
     CoinSpend(const ZerocoinParams* params, const PrivateCoin& coin, Accumulator& a, const uint256& checksum,
               const AccumulatorWitness& witness, const uint256& ptxHash, const SpendType& spendType, const uint8_t version = (uint8_t) V3_SMALL_SOK);
 
+    /** Generates the parts of the proof that do not depend on the transaction: the commitments to the coin, their
+     * proofs of knowledge, the commitments of the serial number SoK and the pubcoin signature.
+     * The spend is not valid until it is completed with Sign().
+     */
+    CoinSpend(const ZerocoinParams* params, const PrivateCoin& coin, Accumulator& a, const uint256& checksum,
+              const AccumulatorWitness& witness, const SpendType& spendType, const uint8_t version = (uint8_t) V3_SMALL_SOK);
+
+    /** Binds a spend created without a transaction hash to ptxHash, by completing the serial number SoK and signing it.
+     * The blinding values of the SoK can only be used once, so this throws if it is called twice.
+     */
+    void Sign(const PrivateCoin& coin, const uint256& ptxHash);
+
     bool operator<(const CoinSpend& rhs) const { return this->getCoinSerialNumber() < rhs.getCoinSerialNumber(); }
 
     /** Returns the serial number of the coin spend by this proof.
@@ -121,6 +133,13 @@ public:
     }
 
     bool Verify(const Accumulator& a, std::string& strError, bool verifySoK = true, bool verifyPubcoin = false) const;
+
+    /** Verifies the commitment and accumulator proofs of spends that all use the accumulator a,
+     * the same checks as Verify(a, strError, false, false) on each of them. The accumulator proofs
+     * are batch verified, the commitment proofs are verified one by one.
+     * The serial number SoKs are batched separately with SerialNumberSoKProof::BatchVerify().
+     */
+    static bool BatchVerify(const Accumulator& a, const std::vector<const CoinSpend*>& vSpends, std::string& strError);
     bool HasValidSerial(ZerocoinParams* params) const;
     bool HasValidSignature() const;
     std::string ToString() const;
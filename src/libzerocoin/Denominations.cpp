@@ -40,6 +40,22 @@ int64_t ZerocoinDenominationToInt(const CoinDenomination& denomination)
     return Value;
 }
 
+// return the position of the denomination in zerocoinDenomList, or -1 for ZQ_ERROR
+int ZerocoinDenominationToIndex(const CoinDenomination& denomination)
+{
+    int nIndex = -1;
+    switch (denomination) {
+    case CoinDenomination::ZQ_TEN: nIndex = 0; break;
+    case CoinDenomination::ZQ_ONE_HUNDRED: nIndex = 1; break;
+    case CoinDenomination::ZQ_ONE_THOUSAND: nIndex = 2; break;
+    case CoinDenomination::ZQ_TEN_THOUSAND: nIndex = 3; break;
+    default:
+        // Error Case
+        nIndex = -1; break;
+    }
+    return nIndex;
+}
+
 CoinDenomination AmountToZerocoinDenomination(CAmount amount)
 {
     // Check to make sure amount is an exact integer number of COINS
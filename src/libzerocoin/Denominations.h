@@ -21,12 +21,15 @@ enum  CoinDenomination {
 
 // Order is with the Smallest Denomination first and is important for a particular routine that this order is maintained
 const std::vector<CoinDenomination> zerocoinDenomList = {ZQ_TEN, ZQ_ONE_HUNDRED, ZQ_ONE_THOUSAND, ZQ_TEN_THOUSAND};
+// Number of denominations in zerocoinDenomList, used to size arrays that hold a value per denomination
+const int ZEROCOIN_DENOM_COUNT = 4;
 // These are the max number you'd need at any one Denomination before moving to the higher denomination. Last number is 1, since it's the max number of
 // possible spends at the moment (20,000)    /
 const std::vector<int> maxCoinsAtDenom   = {9, 9, 9, 2};
 
 int64_t ZerocoinDenominationToInt(const CoinDenomination& denomination);
 int64_t ZerocoinDenominationToAmount(const CoinDenomination& denomination);
+int ZerocoinDenominationToIndex(const CoinDenomination& denomination);
 CoinDenomination IntToZerocoinDenomination(int64_t amount);
 CoinDenomination AmountToZerocoinDenomination(int64_t amount);
 CoinDenomination AmountToClosestDenomination(int64_t nAmount, int64_t& nRemaining);
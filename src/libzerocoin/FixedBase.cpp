@@ -0,0 +1,141 @@
+/**
+* @file       FixedBase.cpp
+*
+* @brief      Precomputed fixed base exponentiation tables for the zerocoin group generators.
+*
+* @copyright  Copyright 2019 The Veil Developers
+* @license    This project is released under the MIT license.
+**/
+
+#include "FixedBase.h"
+
+namespace libzerocoin {
+
+static unsigned int FixedBaseWindows(unsigned int nMaxBits)
+{
+    return (nMaxBits + FIXEDBASE_WINDOW - 1) / FIXEDBASE_WINDOW;
+}
+
+FixedBaseTable::FixedBaseTable(const CBigNum& base, const CBigNum& modulus, unsigned int nMaxBits)
+    : m_modulus(modulus), m_nMaxBits(nMaxBits)
+{
+    const unsigned int nRowSize = (1U << FIXEDBASE_WINDOW) - 1;
+    const unsigned int nWindows = FixedBaseWindows(nMaxBits);
+    m_vTable.resize(nWindows * nRowSize);
+
+    // rowBase = base^(2^(w*i))
+    CBigNum rowBase = base % modulus;
+    for (unsigned int i = 0; i < nWindows; i++) {
+        CBigNum* pRow = &m_vTable[i * nRowSize];
+        pRow[0] = rowBase;
+        for (unsigned int j = 1; j < nRowSize; j++)
+            pRow[j] = pRow[j-1].mul_mod(rowBase, modulus);
+        rowBase = pRow[nRowSize-1].mul_mod(rowBase, modulus);
+    }
+}
+
+size_t FixedBaseTable::EstimateMemoryUsage(const CBigNum& modulus, unsigned int nMaxBits)
+{
+    // Limbs of each bignum plus the bignum object and its allocation overhead
+    const size_t nEntrySize = (modulus.bitSize() + 7) / 8 + sizeof(CBigNum) + 32;
+    return FixedBaseWindows(nMaxBits) * ((1U << FIXEDBASE_WINDOW) - 1) * nEntrySize;
+}
+
+CBigNum FixedBaseTable::pow_mod(const CBigNum& e) const
+{
+    if (e < CBigNum(0) || (unsigned int)e.bitSize() > m_nMaxBits)
+        throw std::runtime_error("FixedBaseTable::pow_mod : exponent out of range");
+
+    const unsigned int nRowSize = (1U << FIXEDBASE_WINDOW) - 1;
+    CBigNum ret = CBigNum(1);
+    bool fStarted = false;
+    for (unsigned int i = 0; i < FixedBaseWindows(e.bitSize()); i++) {
+        unsigned int nDigit = 0;
+        for (int j = FIXEDBASE_WINDOW - 1; j >= 0; j--)
+            nDigit = (nDigit << 1) | (e.isBitSet(i * FIXEDBASE_WINDOW + j) ? 1 : 0);
+        if (!nDigit)
+            continue;
+        const CBigNum& entry = m_vTable[i * nRowSize + nDigit - 1];
+        ret = fStarted ? ret.mul_mod(entry, m_modulus) : entry;
+        fStarted = true;
+    }
+
+    return ret % m_modulus;
+}
+
+FixedBaseCache::FixedBaseCache(size_t nMaxBytes) : m_nMaxBytes(nMaxBytes), m_nUsage(0)
+{
+}
+
+void FixedBaseCache::Register(const CBigNum& base, const CBigNum& modulus, const CBigNum& order)
+{
+    std::lock_guard<std::mutex> lock(m_cs);
+    Entry& entry = m_mapEntries[std::make_pair(modulus, base)];
+    entry.order = order;
+    entry.fBuilding = false;
+}
+
+bool FixedBaseCache::pow_mod(const CBigNum& base, const CBigNum& e, const CBigNum& modulus, CBigNum& result)
+{
+    std::shared_ptr<const FixedBaseTable> table;
+    CBigNum order;
+    bool fBuild = false;
+    unsigned int nMaxBits = 0;
+    size_t nTableUsage = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_cs);
+        auto it = m_mapEntries.find(std::make_pair(modulus, base));
+        if (it == m_mapEntries.end())
+            return false;
+
+        Entry& entry = it->second;
+        table = entry.table;
+        order = entry.order;
+        if (!table && !entry.fBuilding) {
+            nMaxBits = order.bitSize();
+            nTableUsage = FixedBaseTable::EstimateMemoryUsage(modulus, nMaxBits);
+            if (m_nUsage + nTableUsage <= m_nMaxBytes) {
+                // Reserve the memory now, other threads use pow_mod until the table is ready
+                entry.fBuilding = true;
+                m_nUsage += nTableUsage;
+                fBuild = true;
+            }
+        }
+    }
+
+    if (fBuild) {
+        table = std::make_shared<const FixedBaseTable>(base, modulus, nMaxBits);
+        std::lock_guard<std::mutex> lock(m_cs);
+        Entry& entry = m_mapEntries[std::make_pair(modulus, base)];
+        entry.table = table;
+        entry.fBuilding = false;
+    }
+
+    if (!table)
+        return false;
+
+    // The generator has order 'order', so reducing the exponent keeps the result and makes negative
+    // exponents positive
+    result = table->pow_mod(e % order);
+    return true;
+}
+
+void FixedBaseCache::SetMaxBytes(size_t nMaxBytes)
+{
+    std::lock_guard<std::mutex> lock(m_cs);
+    m_nMaxBytes = nMaxBytes;
+}
+
+size_t FixedBaseCache::GetMaxBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_cs);
+    return m_nMaxBytes;
+}
+
+size_t FixedBaseCache::MemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_cs);
+    return m_nUsage;
+}
+
+} /* namespace libzerocoin */
@@ -0,0 +1,90 @@
+/**
+* @file       FixedBase.h
+*
+* @brief      Precomputed fixed base exponentiation tables for the zerocoin group generators.
+*
+* @copyright  Copyright 2019 The Veil Developers
+* @license    This project is released under the MIT license.
+**/
+
+#ifndef VEIL_FIXEDBASE_H
+#define VEIL_FIXEDBASE_H
+
+#include "bignum.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace libzerocoin {
+
+/** Default memory budget for all fixed base tables of one set of zerocoin parameters */
+static const size_t DEFAULT_FIXEDBASE_CACHE_BYTES = 64 * 1024 * 1024;
+
+/** Window size (in bits) of the fixed base tables */
+static const unsigned int FIXEDBASE_WINDOW = 4;
+
+/**
+ * Windowed exponentiation table for one base: entry [i][j-1] holds base^(j * 2^(w*i)) mod m.
+ * base^e is then the product of one entry per window of e, without any squaring.
+ */
+class FixedBaseTable
+{
+private:
+    CBigNum m_modulus;
+    unsigned int m_nMaxBits;
+    std::vector<CBigNum> m_vTable;
+
+public:
+    FixedBaseTable(const CBigNum& base, const CBigNum& modulus, unsigned int nMaxBits);
+
+    /** Estimated memory usage of a table, used to check the budget before building it */
+    static size_t EstimateMemoryUsage(const CBigNum& modulus, unsigned int nMaxBits);
+
+    /** base^e mod m, e must be non negative and at most nMaxBits long. Not constant time, e must be public */
+    CBigNum pow_mod(const CBigNum& e) const;
+};
+
+/**
+ * Fixed base tables for the generators of the zerocoin groups.
+ * Generators are registered with the order of their group. The table of a generator is built the first time
+ * it is raised to a power, as long as the memory budget allows it, and the caller falls back to CBigNum::pow_mod otherwise.
+ * Table lookups depend on the exponent, so the cache is only used for public exponents (see
+ * IntegerGroupParams::pow_mod_public); secret exponents stay on the constant time path of the bignum backend.
+ */
+class FixedBaseCache
+{
+private:
+    struct Entry
+    {
+        CBigNum order;
+        std::shared_ptr<const FixedBaseTable> table;
+        bool fBuilding;
+    };
+
+    mutable std::mutex m_cs;
+    std::map<std::pair<CBigNum, CBigNum>, Entry> m_mapEntries;
+    size_t m_nMaxBytes;
+    size_t m_nUsage;
+
+public:
+    explicit FixedBaseCache(size_t nMaxBytes = DEFAULT_FIXEDBASE_CACHE_BYTES);
+
+    /** Register a generator of order 'order' in the group mod 'modulus' */
+    void Register(const CBigNum& base, const CBigNum& modulus, const CBigNum& order);
+
+    /**
+     * Set result to base^e mod modulus through the table of base.
+     * @return false if base is not a registered generator or its table does not fit in the budget
+     */
+    bool pow_mod(const CBigNum& base, const CBigNum& e, const CBigNum& modulus, CBigNum& result);
+
+    /** Change the memory budget, tables already built are kept */
+    void SetMaxBytes(size_t nMaxBytes);
+    size_t GetMaxBytes() const;
+    size_t MemoryUsage() const;
+};
+
+} /* namespace libzerocoin */
+
+#endif //VEIL_FIXEDBASE_H
@@ -31,6 +31,19 @@ ZerocoinParams::ZerocoinParams(CBigNum N, uint32_t securityLevel) {
     ArithmeticCircuit::setPreConstraints(this, ZKP_wA, ZKP_wB, ZKP_wC, ZKP_K);
     ArithmeticCircuit::set_s_poly(this, S_POLY_A1, S_POLY_A2, S_POLY_B1, S_POLY_B2, S_POLY_C1, S_POLY_C2);
 
+    // Register the generators for fixed base exponentiation, in the order the tables are most useful
+    fixedBaseCache = std::make_shared<FixedBaseCache>();
+    for (IntegerGroupParams* group : {&coinCommitmentGroup, &accumulatorParams.accumulatorPoKCommitmentGroup,
+            &serialNumberSoKCommitmentGroup}) {
+        group->fixedBase = fixedBaseCache;
+        fixedBaseCache->Register(group->g, group->modulus, group->groupOrder);
+        fixedBaseCache->Register(group->h, group->modulus, group->groupOrder);
+    }
+    fixedBaseCache->Register(serialNumberSoKCommitmentGroup.u_inner_prod, serialNumberSoKCommitmentGroup.modulus,
+            serialNumberSoKCommitmentGroup.groupOrder);
+    for (const CBigNum& gi : serialNumberSoKCommitmentGroup.gis)
+        fixedBaseCache->Register(gi, serialNumberSoKCommitmentGroup.modulus, serialNumberSoKCommitmentGroup.groupOrder);
+
     this->accumulatorParams.initialized = true;
     this->initialized = true;
 }
@@ -49,7 +62,28 @@ CBigNum IntegerGroupParams::randomElement() const {
     // The generator of the group raised
     // to a random number less than the order of the group
     // provides us with a uniformly distributed random number.
-    return this->g.pow_mod(CBigNum::randBignum(this->groupOrder),this->modulus);
+    return pow_mod(this->g, CBigNum::randBignum(this->groupOrder));
+}
+
+CBigNum AccumulatorAndProofParams::pow_mod(const CBigNum& base, const CBigNum& e) const {
+    return base.pow_mod(e, this->accumulatorModulus);
+}
+
+CBigNum IntegerGroupParams::pow_mod(const CBigNum& base, const CBigNum& e) const {
+    return base.pow_mod(e, this->modulus);
+}
+
+CBigNum IntegerGroupParams::pow_mod_public(const CBigNum& base, const CBigNum& e) const {
+    if (fixedBase) {
+        CBigNum result;
+        if (fixedBase->pow_mod(base, e, this->modulus, result))
+            return result;
+    }
+    return pow_mod(base, e);
+}
+
+CBigNum IntegerGroupParams::mul_mod(const CBigNum& a, const CBigNum& b) const {
+    return a.mul_mod(b, this->modulus);
 }
 
 } /* namespace libzerocoin */
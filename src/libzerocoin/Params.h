@@ -16,6 +16,7 @@
 
 #include "bignum.h"
 #include "ZerocoinDefines.h"
+#include "FixedBase.h"
 
 namespace libzerocoin {
 
@@ -32,6 +33,31 @@ public:
 	 * @return a random element in the group.
 	 */
 	CBigNum randomElement() const;
+
+	/**
+	 * Raises a group element to a power mod the group modulus.
+	 * Constant time in the exponent, for the secrets and nonces of the provers.
+	 * @param base the element
+	 * @param e the exponent
+	 * @return base^e mod modulus
+	 */
+	CBigNum pow_mod(const CBigNum& base, const CBigNum& e) const;
+
+	/**
+	 * Raises a group element to a public power mod the group modulus.
+	 * The generators of the group use the fixed base tables of the zerocoin parameters,
+	 * which are not constant time, so e must not be secret.
+	 * @param base the element
+	 * @param e the exponent
+	 * @return base^e mod modulus
+	 */
+	CBigNum pow_mod_public(const CBigNum& base, const CBigNum& e) const;
+
+	/**
+	 * Multiplies two group elements mod the group modulus.
+	 * @return a * b mod modulus
+	 */
+	CBigNum mul_mod(const CBigNum& a, const CBigNum& b) const;
 	bool initialized;
 
 	/**
@@ -68,6 +94,11 @@ public:
 	 */
 	CBigNum groupOrder;
 
+	/**
+	 * Fixed base tables shared with the zerocoin parameters, not serialized
+	 */
+	std::shared_ptr<FixedBaseCache> fixedBase;
+
 	ADD_SERIALIZE_METHODS;
   template <typename Stream, typename Operation>  inline void SerializationOp(Stream& s, Operation ser_action) {
 		    READWRITE(initialized);
@@ -102,6 +133,14 @@ public:
 
 	//AccumulatorAndProofParams(CBigNum accumulatorModulus);
 
+	/**
+	 * Raises an element to a power mod the accumulator modulus.
+	 * @param base the element
+	 * @param e the exponent
+	 * @return base^e mod accumulatorModulus
+	 */
+	CBigNum pow_mod(const CBigNum& base, const CBigNum& e) const;
+
 	bool initialized;
 
 	/**
@@ -213,6 +252,13 @@ public:
 	 */
 	uint32_t zkp_iterations;
 
+	/**
+	 * Lazily built fixed base exponentiation tables for the generators of
+	 * coinCommitmentGroup, serialNumberSoKCommitmentGroup and the
+	 * accumulatorPoKCommitmentGroup. Shared between copies of the parameters.
+	 */
+	std::shared_ptr<FixedBaseCache> fixedBaseCache;
+
 	/**
 	 * The amount of the hash function we use for
 	 * proofs.
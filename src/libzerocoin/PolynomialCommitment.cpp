@@ -29,8 +29,8 @@ PolynomialCommitment::PolynomialCommitment(const ZerocoinParams* ZCp):
 {};
 
 // Constructor for SoK Verification
-PolynomialCommitment::PolynomialCommitment(const ZerocoinParams* ZCp, const CBN_vector Tf, const CBN_vector Trho, const CBigNum U,
-        const CBN_vector tbar, const CBigNum taubar, const CBN_vector xPowersPos, const CBN_vector xPowersNeg):
+PolynomialCommitment::PolynomialCommitment(const ZerocoinParams* ZCp, const CBN_vector& Tf, const CBN_vector& Trho, const CBigNum& U,
+        const CBN_vector& tbar, const CBigNum& taubar, const CBN_vector& xPowersPos, const CBN_vector& xPowersNeg):
             Tf(Tf),
             Trho(Trho),
             U(U),
@@ -42,10 +42,9 @@ PolynomialCommitment::PolynomialCommitment(const ZerocoinParams* ZCp, const CBN_
 {};
 
 
-void PolynomialCommitment::Commit(const CBN_vector tpolynomial)
+void PolynomialCommitment::Commit(const CBN_vector& tpolynomial)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
     const int n = ZKP_NDASH;
     const int m1 = ZKP_M1DASH;
     const int m2 = ZKP_M2DASH;
@@ -90,9 +89,9 @@ void PolynomialCommitment::Commit(const CBN_vector tpolynomial)
 }
 
 
-void PolynomialCommitment::Eval(const CBN_vector xPowersPositive, const CBN_vector xPowersNegative)
+void PolynomialCommitment::Eval(const CBN_vector& xPowersPositive, const CBN_vector& xPowersNegative)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
     const int n = ZKP_NDASH;
     const int m1 = ZKP_M1DASH;
     const int m2 = ZKP_M2DASH;
@@ -133,8 +132,8 @@ void PolynomialCommitment::Eval(const CBN_vector xPowersPositive, const CBN_vect
 
 bool PolynomialCommitment::Verify(CBigNum& value)
 {
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
     const int n = ZKP_NDASH;
     const int m1 = ZKP_M1DASH;
     const int m2 = ZKP_M2DASH;
@@ -146,24 +145,32 @@ bool PolynomialCommitment::Verify(CBigNum& value)
     // @return      bool  :  result of the verification
 
     // Commit to tbar with randomness taubar
-    CBigNum C = pedersenCommitment(params, tbar, taubar);
+    const IntegerGroupParams* SoKgroup = &(params->serialNumberSoKCommitmentGroup);
+    if( SoKgroup->gis.size() < tbar.size() )
+        throw std::runtime_error("len(gelements) < len(tbar) in PolynomialCommitment::Verify");
+    CBN_vector C_bases(SoKgroup->gis.begin(), SoKgroup->gis.begin() + tbar.size());
+    CBN_vector C_expos(tbar);
+    C_bases.push_back(SoKgroup->h);
+    C_expos.push_back(taubar);
+    CBigNum C = CBigNum::multi_pow_mod(C_bases, C_expos, p);
 
     // Find powers of commitments to Tf, Trho and U
-    CBigNum test = CBigNum(1);
-    CBigNum T;
+    CBN_vector bases, expos;
 
     for(int i=0; i<m1; i++) {
-        T = Tf[i].pow_mod(xPowersNeg[(m1-i)*n],p);
-        test = test.mul_mod(T,p);
+        bases.push_back(Tf[i]);
+        expos.push_back(xPowersNeg[(m1-i)*n]);
     }
 
     for(int i=0; i<m2; i++) {
-        T = Trho[i].pow_mod(xPowersPos[i*n+1],p);
-        test = test.mul_mod(T,p);
+        bases.push_back(Trho[i]);
+        expos.push_back(xPowersPos[i*n+1]);
     }
 
-    T = U.pow_mod(xPowersPos[2],p);
-    test = test.mul_mod(T,p);
+    bases.push_back(U);
+    expos.push_back(xPowersPos[2]);
+
+    CBigNum test = CBigNum::multi_pow_mod(bases, expos, p);
 
     // Perform the test
     if( C != test ) {
@@ -22,9 +22,9 @@ class PolynomialCommitment {
 public:
     PolynomialCommitment(){};
     PolynomialCommitment(const ZerocoinParams* ZCp);
-    PolynomialCommitment(const ZerocoinParams* ZCp, const CBN_vector Tf, const CBN_vector Trho, const CBigNum U, const CBN_vector tbar, const CBigNum taubar, const CBN_vector xPowersPos, const CBN_vector xPowersNeg);
-    void Commit(const CBN_vector tpolynomial);
-    void Eval(const CBN_vector xPowersPositive, const CBN_vector xPowersNegative);
+    PolynomialCommitment(const ZerocoinParams* ZCp, const CBN_vector& Tf, const CBN_vector& Trho, const CBigNum& U, const CBN_vector& tbar, const CBigNum& taubar, const CBN_vector& xPowersPos, const CBN_vector& xPowersNeg);
+    void Commit(const CBN_vector& tpolynomial);
+    void Eval(const CBN_vector& xPowersPositive, const CBN_vector& xPowersNegative);
     bool Verify(CBigNum& value);     // if Verify==true --> value = t(x)
     // commitments
     CBN_vector Tf;      // ZKP_M1DASH commitments to fVector
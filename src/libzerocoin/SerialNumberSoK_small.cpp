@@ -14,6 +14,8 @@
 #include "SerialNumberSoK_small.h"
 //#include <time.h>
 
+#include <atomic>
+
 namespace libzerocoin {
 
 SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp) :
@@ -26,14 +28,36 @@ SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp) :
 { }
 
 
+// The blinding vectors and the circuit assignment of a proof, kept between its commitments and the rest of the prover
+struct SerialNumberSoKBlinding
+{
+    SerialNumberSoKBlinding(const ZerocoinParams* ZCp) : f_alpha(ZKP_M), f_beta(ZKP_M), f_gamma(ZKP_M), D(ZKP_N), circuit(ZCp), fUsed(false) {}
+
+    CBN_vector f_alpha;
+    CBN_vector f_beta;
+    CBN_vector f_gamma;
+    CBN_vector D;
+    CBigNum f_delta;
+    ArithmeticCircuit circuit;
+    std::atomic<bool> fUsed;
+};
+
 SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const PrivateCoin& coin,
         const Commitment& commitmentToCoin, uint256 msghash) :
+                SerialNumberSoK_small(ZCp, coin, commitmentToCoin)
+{
+    Prove(msghash);
+}
+
+SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const PrivateCoin& coin,
+        const Commitment& commitmentToCoin) :
                 params(ZCp),
                 ComA(ZKP_M),
                 ComB(ZKP_M),
                 ComC(ZKP_M),
                 polyComm(ZCp),
-                innerProduct(ZCp)
+                innerProduct(ZCp),
+                pBlinding(std::make_shared<SerialNumberSoKBlinding>(ZCp))
 
 {
     // ---------------------------------- **** SoK PROVE **** -----------------------------------
@@ -42,32 +66,17 @@ SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const Pr
     // he knows v such that commitmentToCoin is a commitment to a^S b^v.
     // @param   coin                :  The PrivateCoin ww are committing to
     // @param   commitmentToCoin    :  commitment (y1)
-    // @param   msghash             :  a message hash to sign
     // @init    SoK
 
-    const CBigNum a = params->coinCommitmentGroup.g;
-    const CBigNum b = params->coinCommitmentGroup.h;
-    const CBigNum g = params->serialNumberSoKCommitmentGroup.g;
-    const CBigNum h = params->serialNumberSoKCommitmentGroup.h;
-    const CBigNum q = params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
     const CBigNum y1 = commitmentToCoin.getCommitmentValue();
-    const CBigNum S = coin.getSerialNumber();
-    const CBigNum v = coin.getRandomness();
     const int m = ZKP_M;
-    const int n = ZKP_N;
-    const int N = ZKP_SERIALSIZE;
-    const int m1dash = ZKP_M1DASH;
-    const int m2dash = ZKP_M2DASH;
-    const int ndash = ZKP_NDASH;
-    const int pads = ZKP_PADS;
 
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_a1(params->S_POLY_A1);
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_a2(params->S_POLY_A2);
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_b1(params->S_POLY_B1);
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_b2(params->S_POLY_B2);
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_c1(params->S_POLY_C1);
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_c2(params->S_POLY_C2);
+    CBN_vector& f_alpha = pBlinding->f_alpha;
+    CBN_vector& f_beta = pBlinding->f_beta;
+    CBN_vector& f_gamma = pBlinding->f_gamma;
+    CBN_vector& D = pBlinding->D;
+    ArithmeticCircuit& circuit = pBlinding->circuit;
 
 
     // ****************************************************************************
@@ -75,11 +84,8 @@ SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const Pr
     // ****************************************************************************
 
     // Select blinding vectors alpha, beta, gamma, D, delta
-    CBN_vector f_alpha(m);
-    CBN_vector f_beta(m);
-    CBN_vector f_gamma(m);
-    CBN_vector D(n);
-    CBigNum f_delta = CBigNum::randBignum(q);
+    CBigNum& f_delta = pBlinding->f_delta;
+    f_delta = CBigNum::randBignum(q);
 
     random_vector_mod(f_alpha, q);
     random_vector_mod(f_beta, q);
@@ -87,20 +93,19 @@ SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const Pr
     random_vector_mod(D, q);
 
     // set arithmetic circuit wire values and constraints
-    ArithmeticCircuit circuit(params);
     circuit.setWireValues(coin);
 
     // Commit to the assignment of the circuit: ComA[i] = pedersenCommitment(params, A[i], f_alpha[i]);
     transform(circuit.A.begin(), circuit.A.end(), f_alpha.begin(), ComA.begin(),
-            [=] (CBN_vector A, CBigNum alpha) {
+            [&] (const CBN_vector& A, const CBigNum& alpha) {
         return pedersenCommitment(params, A, alpha);} );
 
     transform(circuit.B.begin(), circuit.B.end(), f_beta.begin(), ComB.begin(),
-            [=] (CBN_vector B, CBigNum beta) {
+            [&] (const CBN_vector& B, const CBigNum& beta) {
         return pedersenCommitment(params, B, beta);} );
 
     transform(circuit.C.begin(), circuit.C.end(), f_gamma.begin(), ComC.begin(),
-            [=] (CBN_vector C, CBigNum gamma) {
+            [&] (const CBN_vector& C, const CBigNum& gamma) {
         return pedersenCommitment(params, C, gamma);} );
 
     ComD = pedersenCommitment(params, D, f_delta);
@@ -108,6 +113,38 @@ SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const Pr
     // replace commitment y1 and blind value r
     ComC[m-1] = y1;
     f_gamma[m-1] = commitmentToCoin.getRandomness();
+}
+
+void SerialNumberSoK_small::Prove(uint256 msghash)
+{
+    if (!pBlinding || pBlinding->fUsed.exchange(true))
+        throw std::runtime_error("SerialNumberSoK_small - error: the commitments of the proof were already used");
+
+    // Take the blinding values out of the proof, they are not needed once it is complete
+    std::shared_ptr<SerialNumberSoKBlinding> pBlindingUsed = std::move(pBlinding);
+    const CBN_vector& f_alpha = pBlindingUsed->f_alpha;
+    const CBN_vector& f_beta = pBlindingUsed->f_beta;
+    const CBN_vector& f_gamma = pBlindingUsed->f_gamma;
+    const CBN_vector& D = pBlindingUsed->D;
+    const CBigNum& f_delta = pBlindingUsed->f_delta;
+    ArithmeticCircuit& circuit = pBlindingUsed->circuit;
+
+    const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
+    const int m = ZKP_M;
+    const int n = ZKP_N;
+    const int N = ZKP_SERIALSIZE;
+    const int m1dash = ZKP_M1DASH;
+    const int m2dash = ZKP_M2DASH;
+    const int ndash = ZKP_NDASH;
+    const int pads = ZKP_PADS;
+
+    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_a1(params->S_POLY_A1);
+    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_a2(params->S_POLY_A2);
+    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_b1(params->S_POLY_B1);
+    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_b2(params->S_POLY_B2);
+    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_c1(params->S_POLY_C1);
+    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_c2(params->S_POLY_C2);
 
 
     // ****************************************************************************
@@ -167,13 +204,13 @@ SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const Pr
 
         for(unsigned int j=0; j<s_poly_b1[i].size(); j++) {
             duo0 = s_poly_b1[i][j].first;
-            duo1 = s_poly_b1[i][j].second;
+            const CBigNum& duo1 = s_poly_b1[i][j].second;
             coef1 = (coef1 + duo1.mul_mod(circuit.YPowers[duo0+1+4*N+m],q)) % q;
         }
 
         for(unsigned int j=0; j<s_poly_b2[i].size(); j++) {
             duo0 = s_poly_b2[i][j].first;
-            duo1 = s_poly_b2[i][j].second;
+            const CBigNum& duo1 = s_poly_b2[i][j].second;
             coef2 = (coef2 + duo1.mul_mod(circuit.YPowers[duo0+1+4*N+m],q)) % q;
         }
 
@@ -195,13 +232,13 @@ SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const Pr
 
         for(unsigned int j=0; j<s_poly_a1[i].size(); j++) {
             duo0 = s_poly_a1[i][j].first;
-            duo1 = s_poly_a1[i][j].second;
+            const CBigNum& duo1 = s_poly_a1[i][j].second;
             coef1 = (coef1 + duo1.mul_mod(circuit.YPowers[duo0+4*N+m],q)) % q;
         }
 
         for(unsigned int j=0; j<s_poly_a2[i].size(); j++) {
             duo0 = s_poly_a2[i][j].first;
-            duo1 = s_poly_a2[i][j].second;
+            const CBigNum& duo1 = s_poly_a2[i][j].second;
             coef2 = (coef2 + duo1.mul_mod(circuit.YPowers[duo0-1+4*N+m],q)) % q;
         }
 
@@ -221,13 +258,13 @@ SerialNumberSoK_small::SerialNumberSoK_small(const ZerocoinParams* ZCp, const Pr
 
         for(unsigned int j=0; j<s_poly_c1[i].size(); j++) {
             duo0 = s_poly_c1[i][j].first;
-            duo1 = s_poly_c1[i][j].second;
+            const CBigNum& duo1 = s_poly_c1[i][j].second;
             coef1 = (coef1 + duo1.mul_mod(circuit.YPowers[duo0+1+4*N+m],q)) % q;
         }
 
         for(unsigned int j=0; j<s_poly_c2[i].size(); j++) {
             duo0 = s_poly_c2[i][j].first;
-            duo1 = s_poly_c2[i][j].second;
+            const CBigNum& duo1 = s_poly_c2[i][j].second;
             coef2 = (coef2 + duo1.mul_mod(circuit.YPowers[duo0+1+4*N+m],q)) % q;
         }
 
@@ -420,8 +457,8 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
 }
 
 bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*> &proofs) {
-    const CBigNum q = proofs[0]->signature.params->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = proofs[0]->signature.params->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = proofs[0]->signature.params->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = proofs[0]->signature.params->serialNumberSoKCommitmentGroup.modulus;
     const int m =  ZKP_M;
     const int n =  ZKP_N;
     const int N = ZKP_SERIALSIZE;
@@ -441,6 +478,7 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
     CBigNum y1;
 
     std::vector<SerialNumberSoKProof2> proofs2;
+    proofs2.reserve(proofs.size());
 
     for(unsigned int w=0; w<proofs.size(); w++)
     {
@@ -559,6 +597,7 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
         // set ymPowers
         ny = y.pow_mod(-ZKP_M, q);
         CBN_vector ymPowers(1, bnOne);
+        ymPowers.reserve(n+pads+1);
         temp = bnOne;
 
         for(unsigned int i=0; i<n+pads; i++) {
@@ -568,6 +607,7 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
 
         // set yPowers
         CBN_vector yPowers(1, bnOne);
+        yPowers.reserve(8*N+m+2);
         temp = bnOne;
 
         for(unsigned int i=0; i<8*N+m+1; i++) {
@@ -577,12 +617,13 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
 
         // set yDash
         CBN_vector yDash;
+        yDash.reserve(n);
         for(unsigned int i=1; i<n+1; i++)
             yDash.push_back(yPowers[m*i]);
 
         // append the proof
-        SerialNumberSoKProof2 newProof(proofs[w]->signature, S, y1, xPowersPos, xPowersNeg, yPowers, yDash, ymPowers);
-        proofs2.push_back(newProof);
+        proofs2.emplace_back(proofs[w]->signature, S, y1, std::move(xPowersPos), std::move(xPowersNeg),
+                std::move(yPowers), std::move(yDash), std::move(ymPowers));
 
     }
 
@@ -593,19 +634,17 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
 
     const ZerocoinParams *params;
 
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_a1;
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_a2;
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_b1;
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_b2;
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_c1;
-    std::vector< std::vector< std::pair<int, CBigNum> > > s_poly_c2;
-
     int duo0;
-    CBigNum duo1;
-    CBN_vector xPowersPositive, xPowersNegative, yPowers;
+
+    // Only K and Kconst of the circuit depend on the proof, and set_Kconst resets both
+    ArithmeticCircuit circuit(proofs2[0].signature.params);
 
     CBN_vector test_vec(n, CBigNum(0));
-    CBigNum comTest = CBigNum(1);
+    CBN_vector temp_v;
+    CBigNum term;
+    CBN_vector comTest_bases, comTest_expos;
+    comTest_bases.reserve(proofs2.size());
+    comTest_expos.reserve(proofs2.size());
     CBigNum gamma;
 
     for(unsigned int w=0; w<proofs2.size(); w++)
@@ -628,7 +667,6 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
         polyComm = &proofs2[w].signature.polyComm;
 
         // set arithmetic circuit
-        ArithmeticCircuit circuit(proofs2[0].signature.params);
         circuit.set_Kconst(proofs2[w].yPowers, S);
 
         // restore PolynomialCommitment object from commitments
@@ -653,15 +691,20 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
         // ****************************************************************************
         // ***************************** STEP 4: Find ComR ****************************
         // ****************************************************************************
-        CBigNum ComR = pedersenCommitment(params, CBN_vector(1, bnZero), -rho);
-        ComR = ComR.mul_mod(ComD.pow_mod(proofs2[w].xPowersPos[2*m+1],p),p);
+        CBN_vector ComR_bases{params->serialNumberSoKCommitmentGroup.h, ComD};
+        CBN_vector ComR_expos{-rho, proofs2[w].xPowersPos[2*m+1]};
 
         for(int i=1; i<m+1; i++) {
-            ComR = ComR.mul_mod(ComA[i-1].pow_mod(proofs2[w].xPowersPos[i].mul_mod(proofs2[w].yPowers[i],q),p),p);
-            ComR = ComR.mul_mod(ComB[i-1].pow_mod(proofs2[w].xPowersNeg[i],p),p);
-            ComR = ComR.mul_mod(ComC_[i-1].pow_mod(proofs2[w].xPowersPos[m+i],p),p);
+            ComR_bases.push_back(ComA[i-1]);
+            ComR_expos.push_back(proofs2[w].xPowersPos[i].mul_mod(proofs2[w].yPowers[i],q));
+            ComR_bases.push_back(ComB[i-1]);
+            ComR_expos.push_back(proofs2[w].xPowersNeg[i]);
+            ComR_bases.push_back(ComC_[i-1]);
+            ComR_expos.push_back(proofs2[w].xPowersPos[m+i]);
         }
 
+        CBigNum ComR = CBigNum::multi_pow_mod(ComR_bases, ComR_expos, p);
+
         // append proof4
         proofs2[w].ComR = ComR;
 
@@ -670,40 +713,40 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
         // *************************** STEP 5: Find s_vec_2 ***************************
         // ****************************************************************************
 
-        s_poly_a1 = params->S_POLY_A1;
-        s_poly_a2 = params->S_POLY_A2;
-        s_poly_b1 = params->S_POLY_B1;
-        s_poly_b2 = params->S_POLY_B2;
-        s_poly_c1 = params->S_POLY_C1;
-        s_poly_c2 = params->S_POLY_C2;
-        xPowersPositive = proofs2[w].xPowersPos;
-        xPowersNegative = proofs2[w].xPowersNeg;
-        yPowers = proofs2[w].yPowers;
+        const auto& s_poly_a1 = params->S_POLY_A1;
+        const auto& s_poly_a2 = params->S_POLY_A2;
+        const auto& s_poly_b1 = params->S_POLY_B1;
+        const auto& s_poly_b2 = params->S_POLY_B2;
+        const auto& s_poly_c1 = params->S_POLY_C1;
+        const auto& s_poly_c2 = params->S_POLY_C2;
+        const CBN_vector& xPowersPositive = proofs2[w].xPowersPos;
+        const CBN_vector& xPowersNegative = proofs2[w].xPowersNeg;
+        const CBN_vector& yPowers = proofs2[w].yPowers;
 
         for(int i=0; i<(int)s_poly_b1.size(); i++) {
 
             for(int j=0; j<(int)s_poly_b1[i].size(); j++) {
                 duo0 = s_poly_b1[i][j].first;
-                duo1 = s_poly_b1[i][j].second;
-                proofs2[w].s_vec_2[i] = (proofs2[w].s_vec_2[i] + duo1.mul_mod(yPowers[duo0+1+4*N+m],q).mul_mod(xPowersPositive[1],q)) % q;
+                const CBigNum& duo1 = s_poly_b1[i][j].second;
+                addProduct_mod(proofs2[w].s_vec_2[i], term, duo1, yPowers[duo0+1+4*N+m], xPowersPositive[1], q);
             }
 
             for(int j=0; j<(int)s_poly_b2[i].size(); j++) {
                 duo0 = s_poly_b2[i][j].first;
-                duo1 = s_poly_b2[i][j].second;
-                proofs2[w].s_vec_2[i] = (proofs2[w].s_vec_2[i] + duo1.mul_mod(yPowers[duo0+1+4*N+m],q).mul_mod(xPowersPositive[2],q)) % q;
+                const CBigNum& duo1 = s_poly_b2[i][j].second;
+                addProduct_mod(proofs2[w].s_vec_2[i], term, duo1, yPowers[duo0+1+4*N+m], xPowersPositive[2], q);
             }
 
             for(int j=0; j<(int)s_poly_a1[i].size(); j++) {
                 duo0 = s_poly_a1[i][j].first;
-                duo1 = s_poly_a1[i][j].second;
-                proofs2[w].s_vec_2[i] = (proofs2[w].s_vec_2[i] + duo1.mul_mod(yPowers[duo0+4*N+m],q).mul_mod(xPowersNegative[1],q)) % q;
+                const CBigNum& duo1 = s_poly_a1[i][j].second;
+                addProduct_mod(proofs2[w].s_vec_2[i], term, duo1, yPowers[duo0+4*N+m], xPowersNegative[1], q);
             }
 
             for(int j=0; j<(int)s_poly_a2[i].size(); j++) {
                 duo0 = s_poly_a2[i][j].first;
-                duo1 = s_poly_a2[i][j].second;
-                proofs2[w].s_vec_2[i] = (proofs2[w].s_vec_2[i] + duo1.mul_mod(yPowers[duo0-1+4*N+m],q).mul_mod(xPowersNegative[2],q)) % q;
+                const CBigNum& duo1 = s_poly_a2[i][j].second;
+                addProduct_mod(proofs2[w].s_vec_2[i], term, duo1, yPowers[duo0-1+4*N+m], xPowersNegative[2], q);
             }
 
             proofs2[w].s_vec_2[i] = (proofs2[w].s_vec_2[i] - yPowers[2*(i+1)+1].mul_mod(xPowersNegative[3],q)) % q;
@@ -711,14 +754,14 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
 
             for(int j=0; j<(int)s_poly_c1[i].size(); j++) {
                 duo0 = s_poly_c1[i][j].first;
-                duo1 = s_poly_c1[i][j].second;
-                proofs2[w].s_vec_2[i] = (proofs2[w].s_vec_2[i] + duo1.mul_mod(yPowers[duo0+1+4*N+m],q).mul_mod(xPowersNegative[3],q)) % q;
+                const CBigNum& duo1 = s_poly_c1[i][j].second;
+                addProduct_mod(proofs2[w].s_vec_2[i], term, duo1, yPowers[duo0+1+4*N+m], xPowersNegative[3], q);
             }
 
             for(int j=0; j<(int)s_poly_c2[i].size(); j++) {
                 duo0 = s_poly_c2[i][j].first;
-                duo1 = s_poly_c2[i][j].second;
-                proofs2[w].s_vec_2[i] = (proofs2[w].s_vec_2[i] + duo1.mul_mod(yPowers[duo0+1+4*N+m],q).mul_mod(xPowersNegative[4],q)) % q;
+                const CBigNum& duo1 = s_poly_c2[i][j].second;
+                addProduct_mod(proofs2[w].s_vec_2[i], term, duo1, yPowers[duo0+1+4*N+m], xPowersNegative[4], q);
             }
 
             // append proof5
@@ -734,21 +777,27 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
         gamma = CBigNum::randBignum(q);
         ComR = proofs2[w].ComR;
 
-        CBN_vector temp_v;
+        temp_v.clear();
+        temp_v.reserve(proofs2[w].s_vec_2.size());
         for(int i=0; i<(int)proofs2[w].s_vec_2.size(); i++) {
             temp_v.push_back(gamma.mul_mod(proofs2[w].s_vec_2[i],q).mul_mod(proofs2[w].ymPowers[i+1],q));
         }
 
         addVectors_mod(test_vec, temp_v, test_vec, q);
 
-        comTest = comTest.mul_mod(
-                        ((ComR.pow_mod(-1,p)).mul_mod(comRdash,p)).pow_mod(gamma,p),p);
+        const IntegerGroupParams& sokGroup = params->serialNumberSoKCommitmentGroup;
+        comTest_bases.push_back(sokGroup.mul_mod(sokGroup.pow_mod_public(ComR, -1), comRdash));
+        comTest_expos.push_back(gamma);
 
 
     }
 
+    CBigNum comTest = CBigNum::multi_pow_mod(comTest_bases, comTest_expos, p);
 
-    CBigNum test = pedersenCommitment(proofs2[0].signature.params, test_vec, bnZero);
+    const CBN_vector& gis = proofs2[0].signature.params->serialNumberSoKCommitmentGroup.gis;
+    if (gis.size() < test_vec.size())
+        throw std::runtime_error("len(gelements) < len(test_vec) in BatchVerify");
+    CBigNum test = CBigNum::multi_pow_mod(CBN_vector(gis.begin(), gis.begin() + test_vec.size()), test_vec, p);
 
     if(test != comTest) {
         LogPrintf("BatchVerify failed: different test and comTest\n");
@@ -766,7 +815,7 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<const SerialNumberSoKProof*>
     return valid;
 }
 
-bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix ck_inner_g, std::vector<SerialNumberSoKProof2> &proofs)
+bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix& ck_inner_g, std::vector<SerialNumberSoKProof2> &proofs)
 {
     // Initialize
     const SerialNumberSoKProof2& dp_outter = proofs[0];
@@ -776,12 +825,14 @@ bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix ck_inner_g, std::v
     const CBigNum& q = params->serialNumberSoKCommitmentGroup.groupOrder;
     const CBigNum& p = params->serialNumberSoKCommitmentGroup.modulus;
     const CBigNum& u_inner_prod = params->serialNumberSoKCommitmentGroup.u_inner_prod;
+    const IntegerGroupParams& sokGroup = params->serialNumberSoKCommitmentGroup;
 
     CBigNum Ptest = CBigNum(1);
 
     std::vector<fBE> forBigExpo;
+    forBigExpo.reserve(proofs.size());
     CBigNum gamma, x1, u_inner, P_inner;
-    CBigNum x, Ak, Bk;
+    CBigNum x;
     CBN_vector xlist;
     CBigNum pt1, pt2;
     CBigNum z;
@@ -794,22 +845,25 @@ bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix ck_inner_g, std::v
 
         gamma = CBigNum::randBignum(q);
 
-        CBigNum P_inner_prod = A.mul_mod(B, p);
+        CBigNum P_inner_prod = sokGroup.mul_mod(A, B);
 
         // Inserting the z into u
         CHashWriter1024 hasher(0,0);
         hasher << u_inner_prod.ToString() << P_inner_prod.ToString() << z.ToString();
         x1 = CBigNum(hasher.GetHash()) % q;
 
-        u_inner = u_inner_prod.pow_mod(x1,p);
-        P_inner = P_inner_prod.mul_mod(u_inner.pow_mod(z,p),p);
+        u_inner = sokGroup.pow_mod_public(u_inner_prod, x1);
 
         // Starting the actual protocol
         xlist.clear();
+        CBN_vector P_bases{u_inner};
+        CBN_vector P_expos{z};
 
+        P_bases.reserve(2*N1+1);
+        P_expos.reserve(2*N1+1);
         for(int i=0; i<N1; i++) {
-            Ak = dp.signature.innerProduct.pi[0][i];
-            Bk = dp.signature.innerProduct.pi[1][i];
+            const CBigNum& Ak = dp.signature.innerProduct.pi[0][i];
+            const CBigNum& Bk = dp.signature.innerProduct.pi[1][i];
 
             hasher = CHashWriter1024(0,0);
             hasher << Ak.ToString() << Bk.ToString();
@@ -817,88 +871,92 @@ bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix ck_inner_g, std::v
 
             xlist.push_back(x);
 
-            P_inner = P_inner.mul_mod(
-                    (Ak.pow_mod(x.pow_mod(2,q),p)).mul_mod(Bk.pow_mod(x.pow_mod(-2,q),p),p),p);
+            P_bases.push_back(Ak);
+            P_expos.push_back(x.pow_mod(2,q));
+            P_bases.push_back(Bk);
+            P_expos.push_back(x.pow_mod(-2,q));
         }
 
+        P_inner = sokGroup.mul_mod(P_inner_prod, CBigNum::multi_pow_mod(P_bases, P_expos, p));
+
         z = dp.signature.innerProduct.final_a[0][0].mul_mod(dp.signature.innerProduct.final_b[0][0],q);
 
-        pt1 = P_inner.pow_mod(gamma,p);
-        pt2 = u_inner.pow_mod(z.mul_mod(-gamma,q),p);
+        pt1 = sokGroup.pow_mod_public(P_inner, gamma);
+        pt2 = sokGroup.pow_mod_public(u_inner, z.mul_mod(-gamma,q));
 
-        Ptest = Ptest.mul_mod( pt1.mul_mod(pt2,p) ,p);
+        Ptest = sokGroup.mul_mod(Ptest, sokGroup.mul_mod(pt1, pt2));
 
         fBE new_element;
-        new_element.gamma = gamma;
-        new_element.xlist = xlist;
-        new_element.ymPowers = dp.ymPowers;
+        new_element.gamma = std::move(gamma);
+        new_element.xlist = std::move(xlist);
+        new_element.ymPowers = &dp.ymPowers;
         new_element.a = dp.signature.innerProduct.final_a[0][0];
         new_element.b = dp.signature.innerProduct.final_b[0][0];
 
 
-        forBigExpo.push_back(new_element);
+        forBigExpo.push_back(std::move(new_element));
     }
 
     CBN_vector gh_final = getFinal_gh(params, ck_inner_g[0], forBigExpo);
 
-    return (gh_final[0].mul_mod(gh_final[1],p) == Ptest);
+    return (sokGroup.mul_mod(gh_final[0], gh_final[1]) == Ptest);
 }
 
 
-CBN_vector SerialNumberSoKProof::getFinal_gh(const ZerocoinParams* ZCp, CBN_vector gs, std::vector<fBE> forBigExpo)
+CBN_vector SerialNumberSoKProof::getFinal_gh(const ZerocoinParams* ZCp, const CBN_vector& gs, const std::vector<fBE>& forBigExpo)
 {
-    const CBigNum q = ZCp->serialNumberSoKCommitmentGroup.groupOrder;
-    const CBigNum p = ZCp->serialNumberSoKCommitmentGroup.modulus;
+    const CBigNum& q = ZCp->serialNumberSoKCommitmentGroup.groupOrder;
+    const CBigNum& p = ZCp->serialNumberSoKCommitmentGroup.modulus;
 
     int logn = forBigExpo[0].xlist.size();
     int n = gs.size();
     CBN_vector sg_expo(n, CBigNum(0));
     CBN_vector sh_expo(n, CBigNum(0));
-    CBN_vector xnlist;
+    CBN_vector xlist, xnlist;
+    xlist.reserve(logn);
+    xnlist.reserve(logn);
+
+    // every proof has the same number of rounds, so the lookup is shared
+    const std::vector< std::vector<int>> binary_lookup = Bulletproofs::findBinaryLookup(logn);
 
     for(int k=0; k<(int)forBigExpo.size(); k++) {
-        fBE comp = forBigExpo[k];
+        const fBE& comp = forBigExpo[k];
+        const CBN_vector& ymPowers = *comp.ymPowers;
 
-        std::reverse(comp.xlist.begin(),comp.xlist.end());
+        xlist.assign(comp.xlist.rbegin(), comp.xlist.rend());
 
         xnlist.clear();
         for(int i=0; i<logn; i++)
-            xnlist.push_back(comp.xlist[i].pow_mod(-1,q));
-
-        std::vector< std::vector<int>> binary_lookup = Bulletproofs::findBinaryLookup(logn);
+            xnlist.push_back(xlist[i].pow_mod(-1,q));
 
-        CBN_vector temp_g, temp_h;
+        const CBigNum gamma_a = (comp.gamma).mul_mod(comp.a,q);
+        const CBigNum gamma_b = (comp.gamma).mul_mod(comp.b,q);
         CBigNum sg_i, sh_i;
-        std::vector<int> bi;
         for(int i=0; i<n; i++) {
-            sg_i = (comp.gamma).mul_mod(comp.a,q);
-            sh_i = (comp.gamma).mul_mod((comp.b).mul_mod(comp.ymPowers[i+1],q),q);
-            bi = binary_lookup[i];
+            sg_i = gamma_a;
+            sh_i = gamma_b;
+            sh_i *= ymPowers[i+1];
+            sh_i %= q;
+            const std::vector<int>& bi = binary_lookup[i];
 
+            // in place products, the limbs of sg_i and sh_i are reused for the whole row
             for(int j=0; j<logn; j++) {
-                if (bi[j] == 1) {
-                    sg_i = sg_i.mul_mod(comp.xlist[j],q);
-                    sh_i = sh_i.mul_mod(xnlist[j],q);
-                } else {
-                    sg_i = sg_i.mul_mod(xnlist[j],q);
-                    sh_i = sh_i.mul_mod(comp.xlist[j],q);
-                }
+                sg_i *= (bi[j] == 1) ? xlist[j] : xnlist[j];
+                sg_i %= q;
+                sh_i *= (bi[j] == 1) ? xnlist[j] : xlist[j];
+                sh_i %= q;
             }
 
-            temp_g.push_back(sg_i);
-            temp_h.push_back(sh_i);
-
-            sg_expo[i] = (sg_expo[i] + sg_i) % q;
-            sh_expo[i] = (sh_expo[i] + sh_i) % q;
+            sg_expo[i] += sg_i;
+            sg_expo[i] %= q;
+            sh_expo[i] += sh_i;
+            sh_expo[i] %= q;
         }
     }
 
-    CBN_vector gh_final(2, CBigNum(1));
-
-    for(int i=0; i<n; i++) {
-        gh_final[0] = gh_final[0].mul_mod(gs[i].pow_mod(sg_expo[i],p),p);
-        gh_final[1] = gh_final[1].mul_mod(gs[i].pow_mod(sh_expo[i],p),p);
-    }
+    CBN_vector gh_final(2);
+    gh_final[0] = CBigNum::multi_pow_mod(gs, sg_expo, p);
+    gh_final[1] = CBigNum::multi_pow_mod(gs, sh_expo, p);
 
     return gh_final;
 }
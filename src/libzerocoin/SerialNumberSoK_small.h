@@ -13,6 +13,7 @@
 #ifndef SERIALNUMBERPROOFSMALL_H_
 #define SERIALNUMBERPROOFSMALL_H_
 #include <list>
+#include <memory>
 #include <vector>
 #include <bitset>
 #include "Params.h"
@@ -30,6 +31,8 @@ using namespace std;
 
 namespace libzerocoin {
 
+struct SerialNumberSoKBlinding;
+
 /**A Signature of knowledge on the hash of metadata attesting that the signer knows the values
  *  necessary to open a commitment which contains a coin(which it self is of course a commitment)
  * with a given serial number.
@@ -50,6 +53,22 @@ public:
      */
     SerialNumberSoK_small(const ZerocoinParams* ZCp, const PrivateCoin& coin, const Commitment& commitmentToCoin, uint256 msghash);
 
+    /** Commits to the circuit assignment of the coin, the part of the proof that does not depend on the message.
+     *  The proof is not valid until it is completed with Prove().
+     *
+     * @param p params
+     * @param coin the coin we are going to prove the serial number of.
+     * @param commitmentToCoin the commitment to the coin
+     */
+    SerialNumberSoK_small(const ZerocoinParams* ZCp, const PrivateCoin& coin, const Commitment& commitmentToCoin);
+
+    /** Completes a proof started without a message. The blinding values of the commitments would leak the coin
+     *  secrets if they were used for two messages, so this throws if it is called twice, also through a copy.
+     *
+     * @param msghash hash of meta data to create a signature of knowledge on.
+     */
+    void Prove(uint256 msghash);
+
     /** Verifies the Signature of knowledge.
      *
      * @param msghash hash of meta data to create a signature of knowledge on.
@@ -97,29 +116,33 @@ private:
     // Inner Product Proof
     Bulletproofs innerProduct;
 
+    // Blinding values between the two halves of the prover, shared by copies so that they are used only once
+    std::shared_ptr<SerialNumberSoKBlinding> pBlinding;
+
 };
 
 
 struct fBE {
-    fBE() {};
+    fBE() : ymPowers(nullptr) {};
     CBigNum gamma;
     CBN_vector xlist;
-    CBN_vector ymPowers;
+    const CBN_vector* ymPowers;     // points into the SerialNumberSoKProof2 being verified
     CBigNum a;
     CBigNum b;
 };
 
 struct SerialNumberSoKProof2 {
+    // The power vectors are taken by value so that the verifier can move them in
     SerialNumberSoKProof2(const SerialNumberSoK_small &sig, const CBigNum& coinSerial, const CBigNum& valueOfCommitment,
-            const CBN_vector& xPowersPositive, const CBN_vector& xPowersNegative, const CBN_vector& YPowers, const CBN_vector& YDash, const CBN_vector& YmPowers ):
+            CBN_vector xPowersPositive, CBN_vector xPowersNegative, CBN_vector YPowers, CBN_vector YDash, CBN_vector YmPowers ):
         signature(sig),
         coinSerialNumber(coinSerial),
         valueOfCommitmentToCoin(valueOfCommitment),
-        xPowersPos(xPowersPositive),
-        xPowersNeg(xPowersNegative),
-        yPowers(YPowers),
-        yDash(YDash),
-        ymPowers(YmPowers),
+        xPowersPos(std::move(xPowersPositive)),
+        xPowersNeg(std::move(xPowersNegative)),
+        yPowers(std::move(YPowers)),
+        yDash(std::move(YDash)),
+        ymPowers(std::move(YmPowers)),
         s_vec_2(ZKP_N, CBigNum(0))
 {}
     SerialNumberSoK_small signature;
@@ -161,8 +184,8 @@ public:
 
     static bool BatchVerify(std::vector<const SerialNumberSoKProof*> &proofs, uint8_t* nReturn);
     static bool BatchVerify(std::vector<const SerialNumberSoKProof*> &proofs);
-    static bool BatchBulletproofs(const CBN_matrix ck_inner_g, std::vector<SerialNumberSoKProof2> &proofs);
-    static CBN_vector getFinal_gh(const ZerocoinParams* ZCp, CBN_vector gs, std::vector<fBE> forBigExpo);
+    static bool BatchBulletproofs(const CBN_matrix& ck_inner_g, std::vector<SerialNumberSoKProof2> &proofs);
+    static CBN_vector getFinal_gh(const ZerocoinParams* ZCp, const CBN_vector& gs, const std::vector<fBE>& forBigExpo);
 };
 
 
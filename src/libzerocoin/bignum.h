@@ -10,6 +10,7 @@
 #include "veil-config.h"
 #endif
 
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 #if defined(USE_NUM_GMP)
@@ -32,6 +33,23 @@ public:
     explicit bignum_error(const std::string& str) : std::runtime_error(str) {}
 };
 
+/**
+ * Window size used by CBigNum::multi_pow_mod for exponents of nBits bits. Each base costs a table of
+ * 2^w entries plus one multiplication per window, so larger exponents amortize a larger table.
+ */
+inline int multi_pow_window(int nBits)
+{
+    if (nBits > 384)
+        return 5;
+    if (nBits > 128)
+        return 4;
+    if (nBits > 32)
+        return 3;
+    if (nBits > 8)
+        return 2;
+    return 1;
+}
+
 #if defined(USE_NUM_OPENSSL)
 
 
@@ -89,6 +107,19 @@ public:
         return (*this);
     }
 
+    // Moves only swap the BIGNUM pointers, the moved from number is left valid but unspecified
+    CBigNum(CBigNum&& b) noexcept
+    {
+        bn = b.bn;
+        b.bn = BN_new();
+    }
+
+    CBigNum& operator=(CBigNum&& b) noexcept
+    {
+        std::swap(bn, b.bn);
+        return (*this);
+    }
+
     ~CBigNum()
     {
         BN_clear_free(bn);
@@ -482,6 +513,78 @@ public:
         return ret;
     }
 
+    /**
+     * modular multi-exponentiation: prod(bases[i]^exps[i]) mod m
+     * Interleaved fixed window (Straus) exponentiation, the squarings are shared between all of the bases.
+     * This is not constant time and should only be used with public exponents.
+     * @param bases the bases
+     * @param exps the exponents, a negative exponent uses the inverse of its base
+     * @param m modulus
+     */
+    static CBigNum multi_pow_mod(const std::vector<CBigNum>& bases, const std::vector<CBigNum>& exps, const CBigNum& m) {
+        if (bases.size() != exps.size())
+            throw bignum_error("CBigNum::multi_pow_mod : number of bases and exponents differ");
+
+        CAutoBN_CTX pctx;
+        std::vector<CBigNum> vBases;
+        std::vector<CBigNum> vExps;
+        int nMaxBits = 0;
+        for (unsigned int i = 0; i < bases.size(); i++) {
+            if (BN_is_zero(exps[i].bn))
+                continue;
+            if (BN_is_negative(exps[i].bn)) {
+                // g^-x = (g^-1)^x
+                vBases.emplace_back(bases[i].inverse(m));
+                vExps.emplace_back(-exps[i]);
+            } else {
+                vBases.emplace_back();
+                if (!BN_nnmod(vBases.back().bn, bases[i].bn, m.bn, pctx))
+                    throw bignum_error("CBigNum::multi_pow_mod : BN_nnmod failed");
+                vExps.emplace_back(exps[i]);
+            }
+            nMaxBits = std::max(nMaxBits, vExps.back().bitSize());
+        }
+
+        const int nWindow = multi_pow_window(nMaxBits);
+        const unsigned int nTableSize = 1U << nWindow;
+
+        // vTable[i * nTableSize + j] = vBases[i]^j mod m
+        std::vector<CBigNum> vTable(vBases.size() * nTableSize);
+        for (unsigned int i = 0; i < vBases.size(); i++) {
+            CBigNum* pTable = &vTable[i * nTableSize];
+            pTable[1] = vBases[i];
+            for (unsigned int j = 2; j < nTableSize; j++) {
+                if (!BN_mod_mul(pTable[j].bn, pTable[j-1].bn, vBases[i].bn, m.bn, pctx))
+                    throw bignum_error("CBigNum::multi_pow_mod : BN_mod_mul failed");
+            }
+        }
+
+        CBigNum ret = 1;
+        bool fStarted = false;
+        for (int nBit = ((nMaxBits + nWindow - 1) / nWindow - 1) * nWindow; nBit >= 0; nBit -= nWindow) {
+            if (fStarted) {
+                for (int j = 0; j < nWindow; j++) {
+                    if (!BN_mod_mul(ret.bn, ret.bn, ret.bn, m.bn, pctx))
+                        throw bignum_error("CBigNum::multi_pow_mod : BN_mod_mul failed");
+                }
+            }
+            for (unsigned int i = 0; i < vExps.size(); i++) {
+                unsigned int nDigit = 0;
+                for (int j = nWindow - 1; j >= 0; j--)
+                    nDigit = (nDigit << 1) | (BN_is_bit_set(vExps[i].bn, nBit + j) ? 1 : 0);
+                if (!nDigit)
+                    continue;
+                if (!BN_mod_mul(ret.bn, ret.bn, vTable[i * nTableSize + nDigit].bn, m.bn, pctx))
+                    throw bignum_error("CBigNum::multi_pow_mod : BN_mod_mul failed");
+                fStarted = true;
+            }
+        }
+
+        if (!BN_nnmod(ret.bn, ret.bn, m.bn, pctx))
+            throw bignum_error("CBigNum::multi_pow_mod : BN_nnmod failed");
+        return ret;
+    }
+
    /**
     * Calculates the inverse of this element mod m.
     * i.e. i such this*i = 1 mod m
@@ -541,6 +644,10 @@ public:
         return BN_is_one(bn);
     }
 
+    bool isBitSet(unsigned int n) const {
+        return BN_is_bit_set(bn, n);
+    }
+
 
 
     bool operator!() const
@@ -753,6 +860,19 @@ public:
         return (*this);
     }
 
+    // Moves only swap the limb pointers, the moved from number is left valid but unspecified
+    CBigNum(CBigNum&& b) noexcept
+    {
+        mpz_init(bn);
+        mpz_swap(bn, b.bn);
+    }
+
+    CBigNum& operator=(CBigNum&& b) noexcept
+    {
+        mpz_swap(bn, b.bn);
+        return (*this);
+    }
+
     ~CBigNum()
     {
         mpz_clear(bn);
@@ -1013,13 +1133,82 @@ public:
      */
     CBigNum pow_mod(const CBigNum& e, const CBigNum& m) const {
         CBigNum ret;
-        if (e > CBigNum(0) && mpz_odd_p(m.bn))
+        if (mpz_sgn(e.bn) > 0 && mpz_odd_p(m.bn))
             mpz_powm_sec (ret.bn, bn, e.bn, m.bn);
         else
             mpz_powm (ret.bn, bn, e.bn, m.bn);
         return ret;
     }
 
+    /**
+     * modular multi-exponentiation: prod(bases[i]^exps[i]) mod m
+     * Interleaved fixed window (Straus) exponentiation, the squarings are shared between all of the bases.
+     * This is not constant time and should only be used with public exponents.
+     * @param bases the bases
+     * @param exps the exponents, a negative exponent uses the inverse of its base
+     * @param m modulus
+     */
+    static CBigNum multi_pow_mod(const std::vector<CBigNum>& bases, const std::vector<CBigNum>& exps, const CBigNum& m) {
+        if (bases.size() != exps.size())
+            throw bignum_error("CBigNum::multi_pow_mod : number of bases and exponents differ");
+
+        std::vector<CBigNum> vBases;
+        std::vector<CBigNum> vExps;
+        int nMaxBits = 0;
+        for (unsigned int i = 0; i < bases.size(); i++) {
+            if (mpz_sgn(exps[i].bn) == 0)
+                continue;
+            if (mpz_sgn(exps[i].bn) < 0) {
+                // g^-x = (g^-1)^x
+                vBases.emplace_back(bases[i].inverse(m));
+                vExps.emplace_back(-exps[i]);
+            } else {
+                vBases.emplace_back();
+                mpz_mod(vBases.back().bn, bases[i].bn, m.bn);
+                vExps.emplace_back(exps[i]);
+            }
+            nMaxBits = std::max(nMaxBits, vExps.back().bitSize());
+        }
+
+        const int nWindow = multi_pow_window(nMaxBits);
+        const unsigned int nTableSize = 1U << nWindow;
+
+        // vTable[i * nTableSize + j] = vBases[i]^j mod m
+        std::vector<CBigNum> vTable(vBases.size() * nTableSize);
+        for (unsigned int i = 0; i < vBases.size(); i++) {
+            CBigNum* pTable = &vTable[i * nTableSize];
+            pTable[1] = vBases[i];
+            for (unsigned int j = 2; j < nTableSize; j++) {
+                mpz_mul(pTable[j].bn, pTable[j-1].bn, vBases[i].bn);
+                mpz_mod(pTable[j].bn, pTable[j].bn, m.bn);
+            }
+        }
+
+        CBigNum ret = 1;
+        bool fStarted = false;
+        for (int nBit = ((nMaxBits + nWindow - 1) / nWindow - 1) * nWindow; nBit >= 0; nBit -= nWindow) {
+            if (fStarted) {
+                for (int j = 0; j < nWindow; j++) {
+                    mpz_mul(ret.bn, ret.bn, ret.bn);
+                    mpz_mod(ret.bn, ret.bn, m.bn);
+                }
+            }
+            for (unsigned int i = 0; i < vExps.size(); i++) {
+                unsigned int nDigit = 0;
+                for (int j = nWindow - 1; j >= 0; j--)
+                    nDigit = (nDigit << 1) | mpz_tstbit(vExps[i].bn, nBit + j);
+                if (!nDigit)
+                    continue;
+                mpz_mul(ret.bn, ret.bn, vTable[i * nTableSize + nDigit].bn);
+                mpz_mod(ret.bn, ret.bn, m.bn);
+                fStarted = true;
+            }
+        }
+
+        mpz_mod(ret.bn, ret.bn, m.bn);
+        return ret;
+    }
+
    /**
     * Calculates the inverse of this element mod m.
     * i.e. i such this*i = 1 mod m
@@ -1072,6 +1261,11 @@ public:
         return mpz_cmp(bn, CBigNum(1).bn) == 0;
     }
 
+    bool isBitSet(unsigned int n) const
+    {
+        return mpz_tstbit(bn, n);
+    }
+
     bool operator!() const
     {
         return mpz_cmp(bn, CBigNum(0).bn) == 0;
@@ -1103,7 +1297,7 @@ public:
 
     CBigNum& operator%=(const CBigNum& b)
     {
-        *this = *this % b;
+        mpz_mod(bn, bn, b.bn);
         return *this;
     }
 
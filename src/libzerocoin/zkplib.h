@@ -15,15 +15,15 @@ namespace libzerocoin {
 
 
 inline void vectorTimesConstant(CBN_vector& kV,
-        CBN_vector& V, const CBigNum& k, const CBigNum& modulus)
+        const CBN_vector& V, const CBigNum& k, const CBigNum& modulus)
 {
     transform(V.begin(), V.end(), kV.begin(),
-            [=] (CBigNum Vi) {
+            [&] (const CBigNum& Vi) {
         return Vi.mul_mod(k,modulus);} );
 }
 
 inline CBN_vector vectorTimesConstant(
-        CBN_vector& V, const CBigNum& k, const CBigNum& modulus)
+        const CBN_vector& V, const CBigNum& k, const CBigNum& modulus)
 {
     CBN_vector kV(V.size());
     vectorTimesConstant(kV, V, k, modulus);
@@ -31,7 +31,7 @@ inline CBN_vector vectorTimesConstant(
 }
 
 inline void addVectors_mod(CBN_vector& sum,
-        CBN_vector& v1, CBN_vector& v2, const CBigNum& modulus)
+        const CBN_vector& v1, const CBN_vector& v2, const CBigNum& modulus)
 {
     if(v1.size() != v2.size())
         throw std::runtime_error("different vector length in addVectors_mod");
@@ -39,10 +39,23 @@ inline void addVectors_mod(CBN_vector& sum,
     sum.resize(v1.size());
 
     transform(v1.begin(), v1.end(), v2.begin(), sum.begin(),
-            [=] (CBigNum v1_i, CBigNum v2_i) {
+            [&] (const CBigNum& v1_i, const CBigNum& v2_i) {
         return (v1_i + v2_i) % modulus;} );
 }
 
+// acc = (acc + a*b*c) % modulus computed in place, tmp is scratch space that can be reused between calls
+inline void addProduct_mod(CBigNum& acc, CBigNum& tmp,
+        const CBigNum& a, const CBigNum& b, const CBigNum& c, const CBigNum& modulus)
+{
+    tmp = a;
+    tmp *= b;
+    tmp %= modulus;
+    tmp *= c;
+    tmp %= modulus;
+    acc += tmp;
+    acc %= modulus;
+}
+
 inline void unit_vector(CBN_vector& v, const unsigned int j)
 {
     std::fill(v.begin(), v.end(), CBigNum(0));
@@ -78,7 +91,7 @@ inline CBigNum pedersenCommitment(const ZerocoinParams* ZCparams,
         const CBN_vector& g_blinders, const CBigNum& h_blinder)
 {
     const IntegerGroupParams* SoKgroup = &(ZCparams->serialNumberSoKCommitmentGroup);
-    const CBigNum p = SoKgroup->modulus;
+    const CBigNum& p = SoKgroup->modulus;
 
     // assert len(gelements) >= len(g_blinders)
     if( SoKgroup->gis.size() < g_blinders.size() )
@@ -86,8 +99,8 @@ inline CBigNum pedersenCommitment(const ZerocoinParams* ZCparams,
 
     CBigNum C = CBigNum(1);
     for(unsigned int i=0; i<g_blinders.size(); i++)
-        C = C.mul_mod((SoKgroup->gis[i]).pow_mod(g_blinders[i],p),p);
-    C = C.mul_mod((SoKgroup->h).pow_mod(h_blinder,p),p);
+        C = C.mul_mod(SoKgroup->pow_mod(SoKgroup->gis[i], g_blinders[i]),p);
+    C = C.mul_mod(SoKgroup->pow_mod(SoKgroup->h, h_blinder),p);
 
     return C;
 }
@@ -105,10 +118,11 @@ inline std::pair<CBN_matrix, CBN_matrix> ck_inner_gen(
         const ZerocoinParams* ZCp, const CBigNum& y)
 {
     const IntegerGroupParams* SoKgroup = &(ZCp->serialNumberSoKCommitmentGroup);
-    const CBigNum q = SoKgroup->groupOrder;
-    const CBigNum p = SoKgroup->modulus;
+    const CBigNum& q = SoKgroup->groupOrder;
     CBN_matrix ck_inner_g(1, CBN_vector());
     CBN_matrix ck_inner_h(1, CBN_vector());
+    ck_inner_g[0].reserve(ZKP_N+ZKP_PADS);
+    ck_inner_h[0].reserve(ZKP_N+ZKP_PADS);
 
     CBigNum exp = CBigNum(1);
     CBigNum ym = y.pow_mod(-ZKP_M, q);
@@ -116,27 +130,24 @@ inline std::pair<CBN_matrix, CBN_matrix> ck_inner_gen(
     for(int j=0; j<(ZKP_N+ZKP_PADS); j++) {
         ck_inner_g[0].push_back(SoKgroup->gis[j]);
         exp = exp.mul_mod(ym,q);
-        ck_inner_h[0].push_back(SoKgroup->gis[j].pow_mod(exp,p));
+        ck_inner_h[0].push_back(SoKgroup->pow_mod_public(SoKgroup->gis[j], exp));
     }
 
-    return make_pair(ck_inner_g, ck_inner_h);
+    return std::make_pair(std::move(ck_inner_g), std::move(ck_inner_h));
 }
 
 // Initialize sets for inner product - for batching
 inline CBN_matrix ck_inner_gen(const ZerocoinParams* ZCp)
 {
     const IntegerGroupParams* SoKgroup = &(ZCp->serialNumberSoKCommitmentGroup);
-    CBN_matrix ck_inner_g(1, CBN_vector());
-
-    for(int j=0; j<(ZKP_N+ZKP_PADS); j++)
-        ck_inner_g[0].push_back(SoKgroup->gis[j]);
+    CBN_matrix ck_inner_g(1, CBN_vector(SoKgroup->gis.begin(), SoKgroup->gis.begin() + ZKP_N+ZKP_PADS));
 
     return ck_inner_g;
 }
 
 
 inline void hadamard(CBN_vector& had,
-        CBN_vector& u, CBN_vector& v, const CBigNum& modulus)
+        const CBN_vector& u, const CBN_vector& v, const CBigNum& modulus)
 {
     if(u.size() != v.size())
         throw std::runtime_error("different vector length in hadamard");
@@ -145,12 +156,12 @@ inline void hadamard(CBN_vector& had,
     had.resize(u.size());
 
     transform(u.begin(), u.end(), v.begin(), had.begin(),
-            [=] (CBigNum u_i, CBigNum v_i) {
+            [&] (const CBigNum& u_i, const CBigNum& v_i) {
         return u_i.mul_mod(v_i, modulus);} );
 }
 
 // Print Functions
-inline void printVector(const CBN_vector v)
+inline void printVector(const CBN_vector& v)
 {
     std::cout << "[";
     for(unsigned int i=0; i<v.size()-1; i++)
@@ -159,7 +170,7 @@ inline void printVector(const CBN_vector v)
 
 }
 
-inline void printMatrix(const CBN_matrix w)
+inline void printMatrix(const CBN_matrix& w)
 {
     std::cout << "[";
     for(unsigned int i=0; i<w.size()-1; i++) {
@@ -418,7 +418,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
             LogPrint(BCLog::BLOCKCREATION, "%s: failed to get accumulator checkpoints\n", __func__);
         pblock->mapAccumulatorHashes = mapAccumulators.GetCheckpoints(true);
     } else {
-        pblock->mapAccumulatorHashes = pindexPrev->mapAccumulatorHashes;
+        pblock->mapAccumulatorHashes = pindexPrev->GetAccumulatorHashes();
     }
 
     //Proof of full node
@@ -941,6 +941,34 @@ void ThreadStakeMiner()
     LogPrintf("ThreadStakeMiner exiting\n");
 }
 
+#ifdef ENABLE_WALLET
+// Keeps the spend proofs of the best staking candidates built, so that a found kernel only needs the signing steps
+void ThreadPrepareStakeSpends()
+{
+    LogPrintf("ThreadPrepareStakeSpends() start\n");
+    int nCandidates = gArgs.GetArg("-stakeprepare", DEFAULT_STAKE_PREPARE);
+    try {
+        while (!ShutdownRequested()) {
+            boost::this_thread::interruption_point();
+            auto pwallet = GetMainWallet();
+            if (pwallet && pwallet->IsStakingEnabled() && !IsInitialBlockDownload()) {
+                if (pwallet->IsLocked())
+                    pwallet->ClearPreparedStakes();
+                else
+                    pwallet->PrepareStakeSpends(nCandidates);
+            }
+            MilliSleep(10000);
+        }
+    } catch (std::exception& e) {
+        LogPrintf("ThreadPrepareStakeSpends() exception\n");
+    } catch (boost::thread_interrupted) {
+        LogPrintf("ThreadPrepareStakeSpends() interrupted\n");
+    }
+
+    LogPrintf("ThreadPrepareStakeSpends exiting\n");
+}
+#endif
+
 boost::thread_group* pthreadGroupPoW;
 void LinkPoWThreadGroup(void* pthreadgroup)
 {
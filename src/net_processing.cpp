@@ -1469,12 +1469,6 @@ void ProcessStagingBatchVerify()
             continue;
         }
 
-        std::set<uint256> setBatchVerified_local;
-        {
-            LOCK(cs_main);
-            setBatchVerified_local = setBatchVerified;
-        }
-
         // Perform batch verification for all staged blocks (that haven't yet been verified) to speed up getting blocks
         std::vector<CBigNum> vBlockSerials;
         std::vector<libzerocoin::SerialNumberSoKProof> vProofs;
@@ -1495,21 +1489,21 @@ void ProcessStagingBatchVerify()
             for (auto& tx : blockPair.second.vtx) {
                 auto txid = tx->GetHash();
                 //Don't reverify
-                if (setBatchVerified_local.count(txid))
+                if (IsZerocoinProofVerified(txid))
                     continue;
 
                 if (tx->IsZerocoinSpend()) {
                     for (auto& txin : tx->vin) {
-                        libzerocoin::CoinSpend spend = *(TxInToZerocoinSpend(txin));
+                        auto spend = TxInToZerocoinSpend(txin);
                         if (!GetZerocoinSpendProofs(txin, vProofsTemp) || count(vBlockSerials.begin(),
                                                                                 vBlockSerials.end(),
-                                                                                spend.getCoinSerialNumber())) {
+                                                                                spend->getCoinSerialNumber())) {
                             setRemoveBlocks.insert(blockPair.first);
                             fSkipBlock = true;
                             break;
                         }
 
-                        vBlockSerials.emplace_back(spend.getCoinSerialNumber());
+                        vBlockSerials.emplace_back(spend->getCoinSerialNumber());
                     }
                     setBatchTxHashes.emplace(txid);
                 }
@@ -1544,9 +1538,8 @@ void ProcessStagingBatchVerify()
 
         if (fVerificationSuccess) {
             // Mark as verified
-            LOCK(cs_main);
             for (const uint256& hash : setBatchTxHashes)
-                setBatchVerified.emplace(hash);
+                SetZerocoinProofVerified(hash);
         }
     }
 }
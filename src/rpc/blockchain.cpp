@@ -33,6 +33,7 @@
 #include <validationinterface.h>
 #include <warnings.h>
 #include <veil/ringct/anon.h>
+#include <veil/zerocoin/zchain.h>
 
 #include <assert.h>
 #include <stdint.h>
@@ -241,7 +242,7 @@ static UniValue getzerocoinsupply(const JSONRPCRequest& request)
     for (auto denom : libzerocoin::zerocoinDenomList) {
         UniValue denomObj(UniValue::VOBJ);
         denomObj.push_back(Pair("denom", to_string(denom)));
-        int64_t denomSupply = pblockindex->mapZerocoinSupply.at(denom) * (denom*COIN);
+        int64_t denomSupply = pblockindex->GetZerocoinSupply(denom) * (denom*COIN);
         denomObj.push_back(Pair("amount", denomSupply));
         double denomSupplyPercent = double(100.0 * denomSupply / totalSupply);
         denomObj.push_back(Pair("percent", denomSupplyPercent));
@@ -1529,6 +1530,39 @@ static UniValue getmempoolinfo(const JSONRPCRequest& request)
     return mempoolInfoToJSON();
 }
 
+static UniValue getbatchverifyinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getbatchverifyinfo\n"
+            "\nReturns statistics of the zerocoin proof batch verification pool.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"calls\": xxxxx,              (numeric) Number of batch verifications completed\n"
+            "  \"proofs\": xxxxx,             (numeric) Number of proofs verified\n"
+            "  \"failures\": xxxxx,           (numeric) Number of batch verifications that failed\n"
+            "  \"queued\": xxxxx,             (numeric) Number of proofs waiting for or being processed by the pool\n"
+            "  \"last_latency_us\": xxxxx,    (numeric) Latency of the most recent batch verification in microseconds\n"
+            "  \"avg_latency_us\": xxxxx,     (numeric) Average latency of a batch verification in microseconds\n"
+            "  \"total_wait_us\": xxxxx       (numeric) Total time callers waited for the pool to become free in microseconds\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getbatchverifyinfo", "")
+            + HelpExampleRpc("getbatchverifyinfo", "")
+        );
+
+    BatchVerifyStats stats = GetBatchVerifyStats();
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("calls", stats.nCalls);
+    ret.pushKV("proofs", stats.nProofs);
+    ret.pushKV("failures", stats.nFailures);
+    ret.pushKV("queued", stats.nQueued);
+    ret.pushKV("last_latency_us", stats.nLastMicros);
+    ret.pushKV("avg_latency_us", stats.nCalls ? stats.nTotalMicros / (int64_t)stats.nCalls : 0);
+    ret.pushKV("total_wait_us", stats.nWaitMicros);
+    return ret;
+}
+
 static UniValue preciousblock(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -2316,6 +2350,7 @@ static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "blockchain",         "findserial",             &findserial,             {"serial"} },
+    { "blockchain",         "getbatchverifyinfo",     &getbatchverifyinfo,     {} },
     { "blockchain",         "getblockchaininfo",      &getblockchaininfo,      {} },
     { "blockchain",         "getchaintxstats",        &getchaintxstats,        {"nblocks", "blockhash"} },
     { "blockchain",         "getblockstats",          &getblockstats,          {"hash_or_height", "stats"} },
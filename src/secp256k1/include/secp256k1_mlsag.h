@@ -24,6 +24,18 @@ int secp256k1_verify_mlsag(const secp256k1_context *ctx, const uint8_t *preimage
     size_t nCols, size_t nRows,
     const uint8_t *pk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps);
 
+/** Hashes a 33 byte public key to the curve point H(pk) used by the key images and ring signatures.
+ *  Returns 0 on success.
+ */
+int secp256k1_get_hash_to_curve(secp256k1_pubkey *hpk, const uint8_t *pk);
+
+/** Same as secp256k1_verify_mlsag, with H(pk) of the key rows given by hpk[col+(cols*row)] instead of hashed again.
+ *  hpk holds nCols * (nRows - 1) points, as computed by secp256k1_get_hash_to_curve.
+ */
+int secp256k1_verify_mlsag_hpk(const secp256k1_context *ctx, const uint8_t *preimage,
+    size_t nCols, size_t nRows,
+    const uint8_t *pk, const secp256k1_pubkey *hpk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,81 @@
+/**********************************************************************
+ * Copyright (c) 2019 The Veil developers                             *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#include <string.h>
+
+#include "include/secp256k1.h"
+#include "include/secp256k1_mlsag.h"
+#include "util.h"
+#include "bench.h"
+
+#define N_COLS 11
+#define N_ROWS 3 /* two inputs and the commitment sum row */
+
+typedef struct {
+    secp256k1_context *ctx;
+    uint8_t preimage[32];
+    uint8_t m[N_COLS * N_ROWS * 33];
+    secp256k1_pubkey hpk[N_COLS * (N_ROWS - 1)];
+    uint8_t ki[(N_ROWS - 1) * 33];
+    uint8_t pc[32];
+    uint8_t ps[N_COLS * N_ROWS * 32];
+} bench_mlsag_t;
+
+static void bench_mlsag_verify(void* arg) {
+    int i;
+    bench_mlsag_t *data = (bench_mlsag_t*)arg;
+
+    for (i = 0; i < 100; i++) {
+        CHECK(0 == secp256k1_verify_mlsag(data->ctx, data->preimage, N_COLS, N_ROWS, data->m, data->ki, data->pc, data->ps));
+    }
+}
+
+static void bench_mlsag_verify_hpk(void* arg) {
+    int i;
+    bench_mlsag_t *data = (bench_mlsag_t*)arg;
+
+    for (i = 0; i < 100; i++) {
+        CHECK(0 == secp256k1_verify_mlsag_hpk(data->ctx, data->preimage, N_COLS, N_ROWS, data->m, data->hpk, data->ki, data->pc, data->ps));
+    }
+}
+
+int main(void) {
+    bench_mlsag_t data;
+    uint8_t keys[N_COLS * N_ROWS * 32];
+    const uint8_t *sk[N_ROWS];
+    uint8_t nonce[32];
+    secp256k1_pubkey pubkey;
+    size_t i, len;
+    const size_t real_col = 4;
+
+    data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+    for (i = 0; i < 32; i++) {
+        data.preimage[i] = i + 1;
+        nonce[i] = i + 65;
+    }
+    for (i = 0; i < N_COLS * N_ROWS; i++) {
+        memset(&keys[i * 32], 0, 32);
+        keys[i * 32 + 30] = (i >> 8) + 1;
+        keys[i * 32 + 31] = i & 0xff;
+        CHECK(secp256k1_ec_pubkey_create(data.ctx, &pubkey, &keys[i * 32]));
+        len = 33;
+        CHECK(secp256k1_ec_pubkey_serialize(data.ctx, &data.m[i * 33], &len, &pubkey, SECP256K1_EC_COMPRESSED));
+    }
+    for (i = 0; i < N_ROWS; i++) {
+        sk[i] = &keys[(real_col + i * N_COLS) * 32];
+    }
+    for (i = 0; i < N_COLS * (N_ROWS - 1); i++) {
+        CHECK(0 == secp256k1_get_hash_to_curve(&data.hpk[i], &data.m[i * 33]));
+    }
+    CHECK(0 == secp256k1_generate_mlsag(data.ctx, data.ki, data.pc, data.ps, nonce, data.preimage, N_COLS, N_ROWS, real_col, sk, data.m));
+
+    run_benchmark("mlsag_verify", bench_mlsag_verify, NULL, NULL, &data, 10, 100);
+    run_benchmark("mlsag_verify_hpk", bench_mlsag_verify_hpk, NULL, NULL, &data, 10, 100);
+
+    secp256k1_context_destroy(data.ctx);
+    return 0;
+}
@@ -164,6 +164,17 @@ static int hash_to_curve(secp256k1_ge *ge, const uint8_t *pd, size_t len)
     return 0;
 }
 
+int secp256k1_get_hash_to_curve(secp256k1_pubkey *hpk, const uint8_t *pk)
+{
+    secp256k1_ge ge1;
+
+    if (0 != hash_to_curve(&ge1, pk, 33)) /* H(pk) */
+        return 1;
+
+    secp256k1_pubkey_save(hpk, &ge1);
+    return 0;
+}
+
 int secp256k1_get_keyimage(const secp256k1_context *ctx, uint8_t *ki, const uint8_t *pk, const uint8_t *sk)
 {
     secp256k1_ge ge1;
@@ -383,18 +394,134 @@ int secp256k1_generate_mlsag(const secp256k1_context *ctx,
         return 0;
 }
 
-int secp256k1_verify_mlsag(const secp256k1_context *ctx,
+/** Odd multiples of a point (and of its lambda image), in affine coordinates. */
+typedef struct {
+    secp256k1_ge pre[ECMULT_TABLE_SIZE(WINDOW_A)];
+#ifdef USE_ENDOMORPHISM
+    secp256k1_ge pre_lam[ECMULT_TABLE_SIZE(WINDOW_A)];
+#endif
+} secp256k1_mlsag_ecmult_table;
+
+static void secp256k1_mlsag_ecmult_table_build(secp256k1_mlsag_ecmult_table *t, const secp256k1_ge *a) {
+    secp256k1_gej prej[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_fe zr[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_gej aj;
+#ifdef USE_ENDOMORPHISM
+    int i;
+#endif
+
+    secp256k1_gej_set_ge(&aj, a);
+    secp256k1_ecmult_odd_multiples_table(ECMULT_TABLE_SIZE(WINDOW_A), prej, zr, &aj);
+    secp256k1_ge_set_table_gej_var(t->pre, prej, zr, ECMULT_TABLE_SIZE(WINDOW_A));
+#ifdef USE_ENDOMORPHISM
+    for (i = 0; i < ECMULT_TABLE_SIZE(WINDOW_A); i++) {
+        secp256k1_ge_mul_lambda(&t->pre_lam[i], &t->pre[i]);
+    }
+#endif
+}
+
+/** r = a * na + b * nb, where b is given by its precomputed table.
+ *  Strauss' method as in secp256k1_ecmult: both wNAFs share one chain of doublings, the odd multiples
+ *  of a are kept on a common Z denominator and the affine ones of b are added scaled by its inverse.
+ */
+static void secp256k1_mlsag_ecmult_double_var(secp256k1_gej *r,
+    const secp256k1_gej *a, const secp256k1_scalar *na,
+    const secp256k1_mlsag_ecmult_table *b, const secp256k1_scalar *nb)
+{
+    secp256k1_ge pre_a[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_ge tmpa;
+    secp256k1_fe Z;
+#ifdef USE_ENDOMORPHISM
+    secp256k1_ge pre_a_lam[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_scalar na_1, na_lam, nb_1, nb_lam;
+    int wnaf_na_1[130], wnaf_na_lam[130], wnaf_nb_1[130], wnaf_nb_lam[130];
+    int bits_na_1, bits_na_lam, bits_nb_1, bits_nb_lam;
+#else
+    int wnaf_na[256], wnaf_nb[256];
+    int bits_na, bits_nb;
+#endif
+    int i, n, bits;
+
+    secp256k1_ecmult_odd_multiples_table_globalz_windowa(pre_a, &Z, a);
+
+#ifdef USE_ENDOMORPHISM
+    for (i = 0; i < ECMULT_TABLE_SIZE(WINDOW_A); i++) {
+        secp256k1_ge_mul_lambda(&pre_a_lam[i], &pre_a[i]);
+    }
+
+    secp256k1_scalar_split_lambda(&na_1, &na_lam, na);
+    secp256k1_scalar_split_lambda(&nb_1, &nb_lam, nb);
+    bits_na_1   = secp256k1_ecmult_wnaf(wnaf_na_1,   130, &na_1,   WINDOW_A);
+    bits_na_lam = secp256k1_ecmult_wnaf(wnaf_na_lam, 130, &na_lam, WINDOW_A);
+    bits_nb_1   = secp256k1_ecmult_wnaf(wnaf_nb_1,   130, &nb_1,   WINDOW_A);
+    bits_nb_lam = secp256k1_ecmult_wnaf(wnaf_nb_lam, 130, &nb_lam, WINDOW_A);
+    bits = bits_na_1;
+    if (bits_na_lam > bits) {
+        bits = bits_na_lam;
+    }
+    if (bits_nb_1 > bits) {
+        bits = bits_nb_1;
+    }
+    if (bits_nb_lam > bits) {
+        bits = bits_nb_lam;
+    }
+#else
+    bits_na = secp256k1_ecmult_wnaf(wnaf_na, 256, na, WINDOW_A);
+    bits_nb = secp256k1_ecmult_wnaf(wnaf_nb, 256, nb, WINDOW_A);
+    bits = bits_na > bits_nb ? bits_na : bits_nb;
+#endif
+
+    secp256k1_gej_set_infinity(r);
+
+    for (i = bits - 1; i >= 0; i--) {
+        secp256k1_gej_double_var(r, r, NULL);
+#ifdef USE_ENDOMORPHISM
+        if (i < bits_na_1 && (n = wnaf_na_1[i])) {
+            ECMULT_TABLE_GET_GE(&tmpa, pre_a, n, WINDOW_A);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_na_lam && (n = wnaf_na_lam[i])) {
+            ECMULT_TABLE_GET_GE(&tmpa, pre_a_lam, n, WINDOW_A);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_nb_1 && (n = wnaf_nb_1[i])) {
+            ECMULT_TABLE_GET_GE(&tmpa, b->pre, n, WINDOW_A);
+            secp256k1_gej_add_zinv_var(r, r, &tmpa, &Z);
+        }
+        if (i < bits_nb_lam && (n = wnaf_nb_lam[i])) {
+            ECMULT_TABLE_GET_GE(&tmpa, b->pre_lam, n, WINDOW_A);
+            secp256k1_gej_add_zinv_var(r, r, &tmpa, &Z);
+        }
+#else
+        if (i < bits_na && (n = wnaf_na[i])) {
+            ECMULT_TABLE_GET_GE(&tmpa, pre_a, n, WINDOW_A);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_nb && (n = wnaf_nb[i])) {
+            ECMULT_TABLE_GET_GE(&tmpa, b->pre, n, WINDOW_A);
+            secp256k1_gej_add_zinv_var(r, r, &tmpa, &Z);
+        }
+#endif
+    }
+
+    if (!r->infinity) {
+        secp256k1_fe_mul(&r->z, &r->z, &Z);
+    }
+}
+
+static int secp256k1_verify_mlsag_impl(const secp256k1_context *ctx,
     const uint8_t *preimage, size_t nCols, size_t nRows,
-    const uint8_t *pk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps)
+    const uint8_t *pk, const secp256k1_pubkey *hpk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps)
 {
         secp256k1_sha256_t sha256_m, sha256_pre;
         secp256k1_scalar zero, clast, cSig, ss;
         secp256k1_ge ge1;
-        secp256k1_gej gej1, gej2, L, R;
+        secp256k1_gej gej1, L, R;
+        secp256k1_mlsag_ecmult_table *ki_tables;
         size_t dsRows = nRows - 1; /* TODO: pass in dsRows explicitly? */
         uint8_t tmp[33];
         size_t i, k, clen;
-        int overflow;
+        int overflow, rv = 0;
 
         secp256k1_scalar_set_int(&zero, 0);
 
@@ -403,6 +530,16 @@ int secp256k1_verify_mlsag(const secp256k1_context *ctx,
             return 9;
         }
 
+        /* The key images are the same in every column, compute their odd multiples once */
+        ki_tables = (secp256k1_mlsag_ecmult_table*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_mlsag_ecmult_table) * (dsRows > 0 ? dsRows : 1));
+        for (k = 0; k < dsRows; ++k) {
+            if (!secp256k1_eckey_pubkey_parse(&ge1, &ki[k * 33], 33)) {
+                free(ki_tables);
+                return 4;
+            }
+            secp256k1_mlsag_ecmult_table_build(&ki_tables[k], &ge1);
+        }
+
         cSig = clast;
 
         secp256k1_sha256_initialize(&sha256_m);
@@ -416,28 +553,28 @@ int secp256k1_verify_mlsag(const secp256k1_context *ctx,
                 /* L = G * ss + pk[k][i] * clast */
                 secp256k1_scalar_set_b32(&ss, &ps[(i + k * nCols) * 32], &overflow);
                 if (overflow || secp256k1_scalar_is_zero(&ss)) {
-                    return 1;
+                    rv = 1;
+                    goto done;
                 }
                 if (!secp256k1_eckey_pubkey_parse(&ge1, &pk[(i + k * nCols) * 33], 33)) {
-                    return 2;
+                    rv = 2;
+                    goto done;
                 }
                 secp256k1_gej_set_ge(&gej1, &ge1);
                 secp256k1_ecmult(&ctx->ecmult_ctx, &L, &gej1, &clast, &ss);
 
                 /* R = H(pk[k][i]) * ss + ki[k] * clast */
-                if (0 != hash_to_curve(&ge1, &pk[(i + k * nCols) * 33], 33)) { /* H(pk[k][i]) */
-                    return 3;
+                if (hpk) {
+                    if (!secp256k1_pubkey_load(ctx, &ge1, &hpk[i + k * nCols])) { /* H(pk[k][i]) */
+                        rv = 3;
+                        goto done;
+                    }
+                } else if (0 != hash_to_curve(&ge1, &pk[(i + k * nCols) * 33], 33)) { /* H(pk[k][i]) */
+                    rv = 3;
+                    goto done;
                 }
                 secp256k1_gej_set_ge(&gej1, &ge1);
-                secp256k1_ecmult(&ctx->ecmult_ctx, &gej1, &gej1, &ss, &zero); /* gej1 = H(pk[k][i]) * ss */
-
-                if (!secp256k1_eckey_pubkey_parse(&ge1, &ki[k * 33], 33)) {
-                    return 4;
-                }
-                secp256k1_gej_set_ge(&gej2, &ge1);
-                secp256k1_ecmult(&ctx->ecmult_ctx, &gej2, &gej2, &clast, &zero); /* gej2 = ki[k] * clast */
-
-                secp256k1_gej_add_var(&R, &gej1, &gej2, NULL);  /* R =  gej1 + gej2 */
+                secp256k1_mlsag_ecmult_double_var(&R, &gej1, &ss, &ki_tables[k], &clast);
 
                 secp256k1_sha256_write(&sha256_m, &pk[(i + k * nCols) * 33], 33); /* pk[k][i] */
                 secp256k1_ge_set_gej(&ge1, &L);
@@ -452,11 +589,13 @@ int secp256k1_verify_mlsag(const secp256k1_context *ctx,
                 /* L = G * ss + pk[k][i] * clast */
                 secp256k1_scalar_set_b32(&ss, &ps[(i + k * nCols) * 32], &overflow);
                 if (overflow || secp256k1_scalar_is_zero(&ss)) {
-                    return 5;
+                    rv = 5;
+                    goto done;
                 }
 
                 if (!secp256k1_eckey_pubkey_parse(&ge1, &pk[(i + k * nCols) * 33], 33)) {
-                    return 6;
+                    rv = 6;
+                    goto done;
                 }
 
                 secp256k1_gej_set_ge(&gej1, &ge1);
@@ -471,14 +610,33 @@ int secp256k1_verify_mlsag(const secp256k1_context *ctx,
             secp256k1_sha256_finalize(&sha256_m, tmp);
             secp256k1_scalar_set_b32(&clast, tmp, &overflow);
             if (overflow || secp256k1_scalar_is_zero(&clast)) {
-                return 7;
+                rv = 7;
+                goto done;
             }
         };
 
         secp256k1_scalar_negate(&cSig, &cSig);
         secp256k1_scalar_add(&zero, &clast, &cSig);
 
-        return secp256k1_scalar_is_zero(&zero) ? 0 : 8; /* return 0 on success, 2 on failure */
+        rv = secp256k1_scalar_is_zero(&zero) ? 0 : 8; /* return 0 on success, 8 on failure */
+done:
+        free(ki_tables);
+        return rv;
+}
+
+int secp256k1_verify_mlsag(const secp256k1_context *ctx,
+    const uint8_t *preimage, size_t nCols, size_t nRows,
+    const uint8_t *pk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps)
+{
+    return secp256k1_verify_mlsag_impl(ctx, preimage, nCols, nRows, pk, NULL, ki, pc, ps);
+}
+
+int secp256k1_verify_mlsag_hpk(const secp256k1_context *ctx,
+    const uint8_t *preimage, size_t nCols, size_t nRows,
+    const uint8_t *pk, const secp256k1_pubkey *hpk, const uint8_t *ki, const uint8_t *pc, const uint8_t *ps)
+{
+    ARG_CHECK(hpk != NULL);
+    return secp256k1_verify_mlsag_impl(ctx, preimage, nCols, nRows, pk, hpk, ki, pc, ps);
 }
 
 #endif
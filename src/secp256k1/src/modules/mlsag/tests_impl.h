@@ -41,6 +41,7 @@ void test_mlsag(void)
     uint8_t pc[32];
     uint8_t ki[MAX_N_INPUTS * 33];
     uint8_t ss[(MAX_N_INPUTS+1) * MAX_N_COLUMNS * 33]; /* max_rows * max_cols */
+    secp256k1_pubkey hpk[MAX_N_INPUTS * MAX_N_COLUMNS];
 
     secp256k1_rand256(preimage);
 
@@ -126,20 +127,33 @@ void test_mlsag(void)
         preimage, n_columns, n_rows,
         m, ki, pc, ss));
 
+    /* Precomputed H(pk) */
+    for (i = 0; i < n_inputs * n_columns; ++i)
+        CHECK(0 == secp256k1_get_hash_to_curve(&hpk[i], &m[i * 33]));
+    CHECK(0 == secp256k1_verify_mlsag_hpk(ctx,
+        preimage, n_columns, n_rows,
+        m, hpk, ki, pc, ss));
+
 
     /* --- Test for failure --- */
 
     /* Bad preimage */
-    CHECK(2 == secp256k1_verify_mlsag(ctx,
+    CHECK(8 == secp256k1_verify_mlsag(ctx,
         tmp32, n_columns, n_rows,
         m, ki, pc, ss));
 
 
     /* Bad c */
-    CHECK(2 == secp256k1_verify_mlsag(ctx,
+    CHECK(8 == secp256k1_verify_mlsag(ctx,
         preimage, n_columns, n_rows,
         m, ki, tmp32, ss));
 
+    /* H(pk) of another key */
+    CHECK(0 == secp256k1_get_hash_to_curve(&hpk[n_real_col], ki));
+    CHECK(8 == secp256k1_verify_mlsag_hpk(ctx,
+        preimage, n_columns, n_rows,
+        m, hpk, ki, pc, ss));
+
 
     /* Bad sum */
     value[0] -= 1;
@@ -150,7 +164,7 @@ void test_mlsag(void)
     CHECK(0 == secp256k1_generate_mlsag(ctx, ki, pc, ss,
         tmp32, preimage, n_columns, n_rows, n_real_col,
         (const uint8_t**)pkeys, m));
-    CHECK(2 == secp256k1_verify_mlsag(ctx,
+    CHECK(8 == secp256k1_verify_mlsag(ctx,
         preimage, n_columns, n_rows,
         m, ki, pc, ss));
 
@@ -175,15 +189,52 @@ void test_mlsag(void)
     CHECK(0 == secp256k1_generate_mlsag(ctx, ki, pc, ss,
         tmp32, preimage, n_columns, n_rows, n_real_col,
         (const uint8_t**)pkeys, m));
-    CHECK(2 == secp256k1_verify_mlsag(ctx,
+    CHECK(8 == secp256k1_verify_mlsag(ctx,
         preimage, n_columns, n_rows,
         m, ki, pc, ss));
 }
 
 
+void test_mlsag_ecmult_double(void)
+{
+    secp256k1_scalar na, nb, zero;
+    secp256k1_ge a, b;
+    secp256k1_gej aj, bj, r, expected;
+    secp256k1_mlsag_ecmult_table b_table;
+
+    random_group_element_test(&a);
+    random_group_element_test(&b);
+    random_group_element_jacobian_test(&aj, &a);
+    random_scalar_order_test(&na);
+    random_scalar_order_test(&nb);
+    secp256k1_scalar_set_int(&zero, 0);
+
+    /* expected = a * na + b * nb */
+    secp256k1_ecmult(&ctx->ecmult_ctx, &expected, &aj, &na, &zero);
+    secp256k1_gej_set_ge(&bj, &b);
+    secp256k1_ecmult(&ctx->ecmult_ctx, &bj, &bj, &nb, &zero);
+    secp256k1_gej_add_var(&expected, &expected, &bj, NULL);
+
+    secp256k1_mlsag_ecmult_table_build(&b_table, &b);
+    secp256k1_mlsag_ecmult_double_var(&r, &aj, &na, &b_table, &nb);
+    secp256k1_gej_neg(&r, &r);
+    secp256k1_gej_add_var(&r, &r, &expected, NULL);
+    CHECK(secp256k1_gej_is_infinity(&r));
+
+    /* a * na - a * na */
+    secp256k1_mlsag_ecmult_table_build(&b_table, &a);
+    secp256k1_scalar_negate(&nb, &na);
+    secp256k1_mlsag_ecmult_double_var(&r, &aj, &na, &b_table, &nb);
+    CHECK(secp256k1_gej_is_infinity(&r));
+}
+
 void run_mlsag_tests(void) {
     int i;
 
+    for (i = 0; i < count * 16; i++) {
+        test_mlsag_ecmult_double();
+    }
+
     for (i = 0; i < mlsag_count; i++) {
         test_mlsag();
     }
@@ -533,4 +533,39 @@ BOOST_AUTO_TEST_CASE(rolling_bloom)
     }
 }
 
+BOOST_AUTO_TEST_CASE(blocked_bloom)
+{
+    CBlockedBloomFilter filter(10000);
+    BOOST_CHECK(filter.capacity() >= 10000);
+
+    std::vector<uint256> vHashes;
+    for (int i = 0; i < 10000; i++) {
+        vHashes.push_back(InsecureRand256());
+        filter.insert(vHashes.back());
+    }
+    BOOST_CHECK_EQUAL(filter.size(), 10000U);
+
+    // Every inserted hash is found
+    int nMisses = 0;
+    for (const uint256& hash : vHashes) {
+        if (!filter.contains(hash))
+            ++nMisses;
+    }
+    BOOST_CHECK_EQUAL(nMisses, 0);
+
+    // Expect about 10 false positives, more than 100 means
+    // something is definitely broken.
+    int nHits = 0;
+    for (int i = 0; i < 10000; i++) {
+        if (filter.contains(InsecureRand256()))
+            ++nHits;
+    }
+    BOOST_TEST_MESSAGE("BlockedBloomFilter got " << nHits << " false positives (~10 expected)");
+    BOOST_CHECK(nHits < 100);
+
+    filter.Reset(100);
+    BOOST_CHECK_EQUAL(filter.size(), 0U);
+    BOOST_CHECK(!filter.contains(vHashes[0]));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
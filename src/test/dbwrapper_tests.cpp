@@ -3,12 +3,15 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <dbwrapper.h>
+#include <txdb.h>
 #include <uint256.h>
 #include <random.h>
 #include <test/test_veil.h>
 
 #include <memory>
 
+#include <secp256k1_mlsag.h>
+
 #include <boost/test/unit_test.hpp>
 
 // Test if a string consists entirely of null characters
@@ -319,4 +322,95 @@ BOOST_AUTO_TEST_CASE(iterator_string_ordering)
 
 
 
+BOOST_AUTO_TEST_CASE(rct_output_cache)
+{
+    SetDataDir("rct_output_cache");
+    CBlockTreeDB db(1 << 20, true);
+    std::vector<CAnonOutput> vOutputs(8);
+    for (size_t i = 0; i < vOutputs.size(); i++) {
+        uint256 hash = InsecureRand256();
+        std::vector<unsigned char> vchPubKey(1, 0x02);
+        vchPubKey.insert(vchPubKey.end(), hash.begin(), hash.end());
+        vOutputs[i].pubkey = CCmpPubKey(vchPubKey);
+        vOutputs[i].outpoint = COutPoint(hash, i);
+        vOutputs[i].nBlockHeight = i;
+        BOOST_CHECK(db.WriteRCTOutput(i + 1, vOutputs[i]));
+    }
+
+    //! Expect Pass: a cache of the last four outputs answers the same as the database
+    BOOST_CHECK(db.LoadRCTOutputCache(vOutputs.size(), 4 * sizeof(CCachedAnonOutput)));
+    CAnonOutput ao;
+    for (size_t i = 0; i < vOutputs.size(); i++) {
+        BOOST_CHECK(db.ReadRCTOutput(i + 1, ao));
+        BOOST_CHECK(ao.outpoint == vOutputs[i].outpoint);
+    }
+
+    //! Expect Pass: H(pk) of the outputs in the cache and in the database matches hashing the key here
+    secp256k1_pubkey hpk, hpkExpected;
+    for (size_t i : {(size_t)0, vOutputs.size() - 1}) {
+        BOOST_CHECK(db.ReadRCTOutput(i + 1, ao, hpk));
+        BOOST_CHECK(secp256k1_get_hash_to_curve(&hpkExpected, vOutputs[i].pubkey.begin()) == 0);
+        BOOST_CHECK(memcmp(hpk.data, hpkExpected.data, sizeof(hpk.data)) == 0);
+    }
+
+    //! Expect Pass: outputs added on connect are read back, erased outputs are gone
+    CAnonOutput aoNew;
+    aoNew.outpoint = COutPoint(InsecureRand256(), 0);
+    db.AddRCTOutputsToCache({{vOutputs.size() + 1, aoNew}});
+    BOOST_CHECK(db.ReadRCTOutput(vOutputs.size() + 1, ao));
+    BOOST_CHECK(ao.outpoint == aoNew.outpoint);
+    BOOST_CHECK(db.EraseRCTOutput(vOutputs.size() + 1));
+    BOOST_CHECK(db.EraseRCTOutput(vOutputs.size()));
+    BOOST_CHECK(!db.ReadRCTOutput(vOutputs.size() + 1, ao));
+    BOOST_CHECK(!db.ReadRCTOutput(vOutputs.size(), ao));
+    BOOST_CHECK(db.ReadRCTOutput(vOutputs.size() - 1, ao));
+    BOOST_CHECK(ao.outpoint == vOutputs[vOutputs.size() - 2].outpoint);
+
+    //! Expect Fail: the cache does not load over a gap in the index
+    BOOST_CHECK(!db.LoadRCTOutputCache(vOutputs.size() + 1, 4 * sizeof(CCachedAnonOutput)));
+}
+
+BOOST_AUTO_TEST_CASE(rct_keyimage_index)
+{
+    SetDataDir("rct_keyimage_index");
+    CBlockTreeDB db(1 << 20, true);
+    std::vector<std::pair<CCmpPubKey, uint256> > vKeyImages;
+    for (int i = 0; i < 8; i++) {
+        uint256 hash = InsecureRand256();
+        std::vector<unsigned char> vchKeyImage(1, i % 2 ? 0x02 : 0x03);
+        vchKeyImage.insert(vchKeyImage.end(), hash.begin(), hash.end());
+        vKeyImages.emplace_back(CCmpPubKey(vchKeyImage), InsecureRand256());
+    }
+    for (size_t i = 0; i < 4; i++)
+        BOOST_CHECK(db.WriteRCTKeyImage(vKeyImages[i].first, vKeyImages[i].second));
+
+    //! Expect Pass: the loaded index answers the same as the database
+    BOOST_CHECK(db.LoadRCTKeyImages());
+    uint256 txhash;
+    for (size_t i = 0; i < 4; i++) {
+        BOOST_CHECK(db.ReadRCTKeyImage(vKeyImages[i].first, txhash));
+        BOOST_CHECK(txhash == vKeyImages[i].second);
+    }
+    BOOST_CHECK(!db.ReadRCTKeyImage(vKeyImages[4].first, txhash));
+
+    //! Expect Pass: key images of a connected block are found, and are gone once it is disconnected
+    std::vector<std::pair<CCmpPubKey, uint256> > vConnected(vKeyImages.begin() + 4, vKeyImages.end());
+    db.AddRCTKeyImagesToIndex(vConnected);
+    for (size_t i = 4; i < vKeyImages.size(); i++) {
+        BOOST_CHECK(db.ReadRCTKeyImage(vKeyImages[i].first, txhash));
+        BOOST_CHECK(txhash == vKeyImages[i].second);
+    }
+    BOOST_CHECK(db.EraseRCTKeyImages(vConnected));
+    BOOST_CHECK(db.EraseRCTKeyImage(vKeyImages[0].first));
+    BOOST_CHECK(!db.ReadRCTKeyImage(vKeyImages[0].first, txhash));
+    for (size_t i = 4; i < vKeyImages.size(); i++)
+        BOOST_CHECK(!db.ReadRCTKeyImage(vKeyImages[i].first, txhash));
+
+    //! Expect Pass: the index reloaded from the database matches
+    BOOST_CHECK(db.LoadRCTKeyImages());
+    BOOST_CHECK(!db.ReadRCTKeyImage(vKeyImages[0].first, txhash));
+    for (size_t i = 1; i < 4; i++)
+        BOOST_CHECK(db.ReadRCTKeyImage(vKeyImages[i].first, txhash));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
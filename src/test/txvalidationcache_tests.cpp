@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <consensus/tx_verify.h>
 #include <consensus/validation.h>
 #include <key.h>
 #include <validation.h>
@@ -16,12 +17,14 @@
 #include <core_io.h>
 #include <keystore.h>
 #include <policy/policy.h>
+#include <veil/ringct/anon.h>
+#include <veil/ringct/blind.h>
 #include <veil/ringct/stealth.h>
 #include <veil/ringct/extkey.h>
 
 #include <boost/test/unit_test.hpp>
 
-bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks, bool fAnonChecks = true);
+bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks, bool fAnonChecks = true, std::vector<CMLSAGCheck> *pvAnonChecks = nullptr);
 
 BOOST_AUTO_TEST_SUITE(tx_validationcache_tests)
 
@@ -388,4 +391,43 @@ BOOST_FIXTURE_TEST_CASE(checkinputs_test, TestChain100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(rangeproof_cache, BasicTestingSetup)
+{
+    ECC_Start_Blinding();
+
+    uint256 blind = GetRandHash();
+    uint256 nonce = GetRandHash();
+    secp256k1_pedersen_commitment commitment;
+    BOOST_REQUIRE(secp256k1_pedersen_commit(secp256k1_ctx_blind, &commitment, blind.begin(), 1000, secp256k1_generator_h));
+    std::vector<uint8_t> vRangeproof(5134);
+    size_t nRangeProofLen = vRangeproof.size();
+    BOOST_REQUIRE(secp256k1_rangeproof_sign(secp256k1_ctx_blind, vRangeproof.data(), &nRangeProofLen, 0, &commitment,
+            blind.begin(), nonce.begin(), 0, 32, 1000, nullptr, 0, nullptr, 0, secp256k1_generator_h));
+    vRangeproof.resize(nRangeProofLen);
+
+    //! Expect Pass: the proof verifies, and is only cached by the check that stores it
+    uint256 hashCacheEntry = GetRangeProofCacheEntry(commitment, vRangeproof);
+    BOOST_CHECK(!IsRangeProofVerified(hashCacheEntry));
+    std::vector<CRangeProofCheck> vChecks;
+    vChecks.emplace_back(&commitment, &vRangeproof, hashCacheEntry, false);
+    BOOST_CHECK(VerifyRangeProofs(vChecks));
+    BOOST_CHECK(!IsRangeProofVerified(hashCacheEntry));
+    CRangeProofCheck check(&commitment, &vRangeproof, hashCacheEntry, true);
+    BOOST_CHECK(check());
+    BOOST_CHECK(IsRangeProofVerified(hashCacheEntry));
+
+    //! Expect Fail: a tampered proof does not verify and has an entry of its own
+    std::vector<uint8_t> vTampered = vRangeproof;
+    vTampered[vTampered.size() / 2] ^= 1;
+    uint256 hashTampered = GetRangeProofCacheEntry(commitment, vTampered);
+    BOOST_CHECK(hashTampered != hashCacheEntry);
+    vChecks.clear();
+    vChecks.emplace_back(&commitment, &vRangeproof, hashCacheEntry, false);
+    vChecks.emplace_back(&commitment, &vTampered, hashTampered, true);
+    BOOST_CHECK(!VerifyRangeProofs(vChecks));
+    BOOST_CHECK(!IsRangeProofVerified(hashTampered));
+
+    ECC_Stop_Blinding();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
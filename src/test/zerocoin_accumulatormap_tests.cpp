@@ -0,0 +1,141 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+#include <test/test_veil.h>
+#include "chain.h"
+#include "chainparams.h"
+#include "libzerocoin/Accumulator.h"
+#include "libzerocoin/Denominations.h"
+#include "streams.h"
+#include "veil/zerocoin/accumulatormap.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace libzerocoin;
+
+BOOST_FIXTURE_TEST_SUITE(zerocoin_accumulatormap_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(accumulatormap_accumulate_list)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params();
+
+    // Mix the denominations, and leave one of them unused
+    std::vector<PublicCoin> vPubcoins;
+    for (int i = 0; i < 12; i++) {
+        CoinDenomination denom = zerocoinDenomList[i % (zerocoinDenomList.size() - 1)];
+        vPubcoins.emplace_back(params, CBigNum::randKBitBignum(256), denom);
+    }
+
+    AccumulatorMap mapSerial(params);
+    for (const PublicCoin& pubcoin : vPubcoins)
+        BOOST_CHECK(mapSerial.Accumulate(pubcoin, true));
+
+    //! Expect Pass: the same accumulators and checkpoints as accumulating one by one
+    AccumulatorMap mapParallel(params);
+    BOOST_CHECK(mapParallel.Accumulate(vPubcoins, true));
+    for (const CoinDenomination denom : zerocoinDenomList)
+        BOOST_CHECK(mapParallel.GetValue(denom) == mapSerial.GetValue(denom));
+    BOOST_CHECK(mapParallel.GetCheckpoints(true) == mapSerial.GetCheckpoints(true));
+    BOOST_CHECK(mapParallel.GetCheckpoints(true).at(zerocoinDenomList.back()) == uint256());
+
+    //! Expect Pass: a list with a single denomination, and an empty list
+    AccumulatorMap mapSingle(params);
+    BOOST_CHECK(mapSingle.Accumulate(std::vector<PublicCoin>(1, vPubcoins[0]), true));
+    BOOST_CHECK(mapSingle.Accumulate(std::vector<PublicCoin>(), true));
+    BOOST_CHECK(mapSingle.GetValue(vPubcoins[0].getDenomination()) != AccumulatorMap(params).GetValue(vPubcoins[0].getDenomination()));
+
+    //! Expect Fail: the random values are not valid coins
+    AccumulatorMap mapValidated(params);
+    BOOST_CHECK(!mapValidated.Accumulate(vPubcoins, false));
+}
+
+BOOST_AUTO_TEST_CASE(accumulate_all_but_one)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params();
+    Accumulator base(params, CoinDenomination::ZQ_TEN);
+
+    for (unsigned int nValues : {1, 2, 5, 8}) {
+        std::vector<CBigNum> vValues;
+        for (unsigned int i = 0; i < nValues; i++)
+            vValues.emplace_back(CBigNum::randKBitBignum(256));
+
+        //! Expect Pass: every result is the accumulator of all the other values
+        std::vector<CBigNum> vWitnesses = AccumulateAllButOne(&params->accumulatorParams, base.getValue(), vValues);
+        BOOST_CHECK_EQUAL(vWitnesses.size(), vValues.size());
+        for (unsigned int i = 0; i < nValues; i++) {
+            Accumulator accumulator(base);
+            for (unsigned int j = 0; j < nValues; j++) {
+                if (j != i)
+                    accumulator.increment(vValues[j]);
+            }
+            BOOST_CHECK(vWitnesses[i] == accumulator.getValue());
+        }
+    }
+
+    BOOST_CHECK(AccumulateAllButOne(&params->accumulatorParams, base.getValue(), std::vector<CBigNum>()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(chain_mint_counts)
+{
+    // Link a chain of blocks that mint a varying number of each denomination
+    std::vector<CBlockIndex> vBlocks(50);
+    for (size_t i = 0; i < vBlocks.size(); i++) {
+        vBlocks[i].nHeight = i;
+        vBlocks[i].pprev = i ? &vBlocks[i - 1] : nullptr;
+        for (size_t j = 0; j < i % 7; j++)
+            vBlocks[i].nMintsInBlock[(i + j) % zerocoinDenomList.size()]++;
+        vBlocks[i].SetChainMints();
+    }
+
+    //! Expect Pass: the running counts match counting the mints of each block
+    for (const CoinDenomination denom : zerocoinDenomList) {
+        int64_t nMints = 0;
+        for (const CBlockIndex& block : vBlocks) {
+            nMints += block.GetBlockMints(denom);
+            BOOST_CHECK_EQUAL(block.GetChainMints(denom), nMints);
+        }
+    }
+    BOOST_CHECK_EQUAL(vBlocks.back().GetChainMints(ZQ_ERROR), 0);
+}
+
+BOOST_AUTO_TEST_CASE(diskblockindex_zerocoin_format)
+{
+    std::map<CoinDenomination, uint256> mapAccumulatorHashes;
+    std::map<CoinDenomination, int64_t> mapZerocoinSupply;
+    std::vector<CoinDenomination> vMintDenominationsInBlock;
+    for (size_t i = 0; i < zerocoinDenomList.size(); i++) {
+        CoinDenomination denom = zerocoinDenomList[i];
+        mapAccumulatorHashes[denom] = GetRandHash();
+        mapZerocoinSupply[denom] = 100 * i + 7;
+        vMintDenominationsInBlock.insert(vMintDenominationsInBlock.end(), i + 1, denom);
+    }
+
+    CBlockIndex index;
+    index.SetAccumulatorHashes(mapAccumulatorHashes);
+    for (size_t i = 0; i < zerocoinDenomList.size(); i++) {
+        index.nZerocoinSupply[i] = mapZerocoinSupply.at(zerocoinDenomList[i]);
+        index.nMintsInBlock[i] = i + 1;
+    }
+
+    //! Expect Pass: the zerocoin fields are written in the format of the maps and the vector
+    CDataStream ssDisk(SER_DISK, PROTOCOL_VERSION);
+    ssDisk << CDiskBlockIndex(&index);
+    CDataStream ssFields(SER_DISK, PROTOCOL_VERSION);
+    ssFields << mapAccumulatorHashes << mapZerocoinSupply << vMintDenominationsInBlock << index.fProofOfFullNode
+             << index.fProofOfStake << index.nAnonOutputs;
+    BOOST_REQUIRE(ssDisk.size() > ssFields.size());
+    BOOST_CHECK(std::equal(ssFields.begin(), ssFields.end(), ssDisk.end() - ssFields.size()));
+
+    //! Expect Pass: reading it back gives the same fields, and the checkpoint is shared instead of copied
+    CDiskBlockIndex diskindex;
+    ssDisk >> diskindex;
+    BOOST_CHECK(diskindex.GetAccumulatorHashes() == mapAccumulatorHashes);
+    BOOST_CHECK(diskindex.pmapAccumulatorHashes == index.pmapAccumulatorHashes);
+    for (const CoinDenomination denom : zerocoinDenomList) {
+        BOOST_CHECK_EQUAL(diskindex.GetZerocoinSupply(denom), mapZerocoinSupply.at(denom));
+        BOOST_CHECK_EQUAL(diskindex.GetBlockMints(denom), index.GetBlockMints(denom));
+    }
+    BOOST_CHECK_EQUAL(diskindex.GetZerocoinSupply(), index.GetZerocoinSupply());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+#include <test/test_veil.h>
+#include "libzerocoin/Accumulator.h"
+#include "libzerocoin/AccumulatorProofOfKnowledge.h"
+#include "libzerocoin/CoinSpend.h"
+#include "libzerocoin/Denominations.h"
+#include "libzerocoin/bignum.h"
+#include "streams.h"
+#include "validation.h"
+#include "veil/zerocoin/zchain.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+
+using namespace libzerocoin;
+
+BOOST_FIXTURE_TEST_SUITE(zerocoin_batchverify_tests, BasicTestingSetup)
+
+std::string zerocoinModulus = "25195908475657893494027183240048398571429282126204032027777137836043662020707595556264018525880784"
+                              "4069182906412495150821892985591491761845028084891200728449926873928072877767359714183472702618963750149718246911"
+                              "6507761337985909570009733045974880842840179742910064245869181719511874612151517265463228221686998754918242243363"
+                              "7259085141865462043576798423387184774447920739934236584823824281198163815010674810451660377306056201619676256133"
+                              "8441436038339044149526344321901146575444541784240209246165157233507787077498171257724679629263863563732899121548"
+                              "31438167899885040445364023527381951378636564391212010397122822120720357";
+
+BOOST_AUTO_TEST_CASE(batchverify_spend_proofs)
+{
+    CBigNum bnTrustedModulus;
+    bnTrustedModulus.SetDec(zerocoinModulus);
+    ZerocoinParams params(bnTrustedModulus);
+
+    // Accumulate a few coins on top of an empty checkpoint
+    const int nCoins = 3;
+    std::vector<PrivateCoin> vCoins;
+    Accumulator checkpoint(&params, CoinDenomination::ZQ_TEN);
+    Accumulator accumulator(&params, CoinDenomination::ZQ_TEN);
+    for (int i = 0; i < nCoins; i++) {
+        vCoins.emplace_back(&params, CoinDenomination::ZQ_TEN, true);
+        accumulator += vCoins.back().getPublicCoin();
+    }
+
+    // Spend all of them against the same accumulator
+    std::vector<std::shared_ptr<CoinSpend>> vSpendsOwned;
+    std::vector<const CoinSpend*> vSpends;
+    uint256 checksum = GetRandHash();
+    for (const PrivateCoin& coin : vCoins) {
+        AccumulatorWitness witness(&params, checkpoint, coin.getPublicCoin());
+        for (const PrivateCoin& other : vCoins)
+            witness.AddElement(other.getPublicCoin());
+        vSpendsOwned.emplace_back(std::make_shared<CoinSpend>(&params, coin, accumulator, checksum, witness, GetRandHash(), SpendType::SPEND));
+        vSpends.emplace_back(vSpendsOwned.back().get());
+    }
+
+    //! Expect Pass: the batch agrees with verifying each spend on its own
+    std::string strError;
+    for (const CoinSpend* spend : vSpends)
+        BOOST_CHECK(spend->Verify(accumulator, strError, false, false));
+    BOOST_CHECK_MESSAGE(CoinSpend::BatchVerify(accumulator, vSpends, strError), strError);
+    BOOST_CHECK(CoinSpend::BatchVerify(accumulator, std::vector<const CoinSpend*>(1, vSpends[0]), strError));
+    BOOST_CHECK(CoinSpend::BatchVerify(accumulator, std::vector<const CoinSpend*>(), strError));
+
+    //! Expect Fail: accumulator that does not contain the coins
+    BOOST_CHECK(!CoinSpend::BatchVerify(checkpoint, vSpends, strError));
+
+    //! Expect Fail: accumulator of another denomination
+    Accumulator accumulatorOther(&params, CoinDenomination::ZQ_ONE_HUNDRED);
+    BOOST_CHECK(!CoinSpend::BatchVerify(accumulatorOther, vSpends, strError));
+}
+
+BOOST_AUTO_TEST_CASE(batchverify_small_order)
+{
+    CBigNum bnTrustedModulus;
+    bnTrustedModulus.SetDec(zerocoinModulus);
+    ZerocoinParams params(bnTrustedModulus);
+    const AccumulatorAndProofParams* accParams = &params.accumulatorParams;
+
+    PrivateCoin coin(&params, CoinDenomination::ZQ_TEN, true);
+    Accumulator checkpoint(&params, CoinDenomination::ZQ_TEN);
+    Accumulator accumulator(&params, CoinDenomination::ZQ_TEN);
+    accumulator += coin.getPublicCoin();
+    AccumulatorWitness witness(&params, checkpoint, coin.getPublicCoin());
+    witness.AddElement(coin.getPublicCoin());
+
+    Commitment commitment(&accParams->accumulatorPoKCommitmentGroup, coin.getPublicCoin().getValue());
+    const CBigNum& V = commitment.getCommitmentValue();
+    AccumulatorProofOfKnowledge proof(accParams, commitment, witness, accumulator);
+
+    // Copy of the proof with one of its values changed by fChange, in serialization order
+    auto fModify = [&proof, accParams](int nField, std::function<CBigNum(const CBigNum&)> fChange) {
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        ss << proof;
+        std::vector<CBigNum> vFields(21);
+        for (CBigNum& field : vFields)
+            ss >> field;
+        vFields[nField] = fChange(vFields[nField]);
+        for (const CBigNum& field : vFields)
+            ss << field;
+        AccumulatorProofOfKnowledge modified(accParams);
+        ss >> modified;
+        return modified;
+    };
+    const CBigNum& p = accParams->accumulatorPoKCommitmentGroup.modulus;
+    const CBigNum& N = accParams->accumulatorModulus;
+
+    //! Expect Pass: valid proof
+    BOOST_CHECK(proof.Verify(accumulator, V));
+    BOOST_CHECK(AccumulatorProofOfKnowledge::BatchVerify(accumulator, {std::make_pair(&proof, &V)}));
+
+    // Values of small order or out of range, in both groups, next to a valid proof
+    std::vector<AccumulatorProofOfKnowledge> vModified;
+    vModified.push_back(fModify(3, [&p](const CBigNum& x) { return p - x; })); // st_1 * -1 mod p
+    vModified.push_back(fModify(4, [&p](const CBigNum& x) { return x + p; })); // st_2 unreduced
+    vModified.push_back(fModify(6, [&N](const CBigNum& x) { return N - x; })); // t_1 * -1 mod N
+    vModified.push_back(fModify(7, [&N](const CBigNum& x) { return x + N; })); // t_2 unreduced
+    vModified.push_back(fModify(0, [&N](const CBigNum& x) { return N - x; })); // C_e * -1 mod N
+
+    //! Expect the answer of Verify, on every run
+    for (const AccumulatorProofOfKnowledge& modified : vModified) {
+        bool fValid = modified.Verify(accumulator, V);
+        BOOST_CHECK(!fValid);
+        for (int i = 0; i < 16; i++) {
+            BOOST_CHECK_EQUAL(AccumulatorProofOfKnowledge::BatchVerify(accumulator, {std::make_pair(&modified, &V)}), fValid);
+            BOOST_CHECK_EQUAL(AccumulatorProofOfKnowledge::BatchVerify(accumulator, {std::make_pair(&proof, &V), std::make_pair(&modified, &V)}), fValid);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(prepared_spend_sign)
+{
+    CBigNum bnTrustedModulus;
+    bnTrustedModulus.SetDec(zerocoinModulus);
+    ZerocoinParams params(bnTrustedModulus);
+
+    PrivateCoin coin(&params, CoinDenomination::ZQ_TEN, true);
+    Accumulator checkpoint(&params, CoinDenomination::ZQ_TEN);
+    Accumulator accumulator(&params, CoinDenomination::ZQ_TEN);
+    accumulator += coin.getPublicCoin();
+    AccumulatorWitness witness(&params, checkpoint, coin.getPublicCoin());
+    witness.AddElement(coin.getPublicCoin());
+
+    //! Expect Pass: a spend prepared without the transaction hash verifies once it is signed
+    uint256 ptxHash = GetRandHash();
+    CoinSpend spend(&params, coin, accumulator, GetRandHash(), witness, SpendType::STAKE);
+    CoinSpend spendCopy = spend;
+    spend.Sign(coin, ptxHash);
+    std::string strError;
+    BOOST_CHECK_MESSAGE(spend.Verify(accumulator, strError), strError);
+    BOOST_CHECK(spend.getTxOutHash() == ptxHash);
+    BOOST_CHECK(spend.HasValidSignature());
+
+    //! Expect Fail: the commitments of the SoK are used only once, also through a copy of the spend
+    BOOST_CHECK_THROW(spend.Sign(coin, GetRandHash()), std::runtime_error);
+    BOOST_CHECK_THROW(spendCopy.Sign(coin, GetRandHash()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(threaded_create_spends)
+{
+    CBigNum bnTrustedModulus;
+    bnTrustedModulus.SetDec(zerocoinModulus);
+    ZerocoinParams params(bnTrustedModulus);
+
+    const int nCoins = 3;
+    std::vector<PrivateCoin> vCoins;
+    Accumulator checkpoint(&params, CoinDenomination::ZQ_TEN);
+    Accumulator accumulator(&params, CoinDenomination::ZQ_TEN);
+    for (int i = 0; i < nCoins; i++) {
+        vCoins.emplace_back(&params, CoinDenomination::ZQ_TEN, true);
+        accumulator += vCoins.back().getPublicCoin();
+    }
+
+    std::vector<Accumulator> vAccumulators(nCoins, accumulator);
+    std::vector<AccumulatorWitness> vWitnesses;
+    for (const PrivateCoin& coin : vCoins) {
+        vWitnesses.emplace_back(&params, checkpoint, coin.getPublicCoin());
+        for (const PrivateCoin& other : vCoins)
+            vWitnesses.back().AddElement(other.getPublicCoin());
+    }
+
+    std::vector<CoinSpendJob> vJobs(nCoins);
+    for (int i = 0; i < nCoins; i++) {
+        vJobs[i].coin = &vCoins[i];
+        vJobs[i].accumulator = &vAccumulators[i];
+        vJobs[i].nChecksum = GetRandHash();
+        vJobs[i].witness = &vWitnesses[i];
+    }
+
+    //! Expect Pass: every spend is built, bound to the transaction hash and reported as done
+    uint256 ptxHash = GetRandHash();
+    size_t nProgress = 0;
+    BOOST_CHECK(ThreadedCreateCoinSpends(&params, vJobs, ptxHash, 2, [&](size_t nDone) { nProgress = nDone; }));
+    BOOST_CHECK_EQUAL(nProgress, (size_t)nCoins);
+    std::string strError;
+    for (int i = 0; i < nCoins; i++) {
+        BOOST_REQUIRE(vJobs[i].spend);
+        BOOST_CHECK(vJobs[i].spend->getTxOutHash() == ptxHash);
+        BOOST_CHECK(vJobs[i].spend->getCoinSerialNumber() == vCoins[i].getSerialNumber());
+        BOOST_CHECK(vJobs[i].spend->Verify(accumulator, strError));
+    }
+
+    //! Expect Fail: a witness of another coin fails its own job only
+    for (CoinSpendJob& job : vJobs)
+        job.spend.reset();
+    vJobs[1].witness = &vWitnesses[0];
+    BOOST_CHECK(!ThreadedCreateCoinSpends(&params, vJobs, ptxHash, 2));
+    BOOST_CHECK(vJobs[0].spend && vJobs[2].spend);
+    BOOST_CHECK(!vJobs[1].spend);
+    BOOST_CHECK(!vJobs[1].strError.empty());
+}
+
+BOOST_AUTO_TEST_CASE(zerocoin_proof_cache)
+{
+    uint256 txid = GetRandHash();
+    BOOST_CHECK(!IsZerocoinProofVerified(txid));
+
+    //! Expect Pass: the entry is found, also by the lookup that marks it as erased
+    SetZerocoinProofVerified(txid);
+    BOOST_CHECK(IsZerocoinProofVerified(txid));
+    BOOST_CHECK(IsZerocoinProofVerified(txid, /*fErase*/true));
+    BOOST_CHECK(!IsZerocoinProofVerified(GetRandHash()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,7 @@
 #include "util.h"
 #include "utilstrencodings.h"
 #include "libzerocoin/bignum.h"
+#include "libzerocoin/FixedBase.h"
 
 using namespace libzerocoin;
 
@@ -86,4 +87,100 @@ BOOST_AUTO_TEST_CASE(bignum_random_generation_tests)
     }
 }
 
+BOOST_AUTO_TEST_CASE(bignum_move_tests)
+{
+    CBigNum m;
+    m.SetHex(strHexModulus);
+    const CBigNum a = CBigNum::randBignum(m);
+
+    // Moved from numbers stay usable
+    CBigNum b(a);
+    CBigNum c(std::move(b));
+    BOOST_CHECK(c == a);
+    b = 7;
+    BOOST_CHECK(b == CBigNum(7));
+    b = std::move(c);
+    BOOST_CHECK(b == a);
+    c = b + CBigNum(1);
+    BOOST_CHECK(c == a + CBigNum(1));
+
+    std::vector<CBigNum> v(4, a);
+    v.reserve(64);
+    BOOST_CHECK(v.size() == 4 && v[3] == a);
+
+    // In place reduction matches operator%, including for negative numbers
+    CBigNum d = a * a;
+    d %= m;
+    BOOST_CHECK(d == (a * a) % m);
+    BOOST_CHECK(d == a.mul_mod(a, m));
+    d = -a;
+    d %= m;
+    BOOST_CHECK(d == (-a) % m);
+}
+
+BOOST_AUTO_TEST_CASE(bignum_multi_pow_mod_tests)
+{
+    CBigNum m;
+    m.SetHex(strHexModulus);
+
+    // Compare against the product of single exponentiations, for several sizes and exponent lengths
+    for (unsigned int nBases : {0, 1, 2, 7, 33}) {
+        for (int nBits : {1, 16, 160, 256, 1024}) {
+            std::vector<CBigNum> bases, exps;
+            CBigNum expected = 1;
+            for (unsigned int i = 0; i < nBases; i++) {
+                bases.emplace_back(CBigNum::randBignum(m));
+                exps.emplace_back(CBigNum::randKBitBignum(nBits));
+                if (i % 3 == 1)
+                    exps.back() = -exps.back();
+                if (i % 5 == 4)
+                    exps.back() = 0;
+                expected = expected.mul_mod(bases.back().pow_mod(exps.back(), m), m);
+            }
+            BOOST_CHECK_MESSAGE(CBigNum::multi_pow_mod(bases, exps, m) == expected,
+                    strprintf("CBigNum::multi_pow_mod failed with %u bases of %d bits", nBases, nBits));
+        }
+    }
+
+    std::vector<CBigNum> bases(2, CBigNum(3));
+    std::vector<CBigNum> exps(1, CBigNum(3));
+    BOOST_CHECK_THROW(CBigNum::multi_pow_mod(bases, exps, m), bignum_error);
+}
+
+BOOST_AUTO_TEST_CASE(bignum_fixed_base_tests)
+{
+    CBigNum m;
+    m.SetHex(strHexModulus);
+    CBigNum base = CBigNum::randBignum(m);
+
+    FixedBaseTable table(base, m, 256);
+    for (int nBits : {1, 4, 5, 64, 255, 256}) {
+        CBigNum e = CBigNum::randKBitBignum(nBits);
+        BOOST_CHECK_MESSAGE(table.pow_mod(e) == base.pow_mod(e, m), strprintf("FixedBaseTable::pow_mod failed with %d bits", nBits));
+    }
+    BOOST_CHECK(table.pow_mod(CBigNum(0)) == CBigNum(1));
+    BOOST_CHECK_THROW(table.pow_mod(CBigNum(-1)), std::runtime_error);
+    BOOST_CHECK_THROW(table.pow_mod(CBigNum(2).pow(256)), std::runtime_error);
+
+    // A registered generator of the multiplicative group mod a prime reduces its exponents by the group order
+    CBigNum p = CBigNum::generatePrime(256);
+    CBigNum g = CBigNum::randBignum(p);
+    CBigNum other = CBigNum::randBignum(p);
+    FixedBaseCache cache;
+    cache.Register(g, p, p - 1);
+    CBigNum result;
+    for (CBigNum e : {CBigNum(0), CBigNum(7), CBigNum::randKBitBignum(400), -CBigNum::randKBitBignum(200)}) {
+        BOOST_CHECK(cache.pow_mod(g, e, p, result));
+        BOOST_CHECK(result == g.pow_mod(e, p));
+        BOOST_CHECK(!cache.pow_mod(other, e, p, result));
+    }
+    BOOST_CHECK(cache.MemoryUsage() == FixedBaseTable::EstimateMemoryUsage(p, (p - 1).bitSize()));
+
+    // Without budget no table is built
+    FixedBaseCache emptyCache(0);
+    emptyCache.Register(g, p, p - 1);
+    BOOST_CHECK(!emptyCache.pow_mod(g, CBigNum(12345), p, result));
+    BOOST_CHECK(emptyCache.MemoryUsage() == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
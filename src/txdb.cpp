@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <boost/thread.hpp>
+#include <secp256k1_mlsag.h>
 #include <primitives/zerocoin.h>
 
 static const char DB_COIN = 'C';
@@ -154,6 +155,9 @@ size_t CCoinsViewDB::EstimateSize() const
 }
 
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(gArgs.IsArgSet("-blocksdir") ? GetDataDir() / "blocks" / "index" : GetBlocksDir() / "index", nCacheSize, fMemory, fWipe) {
+    nFirstCachedRCTOutput = 0;
+    nMaxCachedRCTOutputs = 0;
+    fRCTKeyImagesLoaded = false;
 }
 
 bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
@@ -307,9 +311,9 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->nAnonOutputs             = diskindex.nAnonOutputs;
 
                 // zerocoin
-                pindexNew->mapAccumulatorHashes = diskindex.mapAccumulatorHashes;
-                pindexNew->mapZerocoinSupply = diskindex.mapZerocoinSupply;
-                pindexNew->vMintDenominationsInBlock = diskindex.vMintDenominationsInBlock;
+                pindexNew->pmapAccumulatorHashes = diskindex.pmapAccumulatorHashes;
+                std::copy(std::begin(diskindex.nZerocoinSupply), std::end(diskindex.nZerocoinSupply), pindexNew->nZerocoinSupply);
+                std::copy(std::begin(diskindex.nMintsInBlock), std::end(diskindex.nMintsInBlock), pindexNew->nMintsInBlock);
 
 //                if (pindexNew->IsProofOfWork() && !CheckProofOfWork(pindexNew->GetBlockPoWHash(), pindexNew->nBits, consensusParams))
 //                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
@@ -326,20 +330,119 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
     return true;
 }
 
+void CBlockTreeDB::CacheRCTOutput(int64_t i, const CAnonOutput &ao)
+{
+    if (nMaxCachedRCTOutputs == 0)
+        return;
+
+    CCachedAnonOutput entry;
+    entry.ao = ao;
+    if (0 != secp256k1_get_hash_to_curve(&entry.hpk, ao.pubkey.begin())) {
+        UncacheRCTOutputs(i);
+        return;
+    }
+
+    int64_t nEnd = nFirstCachedRCTOutput + dequeRCTOutputs.size();
+    if (i >= nFirstCachedRCTOutput && i < nEnd) {
+        dequeRCTOutputs[i - nFirstCachedRCTOutput] = entry;
+        return;
+    }
+
+    // Anything but the next output leaves a gap, so the window starts over from it
+    if (dequeRCTOutputs.empty() || i != nEnd) {
+        dequeRCTOutputs.clear();
+        nFirstCachedRCTOutput = i;
+    }
+    dequeRCTOutputs.push_back(entry);
+    if (dequeRCTOutputs.size() > nMaxCachedRCTOutputs) {
+        dequeRCTOutputs.pop_front();
+        nFirstCachedRCTOutput++;
+    }
+}
+
+void CBlockTreeDB::UncacheRCTOutputs(int64_t nFrom)
+{
+    if (nFrom <= nFirstCachedRCTOutput)
+        dequeRCTOutputs.clear();
+    else if (nFrom < nFirstCachedRCTOutput + (int64_t)dequeRCTOutputs.size())
+        dequeRCTOutputs.resize(nFrom - nFirstCachedRCTOutput);
+}
+
+bool CBlockTreeDB::LoadRCTOutputCache(int64_t nLastRCTOutput, size_t nMaxUsage)
+{
+    int64_t nTimeStart = GetTimeMillis();
+    LOCK(cs_rctOutputCache);
+    dequeRCTOutputs.clear();
+    nMaxCachedRCTOutputs = nMaxUsage / sizeof(CCachedAnonOutput);
+
+    // Outputs are numbered from 1
+    int64_t nStart = std::max((int64_t)1, nLastRCTOutput - (int64_t)nMaxCachedRCTOutputs + 1);
+    nFirstCachedRCTOutput = nStart;
+    for (int64_t i = nStart; i <= nLastRCTOutput; i++) {
+        CAnonOutput ao;
+        if (!Read(std::make_pair(DB_RCTOUTPUT, i), ao)) {
+            dequeRCTOutputs.clear();
+            return error("%s: anon output %d is missing", __func__, i);
+        }
+        CacheRCTOutput(i, ao);
+    }
+
+    LogPrintf("%s: cached %u anon outputs in %dms\n", __func__, dequeRCTOutputs.size(), GetTimeMillis() - nTimeStart);
+    return true;
+}
+
+void CBlockTreeDB::AddRCTOutputsToCache(const std::vector<std::pair<int64_t, CAnonOutput> > &vOutputs)
+{
+    LOCK(cs_rctOutputCache);
+    for (const auto &it : vOutputs)
+        CacheRCTOutput(it.first, it.second);
+}
+
 bool CBlockTreeDB::ReadRCTOutput(int64_t i, CAnonOutput &ao)
 {
+    {
+        LOCK(cs_rctOutputCache);
+        if (i >= nFirstCachedRCTOutput && i < nFirstCachedRCTOutput + (int64_t)dequeRCTOutputs.size()) {
+            ao = dequeRCTOutputs[i - nFirstCachedRCTOutput].ao;
+            return true;
+        }
+    }
     return Read(std::make_pair(DB_RCTOUTPUT, i), ao);
 };
 
+bool CBlockTreeDB::ReadRCTOutput(int64_t i, CAnonOutput &ao, secp256k1_pubkey &hpk)
+{
+    {
+        LOCK(cs_rctOutputCache);
+        if (i >= nFirstCachedRCTOutput && i < nFirstCachedRCTOutput + (int64_t)dequeRCTOutputs.size()) {
+            const CCachedAnonOutput &entry = dequeRCTOutputs[i - nFirstCachedRCTOutput];
+            ao = entry.ao;
+            hpk = entry.hpk;
+            return true;
+        }
+    }
+    return Read(std::make_pair(DB_RCTOUTPUT, i), ao) && secp256k1_get_hash_to_curve(&hpk, ao.pubkey.begin()) == 0;
+};
+
 bool CBlockTreeDB::WriteRCTOutput(int64_t i, const CAnonOutput &ao)
 {
     CDBBatch batch(*this);
     batch.Write(std::make_pair(DB_RCTOUTPUT, i), ao);
-    return WriteBatch(batch);
+    if (!WriteBatch(batch))
+        return false;
+
+    LOCK(cs_rctOutputCache);
+    CacheRCTOutput(i, ao);
+    return true;
 };
 
 bool CBlockTreeDB::EraseRCTOutput(int64_t i)
 {
+    // Outputs are erased from the top of the index, so everything from i on leaves the cache
+    {
+        LOCK(cs_rctOutputCache);
+        UncacheRCTOutputs(i);
+    }
     CDBBatch batch(*this);
     batch.Erase(std::make_pair(DB_RCTOUTPUT, i));
     return WriteBatch(batch);
@@ -365,23 +468,121 @@ bool CBlockTreeDB::EraseRCTOutputLink(const CCmpPubKey &pk)
     return WriteBatch(batch);
 };
 
+// Starting size of the key image filter, it doubles when it fills up
+static const size_t RCT_KEYIMAGE_FILTER_MIN_ELEMENTS = 1 << 16;
+
+static uint256 KeyImageFilterKey(const CCmpPubKey &ki)
+{
+    // The x coordinate, the parity byte only makes a match more likely
+    uint256 x;
+    memcpy(x.begin(), ki.begin() + 1, 32);
+    return x;
+}
+
+bool CBlockTreeDB::LoadRCTKeyImages()
+{
+    int64_t nTimeStart = GetTimeMillis();
+    LOCK(cs_rctKeyImages);
+    fRCTKeyImagesLoaded = false;
+    mapRCTKeyImages.clear();
+
+    try {
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        pcursor->Seek(std::make_pair(DB_RCTKEYIMAGE, CCmpPubKey()));
+        while (pcursor->Valid()) {
+            boost::this_thread::interruption_point();
+            std::pair<char, CCmpPubKey> key;
+            if (!pcursor->GetKey(key) || key.first != DB_RCTKEYIMAGE)
+                break;
+
+            uint256 txhash;
+            if (!pcursor->GetValue(txhash)) {
+                mapRCTKeyImages.clear();
+                return error("%s: failed to read key image", __func__);
+            }
+            mapRCTKeyImages[key.second] = txhash;
+            pcursor->Next();
+        }
+    } catch (const std::exception& e) {
+        mapRCTKeyImages.clear();
+        return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+    }
+
+    filterRCTKeyImages.Reset(std::max(2 * mapRCTKeyImages.size(), RCT_KEYIMAGE_FILTER_MIN_ELEMENTS));
+    for (const auto &it : mapRCTKeyImages)
+        filterRCTKeyImages.insert(KeyImageFilterKey(it.first));
+    fRCTKeyImagesLoaded = true;
+
+    LogPrintf("%s: %u key images loaded in %dms, %u bytes\n", __func__, mapRCTKeyImages.size(), GetTimeMillis() - nTimeStart,
+            memusage::DynamicUsage(mapRCTKeyImages) + filterRCTKeyImages.DynamicMemoryUsage());
+    return true;
+}
+
+// The key images are indexed before they are written, so that a concurrent read never misses one that is in the database
+void CBlockTreeDB::AddRCTKeyImagesToIndex(const std::vector<std::pair<CCmpPubKey, uint256> > &vKeyImages)
+{
+    LOCK(cs_rctKeyImages);
+    if (!fRCTKeyImagesLoaded)
+        return;
+
+    // Erased key images stay in the filter, so it is rebuilt from the map when it fills up
+    if (filterRCTKeyImages.size() + vKeyImages.size() > filterRCTKeyImages.capacity()) {
+        filterRCTKeyImages.Reset(2 * (mapRCTKeyImages.size() + vKeyImages.size()));
+        for (const auto &it : mapRCTKeyImages)
+            filterRCTKeyImages.insert(KeyImageFilterKey(it.first));
+    }
+
+    for (const auto &it : vKeyImages) {
+        filterRCTKeyImages.insert(KeyImageFilterKey(it.first));
+        mapRCTKeyImages[it.first] = it.second;
+    }
+}
+
 bool CBlockTreeDB::ReadRCTKeyImage(const CCmpPubKey &ki, uint256 &txhash)
 {
+    {
+        LOCK(cs_rctKeyImages);
+        if (fRCTKeyImagesLoaded) {
+            if (!filterRCTKeyImages.contains(KeyImageFilterKey(ki)))
+                return false;
+
+            auto mi = mapRCTKeyImages.find(ki);
+            if (mi == mapRCTKeyImages.end())
+                return false;
+
+            txhash = mi->second;
+            return true;
+        }
+    }
     return Read(std::make_pair(DB_RCTKEYIMAGE, ki), txhash);
 };
 
 bool CBlockTreeDB::WriteRCTKeyImage(const CCmpPubKey &ki, const uint256 &txhash)
 {
+    AddRCTKeyImagesToIndex(std::vector<std::pair<CCmpPubKey, uint256> >(1, std::make_pair(ki, txhash)));
+
     CDBBatch batch(*this);
     batch.Write(std::make_pair(DB_RCTKEYIMAGE, ki), txhash);
     return WriteBatch(batch);
 };
 
 bool CBlockTreeDB::EraseRCTKeyImage(const CCmpPubKey &ki)
+{
+    return EraseRCTKeyImages(std::vector<std::pair<CCmpPubKey, uint256> >(1, std::make_pair(ki, uint256())));
+};
+
+bool CBlockTreeDB::EraseRCTKeyImages(const std::vector<std::pair<CCmpPubKey, uint256> > &vKeyImages)
 {
     CDBBatch batch(*this);
-    batch.Erase(std::make_pair(DB_RCTKEYIMAGE, ki));
-    return WriteBatch(batch);
+    for (const auto &it : vKeyImages)
+        batch.Erase(std::make_pair(DB_RCTKEYIMAGE, it.first));
+    if (!WriteBatch(batch))
+        return false;
+
+    LOCK(cs_rctKeyImages);
+    for (const auto &it : vKeyImages)
+        mapRCTKeyImages.erase(it.first);
+    return true;
 };
 
 namespace {
@@ -507,8 +708,85 @@ bool CCoinsViewDB::Upgrade() {
     return !ShutdownRequested();
 }
 
+// Starting size of the spend and mint filters, they double when they fill up
+static const size_t ZEROCOIN_FILTER_MIN_ELEMENTS = 1 << 16;
+
 CZerocoinDB::CZerocoinDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "zerocoin", nCacheSize, fMemory, fWipe)
 {
+    fFiltersLoaded = false;
+}
+
+bool CZerocoinDB::LoadFilter(char chType, CBlockedBloomFilter& filter, size_t nElements)
+{
+    filter.Reset(std::max(nElements, ZEROCOIN_FILTER_MIN_ELEMENTS));
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(chType, uint256()));
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, uint256> key;
+        if (!pcursor->GetKey(key) || key.first != chType)
+            break;
+
+        // Start over at twice the size if the filter is too small for all of the keys
+        if (filter.size() >= filter.capacity()) {
+            filter.Reset(2 * filter.capacity());
+            pcursor->Seek(std::make_pair(chType, uint256()));
+            continue;
+        }
+        filter.insert(key.second);
+        pcursor->Next();
+    }
+    return true;
+}
+
+bool CZerocoinDB::LoadFilters()
+{
+    int64_t nTimeStart = GetTimeMillis();
+    LOCK(cs_filters);
+    fFiltersLoaded = false;
+    try {
+        if (!LoadFilter('s', filterSpends, 0) || !LoadFilter('m', filterMints, 0))
+            return false;
+    } catch (const std::exception& e) {
+        return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+    }
+    fFiltersLoaded = true;
+
+    LogPrintf("%s: %u spends and %u mints loaded in %dms, %u bytes\n", __func__, filterSpends.size(), filterMints.size(),
+            GetTimeMillis() - nTimeStart, filterSpends.DynamicMemoryUsage() + filterMints.DynamicMemoryUsage());
+    return true;
+}
+
+// The hashes are added before they are written, so that a concurrent read never misses one that is in the database
+void CZerocoinDB::AddToFilter(char chType, CBlockedBloomFilter& filter, const std::vector<uint256>& vHashes)
+{
+    LOCK(cs_filters);
+    if (!fFiltersLoaded)
+        return;
+
+    if (filter.size() + vHashes.size() > filter.capacity()) {
+        bool fLoaded;
+        try {
+            fLoaded = LoadFilter(chType, filter, 2 * (filter.size() + vHashes.size()));
+        } catch (const std::exception& e) {
+            fLoaded = error("%s : Deserialize or I/O error - %s", __func__, e.what());
+        }
+        if (!fLoaded) {
+            // Reads go to the database again until the filters are loaded
+            fFiltersLoaded = false;
+            return;
+        }
+    }
+
+    for (const uint256& hash : vHashes)
+        filter.insert(hash);
+}
+
+bool CZerocoinDB::FilterContains(const CBlockedBloomFilter& filter, const uint256& hash)
+{
+    LOCK(cs_filters);
+    return !fFiltersLoaded || filter.contains(hash);
 }
 
 //TODO: add prefixes for zerocoindb to the top of the file insteadof using chars when doing database operations
@@ -516,12 +794,15 @@ bool CZerocoinDB::WriteCoinMintBatch(const std::map<libzerocoin::PublicCoin, uin
 {
     CDBBatch batch(*this);
     size_t count = 0;
+    std::vector<uint256> vHashes;
     for (auto it=mintInfo.begin(); it != mintInfo.end(); it++) {
         libzerocoin::PublicCoin pubCoin = it->first;
         uint256 hash = GetPubCoinHash(pubCoin.getValue());
         batch.Write(std::make_pair('m', hash), it->second);
+        vHashes.emplace_back(hash);
         ++count;
     }
+    AddToFilter('m', filterMints, vHashes);
 
     LogPrint(BCLog::ZEROCOINDB, "Writing %u coin mints to db.\n", (unsigned int)count);
     return WriteBatch(batch, true);
@@ -534,6 +815,8 @@ bool CZerocoinDB::ReadCoinMint(const CBigNum& bnPubcoin, uint256& hashTx)
 
 bool CZerocoinDB::ReadCoinMint(const uint256& hashPubcoin, uint256& hashTx)
 {
+    if (!FilterContains(filterMints, hashPubcoin))
+        return false;
     return Read(std::make_pair('m', hashPubcoin), hashTx);
 }
 
@@ -547,14 +830,17 @@ bool CZerocoinDB::WriteCoinSpendBatch(const std::map<libzerocoin::CoinSpend, uin
 {
     CDBBatch batch(*this);
     size_t count = 0;
+    std::vector<uint256> vHashes;
     for (auto it=spendInfo.begin(); it != spendInfo.end(); it++) {
         CBigNum bnSerial = it->first.getCoinSerialNumber();
         CDataStream ss(SER_GETHASH, 0);
         ss << bnSerial;
         uint256 hash = Hash(ss.begin(), ss.end());
         batch.Write(std::make_pair('s', hash), it->second);
+        vHashes.emplace_back(hash);
         ++count;
     }
+    AddToFilter('s', filterSpends, vHashes);
 
     LogPrint(BCLog::ZEROCOINDB, "Writing %u coin spends to db.\n", (unsigned int)count);
     return WriteBatch(batch, true);
@@ -566,11 +852,13 @@ bool CZerocoinDB::ReadCoinSpend(const CBigNum& bnSerial, uint256& txHash)
     ss << bnSerial;
     uint256 hash = Hash(ss.begin(), ss.end());
 
-    return Read(std::make_pair('s', hash), txHash);
+    return ReadCoinSpend(hash, txHash);
 }
 
 bool CZerocoinDB::ReadCoinSpend(const uint256& hashSerial, uint256 &txHash)
 {
+    if (!FilterContains(filterSpends, hashSerial))
+        return false;
     return Read(std::make_pair('s', hashSerial), txHash);
 }
 
@@ -620,7 +908,8 @@ bool CZerocoinDB::WipeCoins(std::string strType)
             LogPrintf("%s: error failed to delete %s\n", __func__, hash.GetHex());
     }
 
-    return true;
+    // Drop the wiped hashes from the filters
+    return LoadFilters();
 }
 
 bool CZerocoinDB::WriteAccumulatorValue(const uint256& hashChecksum, const CBigNum& bnValue)
@@ -639,3 +928,32 @@ bool CZerocoinDB::EraseAccumulatorValue(const uint256& hashChecksum)
     LogPrint(BCLog::ZEROCOINDB, "%s : checksum:%d\n", __func__, hashChecksum.GetHex());
     return Erase(std::make_pair('2', hashChecksum));
 }
+
+// The entries are keyed by height and carry the hash of their block. Entries of a block that was disconnected
+// do not match the hash of the active chain's block, and are overwritten when a block is connected at that height.
+bool CZerocoinDB::WriteBlockPubcoins(int nHeight, const uint256& hashBlock, const std::map<libzerocoin::CoinDenomination, std::vector<CBigNum>>& mapPubcoins)
+{
+    CDBBatch batch(*this);
+    for (auto denom : libzerocoin::zerocoinDenomList) {
+        auto key = std::make_pair('h', std::make_pair(nHeight, (int)denom));
+        auto it = mapPubcoins.find(denom);
+        if (it == mapPubcoins.end())
+            batch.Erase(key);
+        else
+            batch.Write(key, std::make_pair(hashBlock, it->second));
+    }
+
+    LogPrint(BCLog::ZEROCOINDB, "Writing pubcoins of block %d to db.\n", nHeight);
+    return WriteBatch(batch);
+}
+
+bool CZerocoinDB::ReadBlockPubcoins(int nHeight, libzerocoin::CoinDenomination denom, uint256& hashBlock, std::vector<CBigNum>& vPubcoins)
+{
+    std::pair<uint256, std::vector<CBigNum>> entry;
+    if (!Read(std::make_pair('h', std::make_pair(nHeight, (int)denom)), entry))
+        return false;
+
+    hashBlock = entry.first;
+    vPubcoins = std::move(entry.second);
+    return true;
+}
@@ -6,6 +6,7 @@
 #ifndef BITCOIN_TXDB_H
 #define BITCOIN_TXDB_H
 
+#include <bloom.h>
 #include <coins.h>
 #include <dbwrapper.h>
 #include <chain.h>
@@ -13,10 +14,15 @@
 #include <primitives/block.h>
 #include <libzerocoin/Coin.h>
 #include <libzerocoin/CoinSpend.h>
+#include <sync.h>
 
+#include <secp256k1.h>
+
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -46,6 +52,8 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxTxIndexCache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! -maxanonoutputcachesize default (MiB)
+static const int64_t DEFAULT_MAX_ANON_OUTPUT_CACHE_SIZE = 16;
 
 /** CCoinsView backed by the coin database (chainstate/) */
 class CCoinsViewDB final : public CCoinsView
@@ -89,9 +97,35 @@ private:
     friend class CCoinsViewDB;
 };
 
+//! An anon output kept in memory, with the hash of its public key to the curve that ring signatures use
+struct CCachedAnonOutput
+{
+    CAnonOutput ao;
+    secp256k1_pubkey hpk;
+};
+
 /** Access to the block database (blocks/index/) */
 class CBlockTreeDB : public CDBWrapper
 {
+private:
+    //! The most recent anon outputs by index, so that reads of ring members and decoys mostly skip the database.
+    //! The index is dense and only grows, so the cache is a window that starts at nFirstCachedRCTOutput.
+    CCriticalSection cs_rctOutputCache;
+    std::deque<CCachedAnonOutput> dequeRCTOutputs GUARDED_BY(cs_rctOutputCache);
+    int64_t nFirstCachedRCTOutput GUARDED_BY(cs_rctOutputCache);
+    size_t nMaxCachedRCTOutputs GUARDED_BY(cs_rctOutputCache);
+
+    void CacheRCTOutput(int64_t i, const CAnonOutput &ao) EXCLUSIVE_LOCKS_REQUIRED(cs_rctOutputCache);
+    void UncacheRCTOutputs(int64_t nFrom) EXCLUSIVE_LOCKS_REQUIRED(cs_rctOutputCache);
+
+    //! All key images of the chain, so that double spend checks don't read the database.
+    //! Most key images looked up are unspent, the filter answers those without touching the map.
+    //! Until the index is loaded reads go to the database.
+    CCriticalSection cs_rctKeyImages;
+    bool fRCTKeyImagesLoaded GUARDED_BY(cs_rctKeyImages);
+    CBlockedBloomFilter filterRCTKeyImages GUARDED_BY(cs_rctKeyImages);
+    std::unordered_map<CCmpPubKey, uint256, SaltedKeyImageHasher> mapRCTKeyImages GUARDED_BY(cs_rctKeyImages);
+
 public:
     explicit CBlockTreeDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
 
@@ -105,16 +139,29 @@ public:
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
 
     bool ReadRCTOutput(int64_t i, CAnonOutput &ao);
+    //! Also returns H(pk) of the output, which is computed once for the outputs in the cache
+    bool ReadRCTOutput(int64_t i, CAnonOutput &ao, secp256k1_pubkey &hpk);
     bool WriteRCTOutput(int64_t i, const CAnonOutput &ao);
     bool EraseRCTOutput(int64_t i);
 
+    //! Fills the anon output cache with as many outputs up to nLastRCTOutput as fit in nMaxUsage bytes
+    bool LoadRCTOutputCache(int64_t nLastRCTOutput, size_t nMaxUsage);
+    //! Adds anon outputs that were written in a batch of their own
+    void AddRCTOutputsToCache(const std::vector<std::pair<int64_t, CAnonOutput> > &vOutputs);
+
     bool ReadRCTOutputLink(const CCmpPubKey &pk, int64_t &i);
     bool WriteRCTOutputLink(const CCmpPubKey &pk, int64_t i);
     bool EraseRCTOutputLink(const CCmpPubKey &pk);
 
+    //! Fills the key image index from the database
+    bool LoadRCTKeyImages();
+    //! Adds key images to the index before they are written in a batch of their own
+    void AddRCTKeyImagesToIndex(const std::vector<std::pair<CCmpPubKey, uint256> > &vKeyImages);
+
     bool ReadRCTKeyImage(const CCmpPubKey &ki, uint256 &txhash);
     bool WriteRCTKeyImage(const CCmpPubKey &ki, const uint256 &txhash);
     bool EraseRCTKeyImage(const CCmpPubKey &ki);
+    bool EraseRCTKeyImages(const std::vector<std::pair<CCmpPubKey, uint256> > &vKeyImages);
 };
 
 /** Zerocoin database (zerocoin/) */
@@ -127,7 +174,19 @@ private:
     CZerocoinDB(const CZerocoinDB&);
     void operator=(const CZerocoinDB&);
 
+    //! Filters of the spent serial hashes and minted pubcoin hashes, so that reads of unknown hashes skip the database
+    CCriticalSection cs_filters;
+    bool fFiltersLoaded GUARDED_BY(cs_filters);
+    CBlockedBloomFilter filterSpends GUARDED_BY(cs_filters);
+    CBlockedBloomFilter filterMints GUARDED_BY(cs_filters);
+
+    bool LoadFilter(char chType, CBlockedBloomFilter& filter, size_t nElements) EXCLUSIVE_LOCKS_REQUIRED(cs_filters);
+    void AddToFilter(char chType, CBlockedBloomFilter& filter, const std::vector<uint256>& vHashes);
+    bool FilterContains(const CBlockedBloomFilter& filter, const uint256& hash);
+
 public:
+    /** Fill the spend and mint filters from the database. Until they are loaded every read goes to the database. */
+    bool LoadFilters();
     /** Write Zerocoin mints to the zerocoinDB in a batch */
     bool WriteCoinMintBatch(const std::map<libzerocoin::PublicCoin, uint256>& mintInfo);
     bool ReadCoinMint(const CBigNum& bnPubcoin, uint256& txHash);
@@ -142,6 +201,9 @@ public:
     bool WriteAccumulatorValue(const uint256& nChecksum, const CBigNum& bnValue);
     bool ReadAccumulatorValue(const uint256& nChecksum, CBigNum& bnValue);
     bool EraseAccumulatorValue(const uint256& nChecksum);
+    /** Write the pubcoin values minted in a block by denomination, so they can be read without the block */
+    bool WriteBlockPubcoins(int nHeight, const uint256& hashBlock, const std::map<libzerocoin::CoinDenomination, std::vector<CBigNum>>& mapPubcoins);
+    bool ReadBlockPubcoins(int nHeight, libzerocoin::CoinDenomination denom, uint256& hashBlock, std::vector<CBigNum>& vPubcoins);
 };
 
 #endif // BITCOIN_TXDB_H
@@ -537,7 +537,7 @@ public:
     indirectmap<COutPoint, const CTransaction*> mapNextTx GUARDED_BY(cs);
     std::map<uint256, CAmount> mapDeltas;
 
-    std::map<CCmpPubKey, uint256> mapKeyImages;
+    std::unordered_map<CCmpPubKey, uint256, SaltedKeyImageHasher> mapKeyImages;
 
     /** Create a new CTxMemPool.
      */
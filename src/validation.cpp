@@ -258,7 +258,6 @@ bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
 std::map<uint256, unsigned int> mapHashedBlocks;
 std::map<unsigned int, unsigned int> mapStakeHashCounter;
-std::set<uint256> setBatchVerified;
 std::map<uint256, uint256> mapStakeSeen; //stakehash, blockhash
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
@@ -266,9 +265,6 @@ bool fEnableReplacement = DEFAULT_ENABLE_REPLACEMENT;
 unsigned int nStakeMinAge = 60;
 static bool fVerifyingDB = false;
 
-// Used in the precomputing thread
-bool fClearSpendCache = false;
-
 uint256 hashAssumeValid;
 arith_uint256 nMinimumChainWork;
 
@@ -348,7 +344,7 @@ static void FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPr
 static void FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight);
 bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks,
         unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
-        std::vector<CScriptCheck> *pvChecks = nullptr, bool fAnonChecks = true);
+        std::vector<CScriptCheck> *pvChecks = nullptr, bool fAnonChecks = true, std::vector<CMLSAGCheck> *pvAnonChecks = nullptr);
 static FILE* OpenUndoFile(const CDiskBlockPos &pos, bool fReadOnly = false);
 
 bool CheckFinalTx(const CTransaction &tx, int flags)
@@ -724,6 +720,7 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
         return state.Invalid(error("%s: tx mixes zerocoin and basecoin inputs", __func__, REJECT_INVALID, "txn-mixed-zerocoin-inputs"));
 
     std::vector<libzerocoin::SerialNumberSoKProof> vProofs;
+    std::vector<std::shared_ptr<libzerocoin::CoinSpend>> vSpends;
     {
         CCoinsView dummy;
         CCoinsViewCache view(&dummy);
@@ -784,8 +781,10 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
 
                 libzerocoin::SerialNumberSoKProof proof(spend->getSmallSoK(), spend->getCoinSerialNumber(),
                                                         spend->getSerialComm(), spend->getHashSig());
-                if (!setBatchVerified.count(tx.GetHash()))
+                if (!IsZerocoinProofVerified(tx.GetHash())) {
                     vProofs.emplace_back(proof);
+                    vSpends.emplace_back(spend);
+                }
                 setSerials.emplace(bnSerial);
                 continue;
             }
@@ -1128,7 +1127,12 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
                 return state.DoS(100, error("%s: Failed to verify zerocoinspend proofs for tx %s", __func__,
                                             tx.GetHash().GetHex()), REJECT_INVALID);
             }
-            setBatchVerified.emplace(tx.GetHash());
+            // Consensus does not check these proofs, so failing them only makes the transaction non standard
+            if (!ThreadedBatchVerifySpends(&vSpends)) {
+                return state.Invalid(error("%s: Failed to verify zerocoinspend accumulator proofs for tx %s", __func__,
+                                           tx.GetHash().GetHex()), REJECT_NONSTANDARD, "bad-zerocoinspend-proofs");
+            }
+            SetZerocoinProofVerified(tx.GetHash());
         }
 
         if (test_accept) {
@@ -1609,6 +1613,72 @@ int GetSpendHeight(const CCoinsViewCache& inputs)
 }
 
 
+static CuckooCache::cache<uint256, SignatureCacheHasher> zerocoinProofCache;
+static uint256 zerocoinProofCacheNonce(GetRandHash());
+static CCriticalSection cs_zerocoinProofCache;
+
+void InitZerocoinProofCache() {
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxzerocoinproofcachesize", DEFAULT_MAX_ZEROCOIN_PROOF_CACHE_SIZE)), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    LOCK(cs_zerocoinProofCache);
+    size_t nElems = zerocoinProofCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for zerocoin proof cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+static uint256 GetZerocoinProofCacheEntry(const uint256& txid)
+{
+    // Salt the txid, so nobody can craft transactions that collide in the cache
+    uint256 hashCacheEntry;
+    CSHA256().Write(zerocoinProofCacheNonce.begin(), 32).Write(txid.begin(), 32).Finalize(hashCacheEntry.begin());
+    return hashCacheEntry;
+}
+
+bool IsZerocoinProofVerified(const uint256& txid, bool fErase)
+{
+    uint256 hashCacheEntry = GetZerocoinProofCacheEntry(txid);
+    LOCK(cs_zerocoinProofCache);
+    return zerocoinProofCache.contains(hashCacheEntry, fErase);
+}
+
+void SetZerocoinProofVerified(const uint256& txid)
+{
+    uint256 hashCacheEntry = GetZerocoinProofCacheEntry(txid);
+    LOCK(cs_zerocoinProofCache);
+    zerocoinProofCache.insert(hashCacheEntry);
+}
+
+static CuckooCache::cache<uint256, SignatureCacheHasher> rangeProofCache;
+static uint256 rangeProofCacheNonce(GetRandHash());
+static CCriticalSection cs_rangeProofCache;
+
+void InitRangeProofCache() {
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxrangeproofcachesize", DEFAULT_MAX_RANGEPROOF_CACHE_SIZE)), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    LOCK(cs_rangeProofCache);
+    size_t nElems = rangeProofCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for range proof cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+uint256 GetRangeProofCacheEntry(const secp256k1_pedersen_commitment& commitment, const std::vector<uint8_t>& vRangeproof)
+{
+    uint256 hashCacheEntry;
+    CSHA256().Write(rangeProofCacheNonce.begin(), 32).Write(commitment.data, sizeof(commitment.data))
+            .Write(vRangeproof.data(), vRangeproof.size()).Finalize(hashCacheEntry.begin());
+    return hashCacheEntry;
+}
+
+bool IsRangeProofVerified(const uint256& hashCacheEntry)
+{
+    LOCK(cs_rangeProofCache);
+    return rangeProofCache.contains(hashCacheEntry, false);
+}
+
+void SetRangeProofVerified(const uint256& hashCacheEntry)
+{
+    LOCK(cs_rangeProofCache);
+    rangeProofCache.insert(hashCacheEntry);
+}
+
 static CuckooCache::cache<uint256, SignatureCacheHasher> scriptExecutionCache;
 static uint256 scriptExecutionCacheNonce(GetRandHash());
 
@@ -1637,7 +1707,7 @@ void InitScriptExecutionCache() {
  */
 bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks,
         unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
-        std::vector<CScriptCheck> *pvChecks, bool fAnonChecks)
+        std::vector<CScriptCheck> *pvChecks, bool fAnonChecks, std::vector<CMLSAGCheck> *pvAnonChecks)
 {
     if (!tx.IsCoinBase())
     {
@@ -1727,10 +1797,10 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
                 }
             }
 
-            if (fHasAnonInput && fAnonChecks && !VerifyMLSAG(tx, state))
+            if (fHasAnonInput && fAnonChecks && !VerifyMLSAG(tx, state, pvAnonChecks))
                 return false;
 
-            if (cacheFullScriptStore && !pvChecks) {
+            if (cacheFullScriptStore && !pvChecks && !pvAnonChecks) {
                 // We executed all of the provided scripts, and were told to
                 // cache the result. Do so now.
                 scriptExecutionCache.insert(hashCacheEntry);
@@ -2072,6 +2142,36 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+// A ring signature costs as much as many scripts, so the workers take them a few at a time
+static CCheckQueue<CMLSAGCheck> anoncheckqueue(4);
+
+void ThreadAnonCheck() {
+    RenameThread("veil-anonch");
+    anoncheckqueue.Thread();
+}
+
+static CCheckQueue<CRangeProofCheck> rangeproofcheckqueue(16);
+
+void ThreadRangeProofCheck() {
+    RenameThread("veil-rangech");
+    rangeproofcheckqueue.Thread();
+}
+
+bool VerifyRangeProofs(std::vector<CRangeProofCheck>& vChecks)
+{
+    if (!nScriptCheckThreads) {
+        for (CRangeProofCheck& check : vChecks) {
+            if (!check())
+                return false;
+        }
+        return true;
+    }
+
+    CCheckQueueControl<CRangeProofCheck> control(&rangeproofcheckqueue);
+    control.Add(vChecks);
+    return control.Wait();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -2329,6 +2429,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     CBlockUndo blockundo;
 
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && nScriptCheckThreads ? &scriptcheckqueue : nullptr);
+    CCheckQueueControl<CMLSAGCheck> anoncontrol(fScriptChecks && nScriptCheckThreads ? &anoncheckqueue : nullptr);
 
     std::vector<int> prevheights;
     CAmount nFees = 0;
@@ -2422,6 +2523,9 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
                                          REJECT_INVALID, "bad-txns-inputs-missingorspent");
                 }
 
+                // Proofs verified by the mempool or the staging thread are not needed again once the block is connected
+                bool fProofsVerified = IsZerocoinProofVerified(txid, /*fErase*/!fJustCheck);
+
                 //Check for double spending of serial #'s
                 for (const CTxIn& txIn : tx.vin) {
                     if (!txIn.IsZerocoinSpend())
@@ -2444,7 +2548,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
                                                     tx.GetHash().GetHex()), REJECT_INVALID);
                     libzerocoin::SerialNumberSoKProof proof(spend->getSmallSoK(), spend->getCoinSerialNumber(),
                                                             spend->getSerialComm(), spend->getHashSig());
-                    if (!setBatchVerified.count(txid)) {
+                    if (!fProofsVerified) {
                         vTxidProofs.emplace_back(txid);
                         vProofs.emplace_back(proof);
                     }
@@ -2508,12 +2612,15 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         txdata.emplace_back(tx);
         if (!tx.IsCoinBase()) {
             std::vector<CScriptCheck> vChecks;
+            std::vector<CMLSAGCheck> vAnonChecks;
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
-            if (!CheckInputs(tx, state, view, fScriptChecks, flags, fCacheResults, fCacheResults, txdata[i], nScriptCheckThreads ? &vChecks : nullptr))
+            if (!CheckInputs(tx, state, view, fScriptChecks, flags, fCacheResults, fCacheResults, txdata[i], nScriptCheckThreads ? &vChecks : nullptr,
+                    true, nScriptCheckThreads ? &vAnonChecks : nullptr))
                 return error("ConnectBlock(): CheckInputs on %s failed with %s",
                     tx.GetHash().ToString(), FormatStateMessage(state));
 
             control.Add(vChecks);
+            anoncontrol.Add(vAnonChecks);
 
             blockundo.vtxundo.push_back(CTxUndo());
             UpdateCoins(tx, view, blockundo.vtxundo.back(), pindex->nHeight);
@@ -2597,9 +2704,11 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
                                         block.GetHash().GetHex(), pindex->nHeight), REJECT_INVALID);
         }
 
-        //Global tracker for already validated proofs
-        for (const uint256& txid : vTxidProofs)
-            setBatchVerified.emplace(txid);
+        // Don't cache results if we're actually connecting blocks
+        if (fJustCheck) {
+            for (const uint256& txid : vTxidProofs)
+                SetZerocoinProofVerified(txid);
+        }
     }
     nTimeSigVerify = GetTimeMicros() - nTimeSigVerify;
     nTimeZerocoinSpendCheck += nTimeSigVerify;
@@ -2608,7 +2717,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     if (!AddZerocoinsToIndex(pindex, block, mapSpends, mapMints, fJustCheck))
         return state.DoS(100, error("%s: Failed to calculate new zerocoin supply for block=%s height=%d", __func__,
                                     block.GetHash().GetHex(), pindex->nHeight), REJECT_INVALID);
-    pindex->mapAccumulatorHashes = block.mapAccumulatorHashes;
+    pindex->SetAccumulatorHashes(block.mapAccumulatorHashes);
 
     // track money supply and mint amount info
     CAmount nMoneySupplyPrev = pindex->pprev ? pindex->pprev->nMoneySupply : 0;
@@ -2702,6 +2811,8 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
     if (!control.Wait())
         return state.DoS(100, error("%s: CheckQueue failed", __func__), REJECT_INVALID, "block-validation-failed");
+    if (!anoncontrol.Wait())
+        return state.DoS(100, error("%s: anon CheckQueue failed", __func__), REJECT_INVALID, "verify-mlsag-failed");
 
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
@@ -2726,6 +2837,14 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     // Flush spend/mint info to disk
     if (!pzerocoinDB->WriteCoinSpendBatch(mapSpends)) return state.Error(("Failed to record coin serials to database"));
     if (!pzerocoinDB->WriteCoinMintBatch(mapMints)) return state.Error(("Failed to record new mints to database"));
+    // Index the block's pubcoins by denomination, so witnesses and checkpoints do not need to read the block
+    if (!mapMints.empty()) {
+        std::list<libzerocoin::PublicCoin> listPubcoins;
+        for (const auto& mint : mapMints)
+            listPubcoins.emplace_back(mint.first);
+        if (!WriteBlockPubcoins(pindex, listPubcoins))
+            return state.Error(("Failed to record block pubcoins to database"));
+    }
 
     //Record accumulator checksums - if they have been updated, which happens every ten blocks
     if (pindex->nHeight > 10 && pindex->nHeight % 10 == 0)
@@ -2900,9 +3019,8 @@ bool FlushView(CCoinsViewCache *view, CValidationState& state, bool fDisconnecti
         return false;
 
     if (fDisconnecting) {
-        for (auto &it : view->keyImages)
-            if (!pblocktree->EraseRCTKeyImage(it.first))
-                return error("%s: EraseRCTKeyImage failed, txn %s.", __func__, it.second.ToString());
+        if (!pblocktree->EraseRCTKeyImages(view->keyImages))
+            return error("%s: EraseRCTKeyImages failed.", __func__);
 
         if (view->anonOutputLinks.size() > 0) {
             for (auto &it : view->anonOutputLinks) {
@@ -2916,6 +3034,7 @@ bool FlushView(CCoinsViewCache *view, CValidationState& state, bool fDisconnecti
     } else {
         CDBBatch batch(*pblocktree);
 
+        pblocktree->AddRCTKeyImagesToIndex(view->keyImages);
         for (auto &it : view->keyImages)
             batch.Write(std::make_pair(DB_RCTKEYIMAGE, it.first), it.second);
 
@@ -2927,6 +3046,7 @@ bool FlushView(CCoinsViewCache *view, CValidationState& state, bool fDisconnecti
 
         if (!pblocktree->WriteBatch(batch))
             return error("%s: Write RCT outputs failed.", __func__);
+        pblocktree->AddRCTOutputsToCache(view->anonOutputs);
     }
 
     view->nLastRCTOutput = 0;
@@ -3890,15 +4010,22 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
             return state.DoS(100, false, REJECT_INVALID, "bad-cb-multiple", false, "more than one coinbase");
     }
 
-    // Check transactions
+    // Check transactions, the range proofs of all of them are verified together afterwards
     int64_t nTimeCheckTx = GetTimeMicros();
+    std::vector<CRangeProofCheck> vRangeProofChecks;
     for (const auto& tx : block.vtx) {
-        if (!CheckTransaction(*tx, state, fSkipComputation))
+        if (!CheckTransaction(*tx, state, fSkipComputation, &vRangeProofChecks))
             return state.Invalid(false, state.GetRejectCode(), state.GetRejectReason(),
                                  strprintf("Transaction check failed (tx hash %s) %s", tx->GetHash().ToString(),
                                            state.GetDebugMessage()));
     }
     LogPrint(BCLog::BENCH, "    -   CheckTransaction(): %.2fms\n", 0.001 * (GetTimeMicros() - nTimeCheckTx));
+
+    int64_t nTimeRangeProofs = GetTimeMicros();
+    size_t nRangeProofs = vRangeProofChecks.size();
+    if (!VerifyRangeProofs(vRangeProofChecks))
+        return state.DoS(100, false, REJECT_INVALID, "bad-blk-rangeproof-verify", false, "a range proof in the block is invalid");
+    LogPrint(BCLog::BENCH, "    -   Verify %u range proofs: %.2fms\n", nRangeProofs, 0.001 * (GetTimeMicros() - nTimeRangeProofs));
     unsigned int nSigOps = 0;
     for (const auto& tx : block.vtx)
     {
@@ -3963,21 +4090,25 @@ bool AddZerocoinsToIndex(CBlockIndex* pindex, const CBlock& block, const std::ma
     //TODO: VEIL-89
     // Initialize zerocoin supply to the supply from previous block
     if (pindex->pprev) {
-        for (auto& denom : libzerocoin::zerocoinDenomList) {
-            pindex->mapZerocoinSupply.at(denom) = pindex->pprev->mapZerocoinSupply.at(denom);
+        for (int i = 0; i < libzerocoin::ZEROCOIN_DENOM_COUNT; i++) {
+            pindex->nZerocoinSupply[i] = pindex->pprev->nZerocoinSupply[i];
         }
     }
 
     // Track zerocoin money supply
     CAmount nAmountZerocoinSpent = 0;
-    pindex->vMintDenominationsInBlock.clear();
+    for (int i = 0; i < libzerocoin::ZEROCOIN_DENOM_COUNT; i++)
+        pindex->nMintsInBlock[i] = 0;
     if (pindex->pprev) {
         std::set<uint256> setAddedToWallet;
         for (auto& pMint : mapMints) {
             const auto& coin = pMint.first;
             libzerocoin::CoinDenomination denom = coin.getDenomination();
-            pindex->vMintDenominationsInBlock.push_back(denom);
-            pindex->mapZerocoinSupply.at(denom)++;
+            int nIndex = libzerocoin::ZerocoinDenominationToIndex(denom);
+            if (nIndex < 0)
+                return error("%s: mint with invalid denomination", __func__);
+            pindex->nMintsInBlock[nIndex]++;
+            pindex->nZerocoinSupply[nIndex]++;
 #ifdef ENABLE_WALLET
             const auto& txid = pMint.second;
             auto pwalletMain = GetMainWallet();
@@ -4006,14 +4137,18 @@ bool AddZerocoinsToIndex(CBlockIndex* pindex, const CBlock& block, const std::ma
 
         for (auto& pSpend : mapSpends) {
             auto denom = pSpend.first.getDenomination();
-            pindex->mapZerocoinSupply.at(denom)--;
+            int nIndex = libzerocoin::ZerocoinDenominationToIndex(denom);
+            if (nIndex < 0)
+                return error("%s: spend with invalid denomination", __func__);
+            pindex->nZerocoinSupply[nIndex]--;
             nAmountZerocoinSpent += libzerocoin::ZerocoinDenominationToAmount(denom);
 
             // zerocoin failsafe
-            if (pindex->mapZerocoinSupply.at(denom) < 0)
+            if (pindex->nZerocoinSupply[nIndex] < 0)
                 return error("Block contains zerocoins that spend more than are in the available supply to spend");
         }
     }
+    pindex->SetChainMints();
 
     return true;
 }
@@ -4878,6 +5013,7 @@ bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlo
         pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + pindex->GetBlockWork();
         pindex->nChainPoW = pindex->GetChainPoW();
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
+        pindex->SetChainMints();
         // We can link the chain of blocks for which we've received transactions at some point.
         // Pruned nodes may have deleted the block.
         if (pindex->nTx > 0) {
@@ -40,6 +40,7 @@ class CCoinsViewDB;
 class CInv;
 class CConnman;
 class CScriptCheck;
+class CRangeProofCheck;
 class CBlockPolicyEstimator;
 class CTxMemPool;
 class CValidationState;
@@ -88,6 +89,10 @@ static const int MAX_SCRIPTCHECK_THREADS = 16;
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
 /** Threads used when batch verifying zeroknowledge proofs **/
 static const int DEFAULT_BATCHVERIFY_THREADS = 2;
+/** Default for -maxzerocoinproofcachesize, in MiB */
+static const unsigned int DEFAULT_MAX_ZEROCOIN_PROOF_CACHE_SIZE = 4;
+/** Default for -maxrangeproofcachesize, in MiB */
+static const unsigned int DEFAULT_MAX_RANGEPROOF_CACHE_SIZE = 8;
 /** Number of blocks that can be requested at any given time from a single peer. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
 /** Timeout in seconds during which a peer must stall block download progress before being disconnected. */
@@ -177,7 +182,6 @@ extern size_t nCoinCacheUsage;
 extern std::map<uint256, unsigned int> mapHashedBlocks; //blockhash, last timestamp hashed
 extern std::map<unsigned int, unsigned int> mapStakeHashCounter;
 extern std::map<uint256, uint256> mapStakeSeen;
-extern std::set<uint256> setBatchVerified;
 /** A fee rate smaller than this is considered zero fee (for relaying, mining and transaction creation) */
 extern CFeeRate minRelayTxFee;
 /** Absolute maximum transaction fee (in satoshis) used by wallet and mempool (rejects high fee in sendrawtransaction) */
@@ -223,9 +227,6 @@ static const unsigned int DEFAULT_CHECKLEVEL = 4;
 // Setting the target to > than 550MB will make it likely we can respect the target.
 static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
 
-/** Veil zerocoin precomputing variables */
-extern bool fClearSpendCache;
-
 /**
  * Process an incoming block. This only returns after the best known valid
  * block is made active. Note that it does not, however, guarantee that the
@@ -281,6 +282,10 @@ bool LoadChainTip(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the ring signature checking thread */
+void ThreadAnonCheck();
+/** Run an instance of the range proof checking thread */
+void ThreadRangeProofCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Check whether both headers and blocks are synced **/
@@ -425,6 +430,22 @@ public:
 /** Initializes the script-execution cache */
 void InitScriptExecutionCache();
 
+/** Initializes the cache of transactions whose zerocoin spend proofs were verified */
+void InitZerocoinProofCache();
+/** Whether the zerocoin spend proofs of the transaction were verified. fErase drops the entry once it is not needed anymore */
+bool IsZerocoinProofVerified(const uint256& txid, bool fErase = false);
+/** Records that the zerocoin spend proofs of the transaction were verified */
+void SetZerocoinProofVerified(const uint256& txid);
+
+/** Initializes the cache of verified range proofs */
+void InitRangeProofCache();
+/** The salted cache entry of a range proof over the given commitment */
+uint256 GetRangeProofCacheEntry(const secp256k1_pedersen_commitment& commitment, const std::vector<uint8_t>& vRangeproof);
+bool IsRangeProofVerified(const uint256& hashCacheEntry);
+void SetRangeProofVerified(const uint256& hashCacheEntry);
+/** Verifies the collected range proofs of a block, on the range proof check threads when there are any */
+bool VerifyRangeProofs(std::vector<CRangeProofCheck>& vChecks);
+
 
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
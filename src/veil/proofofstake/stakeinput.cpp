@@ -34,7 +34,7 @@ int ZerocoinStake::GetChecksumHeightFromMint()
     //Need to return the first occurance of this checksum in order for the validation process to identify a specific
     //block height
     uint256 nChecksum;
-    nChecksum = chainActive[nHeightChecksum]->mapAccumulatorHashes[denom];
+    nChecksum = chainActive[nHeightChecksum]->GetAccumulatorHash(denom);
     return GetChecksumHeight(nChecksum, denom);
 }
 
@@ -103,7 +103,7 @@ bool ZerocoinStake::GetModifier(uint64_t& nStakeModifier)
         pindex = pindex->pprev;
     }
 
-    nStakeModifier = UintToArith256(pindex->mapAccumulatorHashes[denom]).GetLow64();
+    nStakeModifier = UintToArith256(pindex->GetAccumulatorHash(denom)).GetLow64();
     return true;
 }
 
@@ -135,6 +135,15 @@ bool ZerocoinStake::CreateTxIn(CWallet* pwallet, CTxIn& txIn, uint256 hashTxOut)
     if (libzerocoin::ExtractVersionFromSerial(mint.GetSerialNumber()) < 2)
         return error("%s: serial extract is less than v2", __func__);
 
+    // Use the spend prepared in the background for this checkpoint, so only the parts bound to the outputs are left
+    std::shared_ptr<CPreparedMintSpend> prepared;
+    if (pwallet->TakePreparedStake(hashSerial, pindexCheckpoint, prepared)) {
+        CZerocoinSpendReceipt receipt;
+        if (pwallet->SignMintSpend(*prepared, hashTxOut, txIn, receipt))
+            return true;
+        LogPrintf("%s: failed to sign prepared stake, building it again: %s\n", __func__, receipt.GetStatusMessage());
+    }
+
     int nSecurityLevel = 100;
     CZerocoinSpendReceipt receipt;
     if (!pwallet->MintToTxIn(mint, nSecurityLevel, hashTxOut, txIn, receipt, libzerocoin::SpendType::STAKE, GetIndexFrom()))
@@ -19,7 +19,35 @@
 #include <txmempool.h>
 
 
-bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
+bool CMLSAGCheck::operator()()
+{
+    const CTxIn &txin = ptx->vin[nIn];
+    const std::vector<uint8_t> &vKeyImages = txin.scriptData.stack[0];
+    const std::vector<uint8_t> &vDL = txin.scriptWitness.stack[1];
+
+    std::vector<const uint8_t*> vpInCommits(vInCommits.size());
+    for (size_t i = 0; i < vInCommits.size(); ++i)
+        vpInCommits[i] = vInCommits[i].data;
+    std::vector<const uint8_t*> vpOutCommits(vOutCommits.size());
+    for (size_t i = 0; i < vOutCommits.size(); ++i)
+        vpOutCommits[i] = vOutCommits[i].data;
+
+    if (0 != (nResult = secp256k1_prepare_mlsag(&vM[0], nullptr, vpOutCommits.size(), vpOutCommits.size(), nCols, nRows,
+            &vpInCommits[0], &vpOutCommits[0], nullptr))) {
+        strError = "prepare-mlsag-failed";
+        return false;
+    }
+
+    if (0 != (nResult = secp256k1_verify_mlsag_hpk(secp256k1_ctx_blind, hashOutputs.begin(), nCols, nRows, &vM[0], &vHpk[0],
+            &vKeyImages[0], &vDL[0], &vDL[32]))) {
+        strError = "verify-mlsag-failed";
+        return false;
+    }
+
+    return true;
+}
+
+bool VerifyMLSAG(const CTransaction &tx, CValidationState &state, std::vector<CMLSAGCheck> *pvChecks)
 {
     int rv;
     std::set<int64_t> setHaveI; // Anon prev-outputs can only be used once per transaction.
@@ -48,8 +76,12 @@ bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
     if (fSplitCommitments)
         vpInputSplitCommits.reserve(tx.vin.size());
 
+    if (pvChecks)
+        pvChecks->reserve(pvChecks->size() + tx.vin.size());
+
     uint256 hashOutputs = tx.GetOutputsHash();
-    for (const auto &txin : tx.vin) {
+    for (unsigned int nIn = 0; nIn < tx.vin.size(); ++nIn) {
+        const CTxIn &txin = tx.vin[nIn];
         if (!txin.IsAnonInput())
             return state.DoS(100, false, REJECT_MALFORMED, "bad-anon-input");
 
@@ -85,24 +117,25 @@ bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
 
         std::vector<uint8_t> vM(nCols * nRows * 33);
 
-        std::vector<secp256k1_pedersen_commitment> vCommitments;
-        vCommitments.reserve(nCols * nInputs);
-        std::vector<const uint8_t*> vpOutCommits;
-        std::vector<const uint8_t*> vpInCommits(nCols * nInputs);
+        std::vector<secp256k1_pedersen_commitment> vInCommits(nCols * nInputs);
+        std::vector<secp256k1_pubkey> vHpk(nCols * nInputs);
+        std::vector<secp256k1_pedersen_commitment> vOutCommits;
 
         if (fSplitCommitments) {
-            vpOutCommits.push_back(&vDL[(1 + (nInputs+1) * nRingSize) * 32]);
+            vOutCommits.emplace_back();
+            memcpy(vOutCommits.back().data, &vDL[(1 + (nInputs+1) * nRingSize) * 32], 33);
             vpInputSplitCommits.push_back(&vDL[(1 + (nInputs+1) * nRingSize) * 32]);
         } else {
-            vpOutCommits.push_back(plainCommitment.data);
+            vOutCommits.push_back(plainCommitment);
 
             secp256k1_pedersen_commitment *pc;
             for (const auto &txout : tx.vpout) {
                 if ((pc = txout->GetPCommitment()))
-                    vpOutCommits.push_back(pc->data);
+                    vOutCommits.push_back(*pc);
             }
         }
 
+        // The ring members are read here, so that the signature itself can be verified on any thread
         size_t ofs = 0, nB = 0;
         for (size_t k = 0; k < nInputs; ++k) {
             for (size_t i = 0; i < nCols; ++i) {
@@ -115,14 +148,14 @@ bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
                 if (!setHaveI.insert(nIndex).second)
                     return state.DoS(100, false, REJECT_MALFORMED, "bad-anonin-dup-i");
 
+                // H(pk) comes with the output, so that popular decoys are not hashed to the curve again
                 CAnonOutput ao;
-                if (!pblocktree->ReadRCTOutput(nIndex, ao)) {
+                if (!pblocktree->ReadRCTOutput(nIndex, ao, vHpk[i + k * nCols])) {
                     return state.DoS(100, false, REJECT_MALFORMED, "bad-anonin-unknown-i");
                 }
 
                 memcpy(&vM[(i + k * nCols) * 33], ao.pubkey.begin(), 33);
-                vCommitments.push_back(ao.commitment);
-                vpInCommits[i + k * nCols] = vCommitments.back().data;
+                vInCommits[i + k * nCols] = ao.commitment;
             }
         }
 
@@ -145,13 +178,14 @@ bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
             }
         }
 
-        if (0 != (rv = secp256k1_prepare_mlsag(&vM[0], nullptr, vpOutCommits.size(), vpOutCommits.size(), nCols, nRows,
-                &vpInCommits[0], &vpOutCommits[0], nullptr)))
-            return state.DoS(100, error("%s: prepare-mlsag-failed %d", __func__, rv), REJECT_INVALID, "prepare-mlsag-failed");
-
-        if (0 != (rv = secp256k1_verify_mlsag(secp256k1_ctx_blind, hashOutputs.begin(), nCols, nRows, &vM[0], &vKeyImages[0],
-                &vDL[0], &vDL[32])))
-            return state.DoS(100, error("%s: verify-mlsag-failed %d", __func__, rv), REJECT_INVALID, "verify-mlsag-failed");
+        CMLSAGCheck check(tx, nIn, nCols, nRows, hashOutputs, std::move(vM), std::move(vInCommits), std::move(vOutCommits),
+                std::move(vHpk));
+        if (pvChecks) {
+            pvChecks->push_back(CMLSAGCheck());
+            check.swap(pvChecks->back());
+        } else if (!check()) {
+            return state.DoS(100, error("%s: %s %d", __func__, check.GetError(), check.GetResult()), REJECT_INVALID, check.GetError());
+        }
     }
 
     // Verify commitment sums match
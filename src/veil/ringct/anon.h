@@ -7,6 +7,9 @@
 #include <inttypes.h>
 #include <primitives/transaction.h>
 
+#include <string>
+#include <vector>
+
 class CTxMemPool;
 class CValidationState;
 
@@ -18,7 +21,56 @@ const size_t MAX_ANON_INPUTS = 32; // To raise see MLSAG_MAX_ROWS also
 const size_t ANON_FEE_MULTIPLIER = 2;
 
 
-bool VerifyMLSAG(const CTransaction &tx, CValidationState &state);
+/**
+ * Closure representing the ring signature check of one anon input. The ring members are read from
+ * the database when it is created, so that it can run on the anon check queue. The transaction
+ * must outlive the check.
+ */
+class CMLSAGCheck
+{
+private:
+    const CTransaction *ptx;
+    unsigned int nIn;
+    size_t nCols;
+    size_t nRows;
+    uint256 hashOutputs;
+    std::vector<uint8_t> vM;
+    std::vector<secp256k1_pedersen_commitment> vInCommits;
+    std::vector<secp256k1_pedersen_commitment> vOutCommits;
+    std::vector<secp256k1_pubkey> vHpk;
+    std::string strError;
+    int nResult;
+
+public:
+    CMLSAGCheck() : ptx(nullptr), nIn(0), nCols(0), nRows(0), nResult(0) {}
+    CMLSAGCheck(const CTransaction &txIn, unsigned int nInIn, size_t nColsIn, size_t nRowsIn, const uint256 &hashOutputsIn,
+            std::vector<uint8_t> &&vMIn, std::vector<secp256k1_pedersen_commitment> &&vInCommitsIn,
+            std::vector<secp256k1_pedersen_commitment> &&vOutCommitsIn, std::vector<secp256k1_pubkey> &&vHpkIn) :
+        ptx(&txIn), nIn(nInIn), nCols(nColsIn), nRows(nRowsIn), hashOutputs(hashOutputsIn), vM(std::move(vMIn)),
+        vInCommits(std::move(vInCommitsIn)), vOutCommits(std::move(vOutCommitsIn)), vHpk(std::move(vHpkIn)), nResult(0) {}
+
+    bool operator()();
+
+    void swap(CMLSAGCheck &check) {
+        std::swap(ptx, check.ptx);
+        std::swap(nIn, check.nIn);
+        std::swap(nCols, check.nCols);
+        std::swap(nRows, check.nRows);
+        std::swap(hashOutputs, check.hashOutputs);
+        vM.swap(check.vM);
+        vInCommits.swap(check.vInCommits);
+        vOutCommits.swap(check.vOutCommits);
+        vHpk.swap(check.vHpk);
+        strError.swap(check.strError);
+        std::swap(nResult, check.nResult);
+    }
+
+    const std::string &GetError() const { return strError; }
+    int GetResult() const { return nResult; }
+};
+
+/** Verifies the ring signatures of tx. With pvChecks they are appended to it instead of being verified here. */
+bool VerifyMLSAG(const CTransaction &tx, CValidationState &state, std::vector<CMLSAGCheck> *pvChecks = nullptr);
 
 bool AddKeyImagesToMempool(const CTransaction &tx, CTxMemPool &pool);
 bool RemoveKeyImagesFromMempool(const uint256 &hash, const CTxIn &txin, CTxMemPool &pool);
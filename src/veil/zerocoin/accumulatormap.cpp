@@ -7,10 +7,49 @@
 #include "txdb.h"
 #include "libzerocoin/Denominations.h"
 #include "validation.h"
+#include "util.h"
+#include <checkqueue.h>
 
 using namespace libzerocoin;
 using namespace std;
 
+/** Accumulates pubcoins of one denomination in their order, run on the accumulator worker threads */
+class CAccumulateCheck
+{
+public:
+    libzerocoin::Accumulator* accumulator = nullptr;
+    std::vector<const libzerocoin::PublicCoin*> vPubcoins;
+    bool fSkipValidation = false;
+
+    bool operator()();
+    void swap(CAccumulateCheck& check)
+    {
+        std::swap(accumulator, check.accumulator);
+        vPubcoins.swap(check.vPubcoins);
+        std::swap(fSkipValidation, check.fSkipValidation);
+    }
+};
+
+bool CAccumulateCheck::operator()()
+{
+    for (const PublicCoin* pubCoin : vPubcoins) {
+        if (fSkipValidation)
+            accumulator->increment(pubCoin->getValue());
+        else if (!accumulator->accumulate(*pubCoin))
+            return false;
+    }
+    return true;
+}
+
+// The denominations are accumulated concurrently on these workers, at most one job per denomination
+static CCheckQueue<CAccumulateCheck> accumulatequeue(1);
+
+void ThreadAccumulate()
+{
+    RenameThread("veil-accumulate");
+    accumulatequeue.Thread();
+}
+
 //Construct accumulators for all denominations
 AccumulatorMap::AccumulatorMap(libzerocoin::ZerocoinParams* params)
 {
@@ -75,6 +114,45 @@ bool AccumulatorMap::Accumulate(const PublicCoin& pubCoin, bool fSkipValidation)
     return mapAccumulators.at(denom)->accumulate(pubCoin);
 }
 
+//Add a list of zerocoins to the accumulators of their denominations, one worker per denomination.
+//The coins of a denomination are accumulated in the order of the list, so the result is the same as
+//accumulating them one by one.
+bool AccumulatorMap::Accumulate(const std::vector<PublicCoin>& vPubcoins, bool fSkipValidation)
+{
+    std::map<CoinDenomination, CAccumulateCheck> mapChecks;
+    for (const PublicCoin& pubCoin : vPubcoins) {
+        CoinDenomination denom = pubCoin.getDenomination();
+        if (denom == CoinDenomination::ZQ_ERROR)
+            return false;
+
+        CAccumulateCheck& check = mapChecks[denom];
+        check.accumulator = mapAccumulators.at(denom).get();
+        check.fSkipValidation = fSkipValidation;
+        check.vPubcoins.emplace_back(&pubCoin);
+    }
+
+    if (mapChecks.empty())
+        return true;
+
+    for (const auto& denomCheck : mapChecks)
+        setUnusedDenominations.erase(denomCheck.first);
+
+    if (mapChecks.size() == 1)
+        return mapChecks.begin()->second();
+
+    std::vector<CAccumulateCheck> vChecks;
+    vChecks.reserve(mapChecks.size());
+    for (auto& denomCheck : mapChecks) {
+        vChecks.emplace_back();
+        vChecks.back().swap(denomCheck.second);
+    }
+
+    // The calling thread joins the workers, so this also works when no worker threads were started
+    CCheckQueueControl<CAccumulateCheck> control(&accumulatequeue);
+    control.Add(vChecks);
+    return control.Wait();
+}
+
 libzerocoin::Accumulator AccumulatorMap::GetAccumulator(libzerocoin::CoinDenomination denom)
 {
     return libzerocoin::Accumulator(params, denom, GetValue(denom));
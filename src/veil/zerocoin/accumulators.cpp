@@ -14,6 +14,8 @@
 #include "shutdown.h"
 #include "veil/zerocoin/witness.h"
 
+#include <boost/thread.hpp>
+
 using namespace libzerocoin;
 
 std::map<uint256, CBigNum> mapAccumulatorValues;
@@ -134,7 +136,7 @@ bool EraseCheckpoints(int nStartHeight, int nEndHeight)
 
     CBlockIndex* pindex = chainActive[nStartHeight];
 
-    auto mapCheckpointsPrev = pindex->pprev->mapAccumulatorHashes;
+    auto mapCheckpointsPrev = pindex->pprev->GetAccumulatorHashes();
     while (pindex) {
         //Do not erase the hash if it is the same as the previous block
         for (auto pairPrevious : mapCheckpointsPrev) {
@@ -163,7 +165,7 @@ bool InitializeAccumulators(const int nHeight, int& nHeightCheckpoint, Accumulat
     mapAccumulators.Reset(Params().Zerocoin_Params());
 
     //Use the previous block's checkpoint to initialize the accumulator's state
-    auto mapCheckpointPrev = chainActive[nHeight - 1]->mapAccumulatorHashes;
+    auto mapCheckpointPrev = chainActive[nHeight - 1]->GetAccumulatorHashes();
     bool fLoad = false;
     for (auto accPair: mapCheckpointPrev) {
         if (accPair.second != uint256()) {
@@ -187,7 +189,7 @@ bool CalculateAccumulatorCheckpoint(int nHeight, std::map<libzerocoin::CoinDenom
 {
     //the checkpoint is updated every ten blocks, return current active checkpoint if not update block
     if (nHeight % 10 != 0 || nHeight == 10) {
-        mapCheckpoints = chainActive[nHeight - 1]->mapAccumulatorHashes;
+        mapCheckpoints = chainActive[nHeight - 1]->GetAccumulatorHashes();
         return true;
     }
 
@@ -198,7 +200,7 @@ bool CalculateAccumulatorCheckpoint(int nHeight, std::map<libzerocoin::CoinDenom
         return error("%s: failed to initialize accumulators", __func__);
 
     //Accumulate all coins over the last ten blocks that havent been accumulated (height - 20 through height - 11)
-    int nTotalMintsFound = 0;
+    std::vector<PublicCoin> vPubcoins;
     CBlockIndex *pindex = chainActive[nHeightCheckpoint - 20];
 
     if (!pindex)
@@ -206,28 +208,21 @@ bool CalculateAccumulatorCheckpoint(int nHeight, std::map<libzerocoin::CoinDenom
 
     while (pindex->nHeight < nHeight - 10) {
         //grab mints from this block
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-            return error("%s: failed to read block from disk", __func__);
-
         std::list<PublicCoin> listPubcoins;
-        if (!BlockToPubcoinList(block, listPubcoins))
+        if (!GetBlockPubcoins(pindex, listPubcoins))
             return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
 
-        nTotalMintsFound += listPubcoins.size();
-
-        //add the pubcoins to accumulator
-        for (const PublicCoin& pubcoin : listPubcoins) {
-            if(!mapAccumulators.Accumulate(pubcoin, true))
-                return error("%s: failed to add pubcoin to accumulator at height %d", __func__, pindex->nHeight);
-        }
-
+        vPubcoins.insert(vPubcoins.end(), listPubcoins.begin(), listPubcoins.end());
         pindex = chainActive.Next(pindex);
     }
 
+    //add the pubcoins to the accumulators, the denominations are accumulated in parallel
+    if (!mapAccumulators.Accumulate(vPubcoins, true))
+        return error("%s: failed to add pubcoins to accumulator at height %d", __func__, nHeight);
+
     // if there were no new mints found, the accumulator checkpoint will be the same as the last checkpoint
-    if (nTotalMintsFound == 0) {
-        mapCheckpoints = chainActive[nHeight - 1]->mapAccumulatorHashes;
+    if (vPubcoins.empty()) {
+        mapCheckpoints = chainActive[nHeight - 1]->GetAccumulatorHashes();
     }
     else
         mapCheckpoints = mapAccumulators.GetCheckpoints();
@@ -255,13 +250,13 @@ bool ValidateAccumulatorCheckpoint(const CBlock& block, CBlockIndex* pindex, Acc
 
         for (auto checkpointPair: mapAccumulators.GetCheckpoints(true)) {
             if (checkpointPair.second != block.mapAccumulatorHashes.at(checkpointPair.first))
-                return error("%s : accumulator does not match calculated value. block=%s calculated=%s", __func__, pindex->mapAccumulatorHashes.at(checkpointPair.first).GetHex(), checkpointPair.second.GetHex());
+                return error("%s : accumulator does not match calculated value. block=%s calculated=%s", __func__, pindex->GetAccumulatorHashes().at(checkpointPair.first).GetHex(), checkpointPair.second.GetHex());
         }
 
         return true;
     }
 
-    if (block.mapAccumulatorHashes != pindex->pprev->mapAccumulatorHashes)
+    if (block.mapAccumulatorHashes != pindex->pprev->GetAccumulatorHashes())
         return error("%s : new accumulator checkpoint generated on a block that is not multiple of 10", __func__);
 
     return true;
@@ -271,14 +266,16 @@ bool ValidateAccumulatorCheckpoint(const CBlock& block, CBlockIndex* pindex, Acc
 int ComputeAccumulatedCoins(int nHeightEnd, libzerocoin::CoinDenomination denom)
 {
     LOCK(cs_main);
-    CBlockIndex* pindex = chainActive[GetZerocoinStartHeight()];
-    int n = 0;
-    while (pindex->nHeight < nHeightEnd) {
-        n += count(pindex->vMintDenominationsInBlock.begin(), pindex->vMintDenominationsInBlock.end(), denom);
-        pindex = chainActive.Next(pindex);
-    }
+    int nHeightStart = GetZerocoinStartHeight();
+    if (nHeightEnd <= nHeightStart)
+        return 0;
+
+    // The blocks keep a running count of their mints, so the range is the difference of its two ends
+    const CBlockIndex* pindexStart = chainActive[nHeightStart];
+    const CBlockIndex* pindexEnd = chainActive[std::min(nHeightEnd - 1, chainActive.Height())];
+    int64_t nMintsBefore = pindexStart->pprev ? pindexStart->pprev->GetChainMints(denom) : 0;
 
-    return n;
+    return pindexEnd->GetChainMints(denom) - nMintsBefore;
 }
 
 int AddBlockMintsToAccumulator(const libzerocoin::PublicCoin& coin, const int nHeightMintAdded, const CBlockIndex* pindex,
@@ -293,12 +290,8 @@ int AddBlockMintsToAccumulator(const libzerocoin::PublicCoin& coin, const int nH
     list<PublicCoin> listPubcoins;
     //Do not keep cs_main locked during modular exponentiation (unless this is already locked from the validation)
     {
-        //grab mints from this block
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-            return error("%s: failed to read block from disk while adding pubcoins to witness", __func__);
-
-        if (!BlockToPubcoinList(block, listPubcoins))
+        //grab mints of this denomination from this block
+        if (!GetBlockPubcoins(pindex, coin.getDenomination(), listPubcoins))
             return error("%s: failed to get zerocoin mintlist from block %n\n", __func__, pindex->nHeight);
     }
 
@@ -341,6 +334,187 @@ void AccumulateRange(CoinWitnessData* coinWitness, int nHeightEnd)
     }
 }
 #ifdef ENABLE_WALLET
+//Find the block that added the mint of the witness and set the heights the witness accumulates from
+static bool SetWitnessMintHeight(CoinWitnessData* coinwitness)
+{
+    AssertLockHeld(cs_main);
+    if (!pzerocoinDB->ReadCoinMint(coinwitness->coin->getValue(), coinwitness->txid))
+        return error("%s failed to find mint %s in blockchain db", __func__, GetPubCoinHash((*coinwitness->coin).getValue()).GetHex());
+
+    CTransactionRef txMinted;
+    uint256 hashBlock;
+    if (!GetTransaction(coinwitness->txid, txMinted, Params().GetConsensus(), hashBlock, true))
+        return error("%s failed to read tx %s", __func__, coinwitness->txid.GetHex());
+
+    int nHeightTest;
+    if (!IsBlockHashInChain(hashBlock, nHeightTest))
+        return error("%s: mint tx %s is not in chain", __func__, coinwitness->txid.GetHex());
+
+    coinwitness->SetHeightMintAdded(mapBlockIndex[hashBlock]->nHeight);
+    return true;
+}
+
+CWitnessBatch::CWitnessBatch(libzerocoin::CoinDenomination denom) : denom(denom)
+{
+    SetNull();
+}
+
+void CWitnessBatch::SetNull()
+{
+    nHeightStart = 0;
+    nHeightPrecomputed = 0;
+    bnAccValue = 0;
+    vTracked.clear();
+    vCoinsAdded.clear();
+}
+
+//Start over from the checkpoint that was made right before the block range starting at nHeight
+bool CWitnessBatch::Reset(int nHeight)
+{
+    SetNull();
+    int nHeightCheckpoint = nHeight + 10;
+    {
+        LOCK(cs_main);
+        if (nHeightCheckpoint > chainActive.Height())
+            return error("%s: checkpoint height %d is beyond the chain", __func__, nHeightCheckpoint);
+        if (!GetAccumulatorValue(nHeightCheckpoint, denom, bnAccValue))
+            bnAccValue = Accumulator(Params().Zerocoin_Params(), denom).getValue();
+    }
+
+    nHeightStart = nHeight;
+    nHeightPrecomputed = nHeight - 1;
+    return true;
+}
+
+bool CWitnessBatch::Advance(const std::vector<CoinWitnessData*>& vCoinWitness, int nHeightEnd)
+{
+    // Find where every mint was added, mints that are not in the chain are left out of the batch
+    std::vector<CoinWitnessData*> vBatch;
+    std::set<CBigNum> setValues;
+    int nHeightFirst = std::numeric_limits<int>::max();
+    for (CoinWitnessData* coinwitness : vCoinWitness) {
+        if (coinwitness->denom != denom)
+            return error("%s: witness of denomination %d in the batch of %d", __func__, coinwitness->denom, denom);
+
+        if (!coinwitness->nHeightMintAdded) {
+            LOCK(cs_main);
+            if (!SetWitnessMintHeight(coinwitness))
+                continue;
+        }
+
+        vBatch.emplace_back(coinwitness);
+        setValues.emplace(coinwitness->coin->getValue());
+        nHeightFirst = std::min(nHeightFirst, coinwitness->nHeightAccStart);
+    }
+
+    if (vBatch.empty())
+        return true;
+
+    // Every mint that is already in the range has to be tracked, otherwise start over from the earliest mint
+    std::set<CBigNum> setTracked(vTracked.begin(), vTracked.end());
+    bool fReset = IsNull() || nHeightFirst < nHeightStart;
+    for (const CoinWitnessData* coinwitness : vBatch) {
+        if (coinwitness->nHeightMintAdded <= nHeightPrecomputed && !setTracked.count(coinwitness->coin->getValue()))
+            fReset = true;
+    }
+
+    if (fReset) {
+        if (!Reset(nHeightFirst))
+            return false;
+    } else {
+        // Coins that are no longer tracked are accumulated like any other coin
+        for (auto it = vTracked.begin(); it != vTracked.end();) {
+            if (setValues.count(*it)) {
+                ++it;
+                continue;
+            }
+            bnAccValue = Params().Zerocoin_Params()->accumulatorParams.pow_mod(bnAccValue, *it);
+            it = vTracked.erase(it);
+        }
+    }
+
+    const int nHeightPrecomputedPrev = nHeightPrecomputed;
+    const size_t nTrackedPrev = vTracked.size();
+    std::vector<CBigNum> vCoinsInPass;
+    CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = chainActive[nHeightPrecomputed + 1];
+    }
+    while (pindex && pindex->nHeight <= nHeightEnd) {
+        boost::this_thread::interruption_point();
+
+        //Do not keep cs_main locked during modular exponentiation
+        std::list<PublicCoin> listPubcoins;
+        {
+            LOCK(cs_main);
+            if (pindex->MintedDenomination(denom) && !GetBlockPubcoins(pindex, denom, listPubcoins)) {
+                SetNull();
+                return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
+            }
+        }
+
+        for (const PublicCoin& pubcoin : listPubcoins) {
+            const CBigNum& bnValue = pubcoin.getValue();
+            if (setValues.count(bnValue))
+                vTracked.emplace_back(bnValue);
+            else
+                bnAccValue = Params().Zerocoin_Params()->accumulatorParams.pow_mod(bnAccValue, bnValue);
+            vCoinsInPass.emplace_back(bnValue);
+        }
+
+        vCoinsAdded.emplace_back((vCoinsAdded.empty() ? 0 : vCoinsAdded.back()) + listPubcoins.size());
+        nHeightPrecomputed = pindex->nHeight;
+
+        LOCK(cs_main);
+        pindex = chainActive.Next(pindex);
+    }
+
+    // Witnesses that were up to date only need the coins of this pass when that is cheaper than splitting them again
+    bool fSplit = fReset || vTracked.size() != nTrackedPrev;
+    for (const CoinWitnessData* coinwitness : vBatch) {
+        if (coinwitness->nHeightMintAdded <= nHeightPrecomputedPrev && coinwitness->nHeightPrecomputed != nHeightPrecomputedPrev)
+            fSplit = true;
+    }
+    size_t nSplitCost = 0;
+    for (size_t n = vTracked.size(); n > 1; n = (n + 1) / 2)
+        ++nSplitCost;
+    if (vCoinsInPass.size() >= nSplitCost)
+        fSplit = true;
+
+    std::map<CBigNum, CBigNum> mapWitnessValues;
+    if (fSplit) {
+        std::vector<CBigNum> vWitnessValues = AccumulateAllButOne(&Params().Zerocoin_Params()->accumulatorParams, bnAccValue, vTracked);
+        for (unsigned int i = 0; i < vTracked.size(); i++)
+            mapWitnessValues.emplace(vTracked[i], vWitnessValues[i]);
+    }
+
+    for (CoinWitnessData* coinwitness : vBatch) {
+        if (coinwitness->nHeightMintAdded > nHeightPrecomputed)
+            continue;
+
+        if (fSplit) {
+            auto it = mapWitnessValues.find(coinwitness->coin->getValue());
+            if (it == mapWitnessValues.end()) {
+                SetNull();
+                return error("%s: mint %s was not found at height %d", __func__,
+                             GetPubCoinHash(coinwitness->coin->getValue()).GetHex(), coinwitness->nHeightMintAdded);
+            }
+            coinwitness->pAccumulator->setValue(it->second);
+        } else {
+            for (const CBigNum& bnValue : vCoinsInPass)
+                coinwitness->pAccumulator->increment(bnValue);
+        }
+
+        int nHeightAccStart = coinwitness->nHeightAccStart;
+        int nCoinsBefore = nHeightAccStart > nHeightStart ? vCoinsAdded[nHeightAccStart - nHeightStart - 1] : 0;
+        coinwitness->nMintsAdded = vCoinsAdded.back() - nCoinsBefore - 1;
+        coinwitness->nHeightPrecomputed = nHeightPrecomputed;
+    }
+
+    return true;
+}
+
 bool GenerateAccumulatorWitness(CoinWitnessData* coinwitness, AccumulatorMap& mapAccumulators, int nSecurityLevel, string& strError, CBlockIndex* pindexCheckpoint)
 {
     CBigNum bnAccValue = 0;
@@ -355,20 +529,8 @@ bool GenerateAccumulatorWitness(CoinWitnessData* coinwitness, AccumulatorMap& ma
             coinwitness->pWitness = std::unique_ptr<AccumulatorWitness>(new AccumulatorWitness(Params().Zerocoin_Params(), *coinwitness->pAccumulator, coin));
         }
 
-        uint256 txid;
-        if (!pzerocoinDB->ReadCoinMint(coin.getValue(), coinwitness->txid))
-            return error("%s failed to find mint %s in blockchain db", __func__, GetPubCoinHash((*coinwitness->coin).getValue()).GetHex());
-
-        CTransactionRef txMinted;
-        uint256 hashBlock;
-        if (!GetTransaction(coinwitness->txid, txMinted, Params().GetConsensus(), hashBlock, true))
-            return error("%s failed to read tx %s", __func__, coinwitness->txid.GetHex());
-
-        int nHeightTest;
-        if (!IsBlockHashInChain(hashBlock, nHeightTest))
-            return error("%s: mint tx %s is not in chain", __func__, txid.GetHex());
-
-        coinwitness->SetHeightMintAdded(mapBlockIndex[hashBlock]->nHeight);
+        if (!SetWitnessMintHeight(coinwitness))
+            return false;
 
         //Get the accumulator that is right before the cluster of blocks containing our mint was added to the accumulator
         bnAccValue = 0;
@@ -403,7 +565,7 @@ bool GenerateAccumulatorWitness(CoinWitnessData* coinwitness, AccumulatorMap& ma
         AccumulateRange(coinwitness, nHeightStop - 1);
     }
 
-    mapAccumulators.Load(chainActive[nHeightStop + 10]->mapAccumulatorHashes);
+    mapAccumulators.Load(chainActive[nHeightStop + 10]->GetAccumulatorHashes());
     coinwitness->pWitness->resetValue(*coinwitness->pAccumulator, coin);
     if(!coinwitness->pWitness->VerifyWitness(mapAccumulators.GetAccumulator(coinwitness->denom), coin))
         return error("%s: failed to verify witness", __func__);
@@ -424,42 +586,39 @@ bool GenerateAccumulatorWitness(CoinWitnessData* coinwitness, AccumulatorMap& ma
 
 map<CoinDenomination, int> GetMintMaturityHeight()
 {
-    map<CoinDenomination, pair<int, int > > mapDenomMaturity;
+    map<CoinDenomination, int> mapRet;
     for (auto denom : libzerocoin::zerocoinDenomList)
-        mapDenomMaturity.insert(make_pair(denom, make_pair(0, 0)));
+        mapRet.insert(make_pair(denom, 0));
 
     int nConfirmedHeight = chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations();
+    int nRequiredAccumulation = Params().Zerocoin_RequiredAccumulation();
+    const CBlockIndex* pindexConfirmed = chainActive[nConfirmedHeight];
+    if (!pindexConfirmed || nRequiredAccumulation <= 0)
+        return mapRet;
 
     // A mint need to get to at least the min maturity height before it will spend.
     int nMinimumMaturityHeight = nConfirmedHeight - (nConfirmedHeight % 10);
-    CBlockIndex* pindex = chainActive[nConfirmedHeight];
 
-    while (pindex) {
-        bool isFinished = true;
-        for (auto denom : libzerocoin::zerocoinDenomList) {
-            //If the denom has not already had a mint added to it, then see if it has a mint added on this block
-            if (mapDenomMaturity.at(denom).first < Params().Zerocoin_RequiredAccumulation()) {
-                mapDenomMaturity.at(denom).first += count(pindex->vMintDenominationsInBlock.begin(),
-                                                          pindex->vMintDenominationsInBlock.end(), denom);
-
-                //if mint was found then record this block as the first block that maturity occurs.
-                if (mapDenomMaturity.at(denom).first >= Params().Zerocoin_RequiredAccumulation())
-                    mapDenomMaturity.at(denom).second = std::min(pindex->nHeight, nMinimumMaturityHeight);
-
-                //Signal that we are finished
-                isFinished = false;
-            }
+    for (auto denom : libzerocoin::zerocoinDenomList) {
+        // Maturity occurs at the highest block from which the confirmed blocks hold enough mints of the denomination.
+        // The mints counted from a block only grow going back, so binary search the running counts for it.
+        int64_t nMintsConfirmed = pindexConfirmed->GetChainMints(denom);
+        if (nMintsConfirmed < nRequiredAccumulation)
+            continue;
+
+        int nLow = 0;
+        int nHigh = nConfirmedHeight;
+        while (nLow < nHigh) {
+            int nMid = nLow + (nHigh - nLow + 1) / 2;
+            int64_t nMintsBefore = chainActive[nMid - 1]->GetChainMints(denom);
+            if (nMintsConfirmed - nMintsBefore >= nRequiredAccumulation)
+                nLow = nMid;
+            else
+                nHigh = nMid - 1;
         }
 
-        if (isFinished)
-            break;
-        pindex = chainActive[pindex->nHeight - 1];
+        mapRet.at(denom) = std::min(nLow, nMinimumMaturityHeight);
     }
 
-    //Generate final map
-    map<CoinDenomination, int> mapRet;
-    for (auto denom : libzerocoin::zerocoinDenomList)
-        mapRet.insert(make_pair(denom, mapDenomMaturity.at(denom).second));
-
     return mapRet;
 }
@@ -30,4 +30,33 @@ int GetChecksumHeight(uint256 nChecksum, libzerocoin::CoinDenomination denominat
 bool ValidateAccumulatorCheckpoint(const CBlock& block, CBlockIndex* pindex, AccumulatorMap& mapAccumulators);
 void AccumulateRange(CoinWitnessData* coinWitness, int nHeightEnd);
 
+/**
+ * Precomputes the witnesses of all the tracked mints of one denomination together. The accumulator
+ * is kept once without any of the tracked coins and the witnesses are split off it with
+ * libzerocoin::AccumulateAllButOne, so every block range is read once and advancing N witnesses costs
+ * one pass over the range plus O(N log N) exponentiations, instead of one pass per witness.
+ */
+class CWitnessBatch
+{
+private:
+    libzerocoin::CoinDenomination denom;
+    int nHeightStart; // accumulation start of the earliest tracked mint
+    int nHeightPrecomputed;
+    CBigNum bnAccValue; // accumulator of the range without the tracked coins
+    std::vector<CBigNum> vTracked; // tracked coins that were added in the range
+    std::vector<int> vCoinsAdded; // coins of the denomination added from nHeightStart through each height
+
+    bool Reset(int nHeight);
+
+public:
+    explicit CWitnessBatch(libzerocoin::CoinDenomination denom);
+    void SetNull();
+    bool IsNull() const { return vCoinsAdded.empty(); }
+    int GetHeightPrecomputed() const { return nHeightPrecomputed; }
+
+    /** Advance the witnesses of the denomination through nHeightEnd. Witnesses of mints that are not
+     *  in the range yet are left untouched, and witnesses that cannot be found in the chain are skipped. */
+    bool Advance(const std::vector<CoinWitnessData*>& vCoinWitness, int nHeightEnd);
+};
+
 #endif //PIVX_ACCUMULATORS_H
@@ -4,112 +4,276 @@
 
 #include "lrucache.h"
 
+#include <memusage.h>
+#include <util.h>
+#include <utiltime.h>
+
 PrecomputeLRUCache::PrecomputeLRUCache()
 {
+    nMaxUsage = DEFAULT_PRECOMPUTE_CACHE_SIZE << 20;
+    nNextVersion = 0;
+    fFlushing = false;
     Clear();
 }
 
+size_t PrecomputeLRUCache::EntryUsage(const CoinWitnessCacheData& data)
+{
+    // The map node, the list node and the limbs of the two bignums held by the entry
+    return memusage::MallocUsage(sizeof(std::pair<const uint256, CacheEntry>) + 2 * sizeof(void*)) +
+           memusage::MallocUsage(sizeof(uint256) + 2 * sizeof(void*)) +
+           memusage::MallocUsage(data.coinAmount.bitSize() / 8 + 1) +
+           memusage::MallocUsage(data.accumulatorAmount.bitSize() / 8 + 1);
+}
+
+void PrecomputeLRUCache::SetMaxUsage(size_t nNewMaxUsage)
+{
+    LOCK(cs_lru);
+    nMaxUsage = std::max(nNewMaxUsage, (size_t)MIN_PRECOMPUTE_CACHE_SIZE << 20);
+    EvictIfFull();
+}
+
 void PrecomputeLRUCache::Clear()
 {
-    cache_list.clear();
-    mapCacheLocation.clear();
-    mapDirtyWitnessData.clear();
+    LOCK(cs_lru);
+    if (fFlushing) {
+        for (const auto& item : mapCache)
+            setErased.insert(item.first);
+    }
+    listLRU.clear();
+    mapCache.clear();
+    nUsage = 0;
+    nDirtyUsage = 0;
+    nDirtyEntries = 0;
+}
+
+void PrecomputeLRUCache::SetDirty(CacheEntry& entry, bool fDirty)
+{
+    if (entry.fDirty == fDirty)
+        return;
+
+    entry.fDirty = fDirty;
+    if (fDirty) {
+        nDirtyUsage += entry.nUsage;
+        nDirtyEntries++;
+    } else {
+        nDirtyUsage -= entry.nUsage;
+        nDirtyEntries--;
+    }
+}
+
+void PrecomputeLRUCache::Insert(const uint256& hash, const CoinWitnessCacheData& data, bool fDirty)
+{
+    auto it = mapCache.find(hash);
+    if (it == mapCache.end()) {
+        listLRU.push_front(hash);
+        CacheEntry& entry = mapCache[hash];
+        entry.itLRU = listLRU.begin();
+        entry.nUsage = 0;
+        entry.fDirty = false;
+        it = mapCache.find(hash);
+    } else {
+        listLRU.splice(listLRU.begin(), listLRU, it->second.itLRU);
+    }
+
+    CacheEntry& entry = it->second;
+    bool fWasDirty = entry.fDirty;
+    SetDirty(entry, false);
+    nUsage -= entry.nUsage;
+
+    entry.data = data;
+    entry.nUsage = EntryUsage(data);
+    entry.nVersion = ++nNextVersion;
+    nUsage += entry.nUsage;
+    SetDirty(entry, fDirty || fWasDirty);
+
+    EvictIfFull();
+}
+
+void PrecomputeLRUCache::Erase(CacheMap::iterator it)
+{
+    SetDirty(it->second, false);
+    nUsage -= it->second.nUsage;
+    listLRU.erase(it->second.itLRU);
+    mapCache.erase(it);
 }
 
-void PrecomputeLRUCache::AddNew(const uint256& hash, CoinWitnessCacheData& data)
+void PrecomputeLRUCache::EvictIfFull()
 {
-    cache_list.push_front(std::make_pair(hash, data));
-    mapCacheLocation.insert(make_pair(hash, cache_list.begin()));
-    MoveLastToDirtyIfFull();
-    //Remove from dirty cache in case it is there
-    mapDirtyWitnessData.erase(hash);
+    // Dirty entries stay until they are flushed, so start from the least recently used clean one
+    auto itLRU = listLRU.end();
+    while (nUsage > nMaxUsage && itLRU != listLRU.begin()) {
+        --itLRU;
+        auto it = mapCache.find(*itLRU);
+        if (it->second.fDirty)
+            continue;
+
+        itLRU = std::next(itLRU);
+        Erase(it);
+        stats.nEvictions++;
+    }
+}
+
+void PrecomputeLRUCache::AddNew(const uint256& hash, const CoinWitnessCacheData& data)
+{
+    LOCK(cs_lru);
+    Insert(hash, data, false);
+}
+
+void PrecomputeLRUCache::AddToCache(const uint256& hash, const CoinWitnessCacheData& serialData)
+{
+    LOCK(cs_lru);
+    Insert(hash, serialData, true);
 }
 
 int PrecomputeLRUCache::Size() const
 {
-    return mapCacheLocation.size();
+    LOCK(cs_lru);
+    return mapCache.size();
 }
 
 int PrecomputeLRUCache::DirtyCacheSize() const
 {
-    return mapDirtyWitnessData.size();
+    LOCK(cs_lru);
+    return nDirtyEntries;
 }
 
-bool PrecomputeLRUCache::Contains(const uint256& hash) const
+size_t PrecomputeLRUCache::DynamicMemoryUsage() const
 {
-    return mapCacheLocation.count(hash) > 0 || mapDirtyWitnessData.count(hash) > 0;
+    LOCK(cs_lru);
+    return nUsage;
 }
 
-void PrecomputeLRUCache::MoveDirtyToLRU(const uint256& hash)
+bool PrecomputeLRUCache::IsFull() const
 {
-    auto data = CoinWitnessData(mapDirtyWitnessData.at(hash));
-    auto cachedata = CoinWitnessCacheData(&data);
-    AddNew(hash, cachedata);
+    LOCK(cs_lru);
+    return nUsage >= nMaxUsage;
 }
 
-void PrecomputeLRUCache::MoveLastToDirtyIfFull()
+bool PrecomputeLRUCache::IsFlushNeeded() const
 {
-    if (mapCacheLocation.size() > PRECOMPUTE_LRU_CACHE_SIZE) {
-        auto last_it = cache_list.end(); last_it --;
-        mapCacheLocation.erase(last_it->first);
-        CoinWitnessCacheData removedData = cache_list.back().second;
-        mapDirtyWitnessData[cache_list.back().first] = removedData;
-        cache_list.pop_back();
-    }
+    LOCK(cs_lru);
+    return nDirtyUsage > nMaxUsage / 2;
 }
 
-CoinWitnessData PrecomputeLRUCache::GetWitnessData(const uint256& hash)
+bool PrecomputeLRUCache::Contains(const uint256& hash) const
 {
-    if (mapDirtyWitnessData.count(hash)) {
-        MoveDirtyToLRU(hash);
-    }
+    LOCK(cs_lru);
+    return mapCache.count(hash) > 0;
+}
 
-    auto it = mapCacheLocation.find(hash);
-    if (it != mapCacheLocation.end()) {
-        // Get the witness data from the cache
-        cache_list.splice(cache_list.begin(), cache_list, it->second);
-        return CoinWitnessData(it->second->second);
+bool PrecomputeLRUCache::GetWitnessData(const uint256& hash, CoinWitnessData& data)
+{
+    LOCK(cs_lru);
+    auto it = mapCache.find(hash);
+    if (it == mapCache.end()) {
+        stats.nMisses++;
+        return false;
     }
 
-    return CoinWitnessData();
+    stats.nHits++;
+    listLRU.splice(listLRU.begin(), listLRU, it->second.itLRU);
+    CoinWitnessCacheData cacheData = it->second.data;
+    data = CoinWitnessData(cacheData);
+    return true;
 }
 
 void PrecomputeLRUCache::Remove(const uint256& hash)
 {
-    auto it = mapCacheLocation.find(hash);
-    if (it != mapCacheLocation.end()) {
-        cache_list.erase(it->second);
-        mapCacheLocation.erase(it);
-    }
-    mapDirtyWitnessData.erase(hash);
+    LOCK(cs_lru);
+    if (fFlushing)
+        setErased.insert(hash);
+    auto it = mapCache.find(hash);
+    if (it != mapCache.end())
+        Erase(it);
 }
 
-void PrecomputeLRUCache::AddToCache(const uint256& hash, CoinWitnessCacheData& serialData)
+bool PrecomputeLRUCache::FlushToDisk(CPrecomputeDB* pprecomputeDB)
 {
-    // If the LRU cache already has a entry for it, update the entry and move it to the front of the list
-    auto it = mapCacheLocation.find(hash);
-    if (it != mapCacheLocation.end()) {
-        cache_list.splice(cache_list.begin(), cache_list, it->second);
-        cache_list.begin()->second = serialData;
-    } else {
-        AddNew(hash, serialData);
+    LOCK(cs_flush);
+    int64_t nTimeStart = GetTimeMicros();
+
+    // Copy the dirty entries, so the workers can keep using the cache while they are written
+    std::vector<std::pair<uint256, CoinWitnessCacheData>> vDirty;
+    std::vector<uint64_t> vVersions;
+    {
+        LOCK(cs_lru);
+        vDirty.reserve(nDirtyEntries);
+        vVersions.reserve(nDirtyEntries);
+        for (const auto& item : mapCache) {
+            if (!item.second.fDirty)
+                continue;
+            vDirty.emplace_back(item.first, item.second.data);
+            vVersions.emplace_back(item.second.nVersion);
+        }
+        fFlushing = !vDirty.empty();
+        setErased.clear();
     }
 
-    // We just added a new hash into our LRU cache, so remove it if we also have it in the dirty map
-    mapDirtyWitnessData.erase(hash);
-    MoveLastToDirtyIfFull();
-}
+    // An entry removed after the copy is not written, and it is erased in the next batch in case its
+    // removal reached the database before the batch that still had it
+    bool fSuccess = true;
+    std::vector<std::pair<uint256, uint64_t>> vWritten;
+    for (size_t nStart = 0; nStart < vDirty.size(); nStart += PRECOMPUTE_FLUSH_BATCH_SIZE) {
+        size_t nEnd = std::min(vDirty.size(), nStart + PRECOMPUTE_FLUSH_BATCH_SIZE);
+        std::vector<std::pair<uint256, CoinWitnessCacheData>> vBatch;
+        std::vector<uint64_t> vBatchVersions;
+        std::vector<uint256> vErase;
+        {
+            LOCK(cs_lru);
+            for (size_t i = nStart; i < nEnd; i++) {
+                if (setErased.count(vDirty[i].first))
+                    continue;
+                vBatch.emplace_back(vDirty[i]);
+                vBatchVersions.emplace_back(vVersions[i]);
+            }
+            vErase.assign(setErased.begin(), setErased.end());
+            setErased.clear();
+        }
+        if (!pprecomputeDB->WritePrecomputes(vBatch, vErase)) {
+            fSuccess = false;
+            break;
+        }
+        for (size_t i = 0; i < vBatch.size(); i++)
+            vWritten.emplace_back(vBatch[i].first, vBatchVersions[i]);
+    }
 
-void PrecomputeLRUCache::FlushToDisk(CPrecomputeDB* pprecomputeDB)
-{
-    // Save all cache data that was dirty back into the database
-    for (auto item : mapDirtyWitnessData) {
-        pprecomputeDB->WritePrecompute(item.first, item.second);
+    // Erase what was removed while the last batch was written
+    std::vector<uint256> vErase;
+    {
+        LOCK(cs_lru);
+        vErase.assign(setErased.begin(), setErased.end());
+        setErased.clear();
+        fFlushing = false;
     }
-    mapDirtyWitnessData.clear();
+    if (fSuccess && !vErase.empty() && !pprecomputeDB->WritePrecomputes({}, vErase))
+        fSuccess = false;
 
-    // Save the LRU cache data into the database
-    for (auto item : cache_list) {
-        pprecomputeDB->WritePrecompute(item.first, item.second);
+    // Entries that were updated during the flush stay dirty
+    LOCK(cs_lru);
+    for (const auto& written : vWritten) {
+        auto it = mapCache.find(written.first);
+        if (it != mapCache.end() && it->second.nVersion == written.second)
+            SetDirty(it->second, false);
     }
+    EvictIfFull();
+
+    stats.nFlushes++;
+    stats.nEntriesFlushed += vWritten.size();
+    stats.nLastFlushTime = GetTimeMicros() - nTimeStart;
+    stats.nTotalFlushTime += stats.nLastFlushTime;
+
+    if (!fSuccess)
+        return error("%s: failed to write precomputes to the database", __func__);
+    return true;
+}
+
+PrecomputeCacheStats PrecomputeLRUCache::GetStats() const
+{
+    LOCK(cs_lru);
+    PrecomputeCacheStats ret = stats;
+    ret.nEntries = mapCache.size();
+    ret.nDirtyEntries = nDirtyEntries;
+    ret.nUsage = nUsage;
+    ret.nMaxUsage = nMaxUsage;
+    return ret;
 }
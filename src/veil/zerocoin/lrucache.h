@@ -7,29 +7,90 @@
 #define VEIL_LRUCACHE_H
 
 #include <veil/zerocoin/witness.h>
+#include <sync.h>
 #include <unordered_map>
+#include <unordered_set>
 #include <list>
 
+static const int64_t DEFAULT_PRECOMPUTE_CACHE_SIZE = 8; // MiB
+static const int64_t MIN_PRECOMPUTE_CACHE_SIZE = 1; // MiB
+static const unsigned int PRECOMPUTE_FLUSH_BATCH_SIZE = 1000; // entries written per leveldb batch
+
+struct PrecomputeHasher
+{
+    size_t operator()(const uint256& hash) const { return hash.GetCheapHash(); }
+};
+
+struct PrecomputeCacheStats
+{
+    size_t nEntries = 0;
+    size_t nDirtyEntries = 0;
+    size_t nUsage = 0;
+    size_t nMaxUsage = 0;
+    uint64_t nHits = 0;
+    uint64_t nMisses = 0;
+    uint64_t nEvictions = 0;
+    uint64_t nFlushes = 0;
+    uint64_t nEntriesFlushed = 0;
+    int64_t nLastFlushTime = 0; // microseconds
+    int64_t nTotalFlushTime = 0; // microseconds
+};
+
+/**
+ * Cache of precomputed witnesses, indexed by serial hash and bounded by memory usage. Once the
+ * budget is exceeded the least recently used clean entries are evicted. Entries that changed since
+ * they were written to the database are dirty: they are never evicted, and FlushToDisk writes only
+ * them, in batches. Entries removed while a flush is writing are erased from the database by the
+ * flush, so it does not bring them back. Shared by all the precompute workers, every method takes cs_lru.
+ */
 class PrecomputeLRUCache
 {
 private:
-    std::list<std::pair<uint256, CoinWitnessCacheData> > cache_list;
-    std::map<uint256, std::list<std::pair<uint256, CoinWitnessCacheData> >::iterator> mapCacheLocation;
-    std::map<uint256, CoinWitnessCacheData> mapDirtyWitnessData;
+    struct CacheEntry
+    {
+        CoinWitnessCacheData data;
+        std::list<uint256>::iterator itLRU;
+        size_t nUsage;
+        uint64_t nVersion; // bumped on every update, so a flush only cleans the version it wrote
+        bool fDirty;
+    };
+    typedef std::unordered_map<uint256, CacheEntry, PrecomputeHasher> CacheMap;
+
+    mutable CCriticalSection cs_lru;
+    CCriticalSection cs_flush;
+    std::list<uint256> listLRU; // most recently used first
+    CacheMap mapCache;
+    size_t nMaxUsage;
+    size_t nUsage;
+    size_t nDirtyUsage;
+    size_t nDirtyEntries;
+    uint64_t nNextVersion;
+    bool fFlushing;
+    std::unordered_set<uint256, PrecomputeHasher> setErased; // removed since the current flush took its copy
+    PrecomputeCacheStats stats;
+
+    static size_t EntryUsage(const CoinWitnessCacheData& data);
+    void Insert(const uint256& hash, const CoinWitnessCacheData& data, bool fDirty);
+    void Erase(CacheMap::iterator it);
+    void SetDirty(CacheEntry& entry, bool fDirty);
+    void EvictIfFull();
 
 public:
-    void AddNew(const uint256& hash, CoinWitnessCacheData& data);
-    void AddToCache(const uint256& hash, CoinWitnessCacheData& serialData);
+    PrecomputeLRUCache();
+    void SetMaxUsage(size_t nNewMaxUsage);
+    void AddNew(const uint256& hash, const CoinWitnessCacheData& data);
+    void AddToCache(const uint256& hash, const CoinWitnessCacheData& serialData);
     bool Contains(const uint256& hash) const;
     void Clear();
-    void FlushToDisk(CPrecomputeDB* pprecomputeDB);
-    CoinWitnessData GetWitnessData(const uint256& hash);
-    PrecomputeLRUCache();
-    void MoveDirtyToLRU(const uint256& hash);
-    void MoveLastToDirtyIfFull();
+    bool FlushToDisk(CPrecomputeDB* pprecomputeDB);
+    bool GetWitnessData(const uint256& hash, CoinWitnessData& data);
     void Remove(const uint256& hash);
     int Size() const;
     int DirtyCacheSize() const;
+    size_t DynamicMemoryUsage() const;
+    bool IsFull() const;
+    bool IsFlushNeeded() const;
+    PrecomputeCacheStats GetStats() const;
 };
 
 
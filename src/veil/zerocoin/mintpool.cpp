@@ -29,6 +29,7 @@ void CMintPool::Add(const CBigNum& bnValue, const uint32_t& nCount)
 void CMintPool::Add(const pair<uint256, uint32_t>& pMint, bool fVerbose)
 {
     insert(pMint);
+    setCountsGenerated.insert(pMint.second);
     if (pMint.second > nCountLastGenerated)
         nCountLastGenerated = pMint.second;
 
@@ -67,6 +68,7 @@ std::list<pair<uint256, uint32_t> > CMintPool::List()
 void CMintPool::Reset()
 {
     clear();
+    setCountsGenerated.clear();
     nCountLastGenerated = 0;
     nCountLastRemoved = 0;
 }
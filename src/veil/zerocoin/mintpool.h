@@ -7,6 +7,7 @@
 
 #include <map>
 #include <list>
+#include <unordered_set>
 
 #include "primitives/zerocoin.h"
 #include "libzerocoin/bignum.h"
@@ -26,12 +27,16 @@ private:
     uint32_t nCountLastGenerated;
     uint32_t nCountLastRemoved;
 
+    //Every count that was generated for the seed, including the ones that were removed from the pool since
+    std::unordered_set<uint32_t> setCountsGenerated;
+
 public:
     CMintPool();
     explicit CMintPool(uint32_t nCount);
     void Add(const CBigNum& bnValue, const uint32_t& nCount);
     void Add(const std::pair<uint256, uint32_t>& pMint, bool fVerbose = false);
     bool Has(const CBigNum& bnValue);
+    bool HasCount(const uint32_t& nCount) const { return setCountsGenerated.count(nCount) > 0; }
     void Remove(const CBigNum& bnValue);
     void Remove(const uint256& hashPubcoin);
     std::pair<uint256, uint32_t> Get(const CBigNum& bnValue);
@@ -5,7 +5,7 @@
 #include <wallet/wallet.h>
 #include "precompute.h"
 
-Precompute precomputer = Precompute();
+Precompute precomputer;
 
 Precompute::Precompute()
 {
@@ -15,8 +15,23 @@ Precompute::Precompute()
 void Precompute::SetNull()
 {
     nBlocksPerCycle = DEFAULT_PRECOMPUTE_BPC;
+    nThreads = DEFAULT_PRECOMPUTE_THREADS;
     pthreadGroupPrecompute = nullptr;
     lru.Clear();
+    nClearRequested = 0;
+    {
+        WaitableLock lock(cs_clear);
+        nClearDone = 0;
+        vClearSeen.clear();
+    }
+}
+
+void Precompute::ReadArgs()
+{
+    SetBlocksPerCycle(gArgs.GetArg("-precomputeblockpercycle", DEFAULT_PRECOMPUTE_BPC));
+    SetThreads(gArgs.GetArg("-precomputethreads", DEFAULT_PRECOMPUTE_THREADS));
+    int64_t nCacheSize = std::max(gArgs.GetArg("-precomputecachesize", DEFAULT_PRECOMPUTE_CACHE_SIZE), MIN_PRECOMPUTE_CACHE_SIZE);
+    lru.SetMaxUsage((size_t)nCacheSize << 20);
 }
 
 boost::thread_group* Precompute::GetThreadGroupPointer()
@@ -42,7 +57,23 @@ bool Precompute::StartPrecomputing(std::string& strStatus)
         this->StopPrecomputing();
     }
 
-    pthreadGroupPrecompute->create_thread(boost::bind(&ThreadPrecomputeSpends));
+    // Load the precomputes into the LRU cache before the workers start using it
+    lru.Clear();
+    if (pprecomputeDB && !pprecomputeDB->LoadPrecomputes(&lru))
+        LogPrint(BCLog::PRECOMPUTE, "%s: Failed to load precompute database\n", __func__);
+
+    {
+        LOCK(cs_progress);
+        vWorkerProgress.assign(nThreads, PrecomputeWorkerProgress());
+    }
+    {
+        WaitableLock lock(cs_clear);
+        vClearSeen.assign(nThreads, 0);
+    }
+
+    // Each worker precomputes its own share of the mints
+    for (int i = 0; i < nThreads; i++)
+        pthreadGroupPrecompute->create_thread(boost::bind(&ThreadPrecomputeSpends, i, nThreads));
 
     strStatus = "precomputing started";
     return true;
@@ -86,25 +117,105 @@ int Precompute::GetBlocksPerCycle()
     return nBlocksPerCycle;
 }
 
-void ThreadPrecomputeSpends()
+void Precompute::SetThreads(int nNewThreads)
+{
+    nThreads = std::max(1, std::min(nNewThreads, MAX_PRECOMPUTE_THREADS));
+}
+
+int Precompute::GetThreads()
+{
+    return nThreads;
+}
+
+void Precompute::SetWorkerProgress(int nWorker, const PrecomputeWorkerProgress& progress)
+{
+    LOCK(cs_progress);
+    if (nWorker < (int)vWorkerProgress.size())
+        vWorkerProgress[nWorker] = progress;
+}
+
+std::vector<PrecomputeWorkerProgress> Precompute::GetWorkerProgress() const
+{
+    LOCK(cs_progress);
+    return vWorkerProgress;
+}
+
+uint64_t Precompute::RequestClear()
+{
+    WaitableLock lock(cs_clear);
+    return ++nClearRequested;
+}
+
+bool Precompute::WaitForWorkers(uint64_t nGeneration, int64_t nTimeoutMillis)
+{
+    WaitableLock lock(cs_clear);
+    return condClear.wait_for(lock, std::chrono::milliseconds(nTimeoutMillis), [this, nGeneration] {
+        for (uint64_t nSeen : vClearSeen) {
+            if (nSeen < nGeneration)
+                return false;
+        }
+        return true;
+    });
+}
+
+void Precompute::FinishClear(uint64_t nGeneration)
+{
+    {
+        WaitableLock lock(cs_clear);
+        nClearDone = std::max(nClearDone, nGeneration);
+    }
+    condClear.notify_all();
+}
+
+uint64_t Precompute::GetClearGeneration() const
+{
+    return nClearRequested;
+}
+
+void Precompute::AcknowledgeClear(int nWorker, uint64_t nGeneration)
+{
+    WaitableLock lock(cs_clear);
+    if (nWorker < (int)vClearSeen.size())
+        vClearSeen[nWorker] = std::max(vClearSeen[nWorker], nGeneration);
+    condClear.notify_all();
+
+    while (nClearDone < nGeneration) {
+        condClear.wait_for(lock, std::chrono::milliseconds(100));
+        boost::this_thread::interruption_point();
+    }
+}
+
+void Precompute::WorkerExited(int nWorker)
+{
+    {
+        WaitableLock lock(cs_clear);
+        if (nWorker < (int)vClearSeen.size())
+            vClearSeen[nWorker] = std::numeric_limits<uint64_t>::max();
+    }
+    condClear.notify_all();
+}
+
+void ThreadPrecomputeSpends(int nWorker, int nWorkers)
 {
     boost::this_thread::interruption_point();
-    LogPrintf("ThreadPrecomputeSpends started\n");
+    LogPrintf("ThreadPrecomputeSpends %d started\n", nWorker);
     auto pwallet = GetMainWallet();
 
     if (!pwallet) {
         LogPrintf("%s: pwallet is null cannot precompute\n", __func__);
+        pprecompute->WorkerExited(nWorker);
         return;
     }
 
     try {
-        pwallet->PrecomputeSpends();
+        pwallet->PrecomputeSpends(nWorker, nWorkers);
         boost::this_thread::interruption_point();
     }  catch (std::exception& e) {
         LogPrintf("ThreadPrecomputeSpends() exception\n");
     } catch (boost::thread_interrupted) {
         LogPrintf("ThreadPrecomputeSpends() interrupted\n");
     }
+    pprecompute->WorkerExited(nWorker);
 
     LogPrintf("ThreadPrecomputeSpends exiting,\n");
 }
@@ -7,23 +7,50 @@
 
 #include "lrucache.h"
 #include "boost/thread.hpp"
+#include <sync.h>
+
+#include <atomic>
 
 static const int DEFAULT_PRECOMPUTE_BPC = 100; // BPC = Blocks Per Cycle
 static const int MIN_PRECOMPUTE_BPC = 100;
 static const int MAX_PRECOMPUTE_BPC = 2000;
+static const int DEFAULT_PRECOMPUTE_THREADS = 1;
+static const int MAX_PRECOMPUTE_THREADS = 16;
+
+/** Progress of one precompute worker, as shown by showspendcaching */
+struct PrecomputeWorkerProgress
+{
+    int nMints = 0; // mints assigned to the worker
+    int nMintsUpdated = 0; // witnesses advanced in the last round
+    int nHeightPrecomputed = 0; // lowest height the witnesses of the worker are precomputed to
+    int64_t nRoundTime = 0; // duration of the last round in milliseconds
+};
 
 class Precompute
 {
 private:
-    int nBlocksPerCycle;
+    std::atomic<int> nBlocksPerCycle;
+    int nThreads;
     boost::thread_group* pthreadGroupPrecompute;
 
+    mutable CCriticalSection cs_progress;
+    std::vector<PrecomputeWorkerProgress> vWorkerProgress GUARDED_BY(cs_progress);
+
+    // Clearing the spend cache, the workers stop using it until the clear of their generation is done
+    CWaitableCriticalSection cs_clear;
+    CConditionVariable condClear;
+    std::atomic<uint64_t> nClearRequested;
+    uint64_t nClearDone GUARDED_BY(cs_clear);
+    std::vector<uint64_t> vClearSeen GUARDED_BY(cs_clear); // last generation each worker stopped for
+
 public:
 
     PrecomputeLRUCache lru;
 
     Precompute();
     void SetNull();
+    /** Apply -precomputeblockpercycle, -precomputethreads and -precomputecachesize */
+    void ReadArgs();
     boost::thread_group* GetThreadGroupPointer();
     void SetThreadGroupPointer(void* threadGroup);
     void SetThreadPointer();
@@ -32,9 +59,27 @@ public:
     void StopPrecomputing();
     void SetBlocksPerCycle(const int& nNewBlockPerCycle);
     int GetBlocksPerCycle();
+    void SetThreads(int nNewThreads);
+    int GetThreads();
+    void SetWorkerProgress(int nWorker, const PrecomputeWorkerProgress& progress);
+    std::vector<PrecomputeWorkerProgress> GetWorkerProgress() const;
+
+    /** Ask the workers to stop using the spend cache, returns the generation of the request */
+    uint64_t RequestClear();
+    /** Wait until every running worker has stopped using the spend cache for the clear nGeneration */
+    bool WaitForWorkers(uint64_t nGeneration, int64_t nTimeoutMillis);
+    /** Let the workers use the spend cache again once it has been cleared */
+    void FinishClear(uint64_t nGeneration);
+
+    /** Generation of the last clear that was requested, checked by the workers between steps */
+    uint64_t GetClearGeneration() const;
+    /** Report that a worker stopped using the spend cache, and block it until the clear is finished */
+    void AcknowledgeClear(int nWorker, uint64_t nGeneration);
+    /** Report that a worker exited, so that clears do not wait for it */
+    void WorkerExited(int nWorker);
 };
 
-void ThreadPrecomputeSpends();
+void ThreadPrecomputeSpends(int nWorker, int nWorkers);
 void LinkPrecomputeThreadGroup(void* pthreadgroup);
 void DumpPrecomputes();
 
@@ -164,7 +164,7 @@ bool CPrecomputeDB::LoadPrecomputes(PrecomputeLRUCache* lru)
             }
 
             lru->AddNew(key.second, data);
-            if (lru->Size() == PRECOMPUTE_LRU_CACHE_SIZE)
+            if (lru->IsFull())
                 break;
 
             pcursor->Next();
@@ -240,6 +240,15 @@ bool CPrecomputeDB::WritePrecompute(const uint256& hash, const CoinWitnessCacheD
 {
     return Write(std::make_pair('P', hash), data);
 }
+bool CPrecomputeDB::WritePrecomputes(const std::vector<std::pair<uint256, CoinWitnessCacheData>>& vPrecomputes, const std::vector<uint256>& vErase)
+{
+    CDBBatch batch(*this);
+    for (const auto& precompute : vPrecomputes)
+        batch.Write(std::make_pair('P', precompute.first), precompute.second);
+    for (const uint256& hash : vErase)
+        batch.Erase(std::make_pair('P', hash));
+    return WriteBatch(batch);
+}
 bool CPrecomputeDB::ReadPrecompute(const uint256& hash, CoinWitnessCacheData& data)
 {
     return Read(std::make_pair('P', hash), data);
@@ -8,8 +8,6 @@
 #include "serialize.h"
 #include <dbwrapper.h>
 
-#define PRECOMPUTE_LRU_CACHE_SIZE 2000
-#define PRECOMPUTE_MAX_DIRTY_CACHE_SIZE 1000
 #define PRECOMPUTE_FLUSH_TIME 3600 // 1 Hour
 
 class CoinWitnessCacheData;
@@ -94,6 +92,7 @@ public:
     bool LoadPrecomputes(std::set<uint256> setHashes);
     bool EraseAllPrecomputes();
     bool WritePrecompute(const uint256& hash, const CoinWitnessCacheData& data);
+    bool WritePrecomputes(const std::vector<std::pair<uint256, CoinWitnessCacheData>>& vPrecomputes, const std::vector<uint256>& vErase);
     bool ReadPrecompute(const uint256& hash, CoinWitnessCacheData& data);
     bool ErasePrecompute(const uint256& hash);
 };
@@ -6,6 +6,7 @@
 #include <version.h>
 #include <tinyformat.h>
 #include "zchain.h"
+#include "accumulators.h"
 #include "libzerocoin/Params.h"
 #include "txdb.h"
 #include "chainparams.h"
@@ -14,6 +15,11 @@
 #include "primitives/zerocoin.h"
 #include "ui_interface.h"
 #include "mintmeta.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <atomic>
+#include <mutex>
 
 #include <boost/thread.hpp>
 
@@ -76,46 +82,249 @@ bool BlockToPubcoinList(const CBlock& block, std::list<libzerocoin::PublicCoin>&
     return true;
 }
 
-bool ThreadedBatchVerify(const std::vector<libzerocoin::SerialNumberSoKProof>* pvProofs, int nThreads)
+static bool GetBlockPubcoins(const CBlockIndex* pindex, const std::vector<libzerocoin::CoinDenomination>& vDenoms,
+        std::list<libzerocoin::PublicCoin>& listPubcoins)
+{
+    auto zerocoinParams = Params().Zerocoin_Params();
+
+    // Read the mints from the pubcoin index, which only needs the denominations this block has minted
+    std::list<libzerocoin::PublicCoin> listIndexed;
+    bool fIndexed = true;
+    for (auto denom : vDenoms) {
+        if (!pindex->MintedDenomination(denom))
+            continue;
+
+        uint256 hashBlock;
+        std::vector<CBigNum> vValues;
+        if (!pzerocoinDB->ReadBlockPubcoins(pindex->nHeight, denom, hashBlock, vValues) || hashBlock != pindex->GetBlockHash()) {
+            fIndexed = false;
+            break;
+        }
+
+        for (const CBigNum& bnValue : vValues)
+            listIndexed.emplace_back(zerocoinParams, bnValue, denom);
+    }
+
+    if (fIndexed) {
+        listPubcoins.splice(listPubcoins.end(), listIndexed);
+        return true;
+    }
+
+    // The block is not indexed yet, read its mints from disk
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
+        return error("%s: failed to read block %d from disk", __func__, pindex->nHeight);
+
+    std::list<libzerocoin::PublicCoin> listBlock;
+    if (!BlockToPubcoinList(block, listBlock))
+        return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
+
+    for (const auto& pubcoin : listBlock) {
+        if (std::count(vDenoms.begin(), vDenoms.end(), pubcoin.getDenomination()))
+            listPubcoins.emplace_back(pubcoin);
+    }
+
+    return true;
+}
+
+bool GetBlockPubcoins(const CBlockIndex* pindex, std::list<libzerocoin::PublicCoin>& listPubcoins)
+{
+    return GetBlockPubcoins(pindex, libzerocoin::zerocoinDenomList, listPubcoins);
+}
+
+bool GetBlockPubcoins(const CBlockIndex* pindex, libzerocoin::CoinDenomination denom, std::list<libzerocoin::PublicCoin>& listPubcoins)
+{
+    return GetBlockPubcoins(pindex, std::vector<libzerocoin::CoinDenomination>(1, denom), listPubcoins);
+}
+
+bool WriteBlockPubcoins(const CBlockIndex* pindex, const std::list<libzerocoin::PublicCoin>& listPubcoins)
+{
+    std::map<libzerocoin::CoinDenomination, std::vector<CBigNum>> mapPubcoins;
+    for (const auto& pubcoin : listPubcoins)
+        mapPubcoins[pubcoin.getDenomination()].emplace_back(pubcoin.getValue());
+
+    return pzerocoinDB->WriteBlockPubcoins(pindex->nHeight, pindex->GetBlockHash(), mapPubcoins);
+}
+
+bool CBatchVerifyCheck::operator()()
+{
+    if (!vProofs.empty() && !libzerocoin::SerialNumberSoKProof::BatchVerify(vProofs))
+        return false;
+
+    if (!vSpends.empty()) {
+        std::string strError;
+        if (!libzerocoin::CoinSpend::BatchVerify(*accumulator, vSpends, strError))
+            return error("%s: %s", __func__, strError);
+    }
+
+    return true;
+}
+
+// Long lived pool that every caller of ThreadedBatchVerify() submits its proof groups to
+static CCheckQueue<CBatchVerifyCheck> batchverifyqueue(1);
+
+static std::atomic<uint64_t> nBatchVerifyCalls(0);
+static std::atomic<uint64_t> nBatchVerifyProofs(0);
+static std::atomic<uint64_t> nBatchVerifyFailures(0);
+static std::atomic<uint64_t> nBatchVerifyQueued(0);
+static std::atomic<int64_t> nBatchVerifyLastMicros(0);
+static std::atomic<int64_t> nBatchVerifyTotalMicros(0);
+static std::atomic<int64_t> nBatchVerifyWaitMicros(0);
+
+void ThreadBatchVerify()
+{
+    RenameThread("veil-batchverify");
+    batchverifyqueue.Thread();
+}
+
+BatchVerifyStats GetBatchVerifyStats()
+{
+    BatchVerifyStats stats;
+    stats.nCalls = nBatchVerifyCalls;
+    stats.nProofs = nBatchVerifyProofs;
+    stats.nFailures = nBatchVerifyFailures;
+    stats.nQueued = nBatchVerifyQueued;
+    stats.nLastMicros = nBatchVerifyLastMicros;
+    stats.nTotalMicros = nBatchVerifyTotalMicros;
+    stats.nWaitMicros = nBatchVerifyWaitMicros;
+    return stats;
+}
+
+// Assume that it doesn't give any gain to multithread, unless each thread has at least 6 proofs
+static const int BATCHVERIFY_THREAD_EFFICIENCY = 7;
+
+static int BatchVerifyThreads(size_t nProofs, int nThreads)
 {
     int64_t nMaxThreads = gArgs.GetArg("-threadbatchverify", DEFAULT_BATCHVERIFY_THREADS);
     if (nThreads != -1)
         nMaxThreads = nThreads;
 
-    // Assume that it doesn't give any gain to multithread, unless each thread has at least 6 proofs
-    int nThreadEfficiency = 7;
-
-    std::vector<std::vector<const libzerocoin::SerialNumberSoKProof*>> vProofGroups(1);
     int nThreadsUsed = 1;
-    if ((int)pvProofs->size() > nThreadEfficiency)
-        nThreadsUsed = pvProofs->size() / nThreadEfficiency;
+    if ((int)nProofs > BATCHVERIFY_THREAD_EFFICIENCY)
+        nThreadsUsed = nProofs / BATCHVERIFY_THREAD_EFFICIENCY;
     if (nThreadsUsed > nMaxThreads)
         nThreadsUsed = nMaxThreads;
+    if (nThreadsUsed < 1)
+        nThreadsUsed = 1;
+    return nThreadsUsed;
+}
 
-    vProofGroups.resize(nThreadsUsed);
-    std::vector<uint8_t> vReturn(nThreadsUsed);
-    int nThreadSelected = 0;
+static bool RunBatchVerifyChecks(std::vector<CBatchVerifyCheck>& vChecks, size_t nProofs)
+{
+    int64_t nTimeStart = GetTimeMicros();
+    nBatchVerifyQueued += nProofs;
+    bool fVerified;
+    {
+        // Only one caller can use the queue at a time, the others wait here until it is free. The master thread
+        // joins the workers, and the queue stops handing out groups as soon as one of them fails to verify.
+        CCheckQueueControl<CBatchVerifyCheck> control(&batchverifyqueue);
+        nBatchVerifyWaitMicros += GetTimeMicros() - nTimeStart;
+        control.Add(vChecks);
+        fVerified = control.Wait();
+    }
+    nBatchVerifyQueued -= nProofs;
 
+    int64_t nTimeElapsed = GetTimeMicros() - nTimeStart;
+    nBatchVerifyCalls++;
+    nBatchVerifyProofs += nProofs;
+    nBatchVerifyLastMicros = nTimeElapsed;
+    nBatchVerifyTotalMicros += nTimeElapsed;
+    if (!fVerified)
+        nBatchVerifyFailures++;
+
+    return fVerified;
+}
+
+bool ThreadedBatchVerify(const std::vector<libzerocoin::SerialNumberSoKProof>* pvProofs, int nThreads)
+{
+    int nThreadsUsed = BatchVerifyThreads(pvProofs->size(), nThreads);
+
+    std::vector<CBatchVerifyCheck> vChecks(nThreadsUsed);
+    int nThreadSelected = 0;
     for (unsigned int i = 0; i < pvProofs->size(); i++) {
-        vProofGroups[nThreadSelected].emplace_back(&pvProofs->at(i));
+        vChecks[nThreadSelected].vProofs.emplace_back(&pvProofs->at(i));
         nThreadSelected++;
         if (nThreadSelected >= nThreadsUsed)
             nThreadSelected = 0;
     }
 
-    boost::thread_group* pthreadgroup = new boost::thread_group();
-    for (unsigned int i = 0; i < vProofGroups.size(); i++) {
-        pthreadgroup->create_thread(boost::bind(&libzerocoin::SerialNumberSoKProof::BatchVerify, vProofGroups[i], &vReturn[i]));
+    return RunBatchVerifyChecks(vChecks, pvProofs->size());
+}
+
+bool ThreadedBatchVerifySpends(const std::vector<std::shared_ptr<libzerocoin::CoinSpend>>* pvSpends, int nThreads)
+{
+    // The accumulator and commitment proofs are combined per accumulator, so group the spends by the
+    // denomination and checkpoint of their accumulator
+    std::map<std::pair<libzerocoin::CoinDenomination, uint256>, std::vector<const libzerocoin::CoinSpend*>> mapGroups;
+    for (const auto& spend : *pvSpends)
+        mapGroups[std::make_pair(spend->getDenomination(), spend->getAccumulatorChecksum())].emplace_back(spend.get());
+
+    int nThreadsUsed = BatchVerifyThreads(pvSpends->size(), nThreads);
+
+    std::vector<CBatchVerifyCheck> vChecks;
+    for (const auto& group : mapGroups) {
+        CBigNum bnAccumulatorValue;
+        if (!pzerocoinDB->ReadAccumulatorValue(group.first.second, bnAccumulatorValue))
+            return error("%s: Cannot find accumulator checkpoint in zerocoinDB", __func__);
+        auto accumulator = std::make_shared<const libzerocoin::Accumulator>(Params().Zerocoin_Params(),
+                group.first.first, bnAccumulatorValue);
+
+        // Large groups are split between the threads, each part shares the accumulator
+        const std::vector<const libzerocoin::CoinSpend*>& vSpends = group.second;
+        int nParts = std::max(1, std::min(nThreadsUsed, (int)vSpends.size() / BATCHVERIFY_THREAD_EFFICIENCY));
+        for (int nPart = 0; nPart < nParts; nPart++) {
+            vChecks.emplace_back();
+            vChecks.back().accumulator = accumulator;
+            for (unsigned int i = nPart; i < vSpends.size(); i += nParts)
+                vChecks.back().vSpends.emplace_back(vSpends[i]);
+        }
     }
 
-    pthreadgroup->join_all();
+    return RunBatchVerifyChecks(vChecks, pvSpends->size());
+}
 
-    for (auto ret : vReturn) {
-        if (ret != 1)
-            return false;
-    }
+/**
+ * Builds and verifies the spend of every job, all bound to ptxHash, on up to nThreads threads including the
+ * calling one. Each job only touches its own coin, accumulator and witness, so no locks are taken.
+ * fnProgress is called with the number of jobs done after each one. Returns false if any job failed.
+ */
+bool ThreadedCreateCoinSpends(const libzerocoin::ZerocoinParams* params, std::vector<CoinSpendJob>& vJobs, const uint256& ptxHash,
+        int nThreads, const std::function<void(size_t)>& fnProgress)
+{
+    std::atomic<size_t> nNextJob(0);
+    std::atomic<bool> fAllValid(true);
+    std::mutex mutexProgress;
+    size_t nJobsDone = 0;
+    auto build = [&]() {
+        for (size_t i = nNextJob++; i < vJobs.size(); i = nNextJob++) {
+            CoinSpendJob& job = vJobs[i];
+            try {
+                job.spend.reset(new libzerocoin::CoinSpend(params, *job.coin, *job.accumulator, job.nChecksum, *job.witness,
+                        ptxHash, job.spendType, job.nVersion));
+                if (!job.spend->Verify(*job.accumulator, job.strError, true, job.nVersion == libzerocoin::CoinSpend::V4_LIMP))
+                    job.spend.reset();
+            } catch (const std::exception& e) {
+                job.strError = e.what();
+                job.spend.reset();
+            }
+            if (!job.spend)
+                fAllValid = false;
 
-    return true;
+            std::lock_guard<std::mutex> lock(mutexProgress);
+            nJobsDone++;
+            if (fnProgress)
+                fnProgress(nJobsDone);
+        }
+    };
+
+    nThreads = std::max(1, std::min(nThreads, (int)vJobs.size()));
+    boost::thread_group buildThreads;
+    for (int i = 1; i < nThreads; i++)
+        buildThreads.create_thread(build);
+    build();
+    buildThreads.join_all();
+
+    return fAllValid;
 }
 
 bool TxToPubcoinHashSet(const CTransaction* tx, std::set<uint256>& setHashes)
@@ -327,6 +536,7 @@ std::string ReindexZerocoinDB()
     CBlockIndex* pindex = chainActive[0];
     std::map<libzerocoin::CoinSpend, uint256> mapSpends;
     std::map<libzerocoin::PublicCoin, uint256> mapMints;
+    AccumulatorMap mapAccumulators(zerocoinParams);
     while (pindex) {
         uiInterface.ShowProgress(_("Reindexing zerocoin database..."), std::max(1, std::min(99,
                 (int)((double) (pindex->nHeight) / (double)(chainActive.Height()) * 100))), false);
@@ -374,6 +584,32 @@ std::string ReindexZerocoinDB()
             }
         }
 
+        // Build the pubcoin index of the blocks with mints
+        if (pindex->HasMints()) {
+            std::list<libzerocoin::PublicCoin> listPubcoins;
+            if (!BlockToPubcoinList(block, listPubcoins) || !WriteBlockPubcoins(pindex, listPubcoins))
+                return _("Error writing zerocoinDB to disk");
+        }
+
+        // Recalculate accumulator checkpoints whose values are missing from the zerocoinDB. The previous
+        // checkpoint has been restored by then, and the denominations are accumulated in parallel.
+        if (pindex->nHeight > 10 && pindex->nHeight % 10 == 0) {
+            bool fMissingValue = false;
+            for (const auto& checkpoint : pindex->GetAccumulatorHashes()) {
+                CBigNum bnValue;
+                if (checkpoint.second != uint256() && !pzerocoinDB->ReadAccumulatorValue(checkpoint.second, bnValue)) {
+                    fMissingValue = true;
+                    break;
+                }
+            }
+
+            if (fMissingValue) {
+                if (!ValidateAccumulatorCheckpoint(block, pindex, mapAccumulators))
+                    return _("Failed to recalculate accumulator checkpoint");
+                DatabaseChecksums(mapAccumulators);
+            }
+        }
+
         // Flush the zerocoinDB to disk every 100 blocks
         if (pindex->nHeight % 100 == 0) {
             if ((!mapSpends.empty() && !pzerocoinDB->WriteCoinSpendBatch(mapSpends)) || (!mapMints.empty()
@@ -9,6 +9,8 @@
 #include "libzerocoin/Coin.h"
 #include "libzerocoin/Denominations.h"
 #include "libzerocoin/CoinSpend.h"
+#include <checkqueue.h>
+#include <functional>
 #include <list>
 #include <string>
 #include <primitives/transaction.h>
@@ -24,8 +26,57 @@ class CValidationState;
 class CZerocoinMint;
 class uint256;
 
+/**
+ * A group of proofs that are batch verified together by one worker: either serial number signatures of
+ * knowledge, or the commitment and accumulator proofs of spends that use the same accumulator.
+ */
+class CBatchVerifyCheck
+{
+public:
+    std::vector<const libzerocoin::SerialNumberSoKProof*> vProofs;
+    std::shared_ptr<const libzerocoin::Accumulator> accumulator;
+    std::vector<const libzerocoin::CoinSpend*> vSpends;
+
+    bool operator()();
+    void swap(CBatchVerifyCheck& check)
+    {
+        vProofs.swap(check.vProofs);
+        accumulator.swap(check.accumulator);
+        vSpends.swap(check.vSpends);
+    }
+};
+
+/** Counters for the zerocoin batch verification pool */
+struct BatchVerifyStats
+{
+    uint64_t nCalls;        //! Number of ThreadedBatchVerify() calls completed
+    uint64_t nProofs;       //! Number of proofs verified
+    uint64_t nFailures;     //! Number of calls that failed verification
+    uint64_t nQueued;       //! Proofs currently waiting for, or being processed by, the pool
+    int64_t nLastMicros;    //! Latency of the most recent call
+    int64_t nTotalMicros;   //! Total latency of all calls
+    int64_t nWaitMicros;    //! Total time spent waiting for the pool to become free
+};
+
+/** The inputs of one spend built by ThreadedCreateCoinSpends(), and the spend once it is built */
+struct CoinSpendJob
+{
+    const libzerocoin::PrivateCoin* coin = nullptr;
+    libzerocoin::Accumulator* accumulator = nullptr;
+    uint256 nChecksum;
+    const libzerocoin::AccumulatorWitness* witness = nullptr;
+    libzerocoin::SpendType spendType = libzerocoin::SpendType::SPEND;
+    uint8_t nVersion = libzerocoin::CoinSpend::V3_SMALL_SOK;
+
+    std::unique_ptr<libzerocoin::CoinSpend> spend;  //! Null if the spend could not be built or did not verify
+    std::string strError;
+};
+
 bool BlockToMintValueVector(const CBlock& block, const libzerocoin::CoinDenomination denom, std::vector<CBigNum>& vValues);
 bool BlockToPubcoinList(const CBlock& block, std::list<libzerocoin::PublicCoin>& listPubcoins);
+bool GetBlockPubcoins(const CBlockIndex* pindex, std::list<libzerocoin::PublicCoin>& listPubcoins);
+bool GetBlockPubcoins(const CBlockIndex* pindex, libzerocoin::CoinDenomination denom, std::list<libzerocoin::PublicCoin>& listPubcoins);
+bool WriteBlockPubcoins(const CBlockIndex* pindex, const std::list<libzerocoin::PublicCoin>& listPubcoins);
 bool TxToPubcoinHashSet(const CTransaction* tx, std::set<uint256>& setHashes);
 bool TxToSerialHashSet(const CTransaction* tx, std::set<uint256>& setHashes);
 bool BlockToZerocoinMintList(const CBlock& block, std::list<CZerocoinMint>& vMints);
@@ -43,6 +94,11 @@ std::string ReindexZerocoinDB();
 std::shared_ptr<libzerocoin::CoinSpend> TxInToZerocoinSpend(const CTxIn& txin);
 bool OutputToPublicCoin(const CTxOutBase* out, libzerocoin::PublicCoin& coin);
 bool ThreadedBatchVerify(const std::vector<libzerocoin::SerialNumberSoKProof>* vProofs, int nThreads = -1);
+bool ThreadedBatchVerifySpends(const std::vector<std::shared_ptr<libzerocoin::CoinSpend>>* vSpends, int nThreads = -1);
+void ThreadBatchVerify();
+bool ThreadedCreateCoinSpends(const libzerocoin::ZerocoinParams* params, std::vector<CoinSpendJob>& vJobs, const uint256& ptxHash,
+        int nThreads, const std::function<void(size_t)>& fnProgress = nullptr);
+BatchVerifyStats GetBatchVerifyStats();
 bool TxOutToPublicCoin(const CTxOut& txout, libzerocoin::PublicCoin& pubCoin);
 std::list<libzerocoin::CoinDenomination> ZerocoinSpendListFromBlock(const CBlock& block);
 
@@ -110,41 +110,56 @@ void CzWallet::GenerateMintPool(uint32_t nCountStart, uint32_t nCountEnd)
     if (nCountEnd > 0)
         nStop = std::max(n, n + nCountEnd);
 
-    bool fFound;
-
     if (!mapMasterSeeds.count(seedMasterID)) {
         LogPrintf("%s: do not have master seed with ID %s loaded!", __func__, seedMasterID.GetHex());
         return;
     }
 
     LogPrintf("%s : n=%d nStop=%d\n", __func__, n, nStop - 1);
+
+    // Prevent unnecessary repeated minted, counts loaded from the db are either still in the pool or already used
+    std::vector<uint32_t> vCounts;
     for (uint32_t i = n; i < nStop; ++i) {
-        if (ShutdownRequested())
-            return;
+        if (!mintPool.HasCount(i))
+            vCounts.emplace_back(i);
+    }
 
-        fFound = false;
+    if (vCounts.empty())
+        return;
 
-        // Prevent unnecessary repeated minted
-        for (auto& pair : mintPool) {
-            if(pair.second == i) {
-                fFound = true;
-                break;
-            }
+    // Each count is derived on its own, so spread the prime searches over the cores
+    std::vector<CBigNum> vValues(vCounts.size());
+    int nThreads = std::max(1, std::min(GetNumCores(), (int)vCounts.size()));
+    auto generate = [&](int nThread) {
+        for (size_t j = nThread; j < vCounts.size(); j += nThreads) {
+            if (ShutdownRequested())
+                return;
+
+            uint512 seedZerocoin = GetZerocoinSeed(seedMasterID, vCounts[j]);
+            CBigNum bnSerial;
+            CBigNum bnRandomness;
+            CKey key;
+            SeedToZerocoin(seedZerocoin, vValues[j], bnSerial, bnRandomness, key);
         }
+    };
 
-        if(fFound)
-            continue;
+    // The zerocoin params are initialized on first use, do that before the threads share them
+    Params().Zerocoin_Params();
+    boost::thread_group generateThreads;
+    for (int i = 1; i < nThreads; i++)
+        generateThreads.create_thread([&generate, i]() { generate(i); });
+    generate(0);
+    generateThreads.join_all();
 
-        uint512 seedZerocoin = GetZerocoinSeed(seedMasterID, i);
-        CBigNum bnValue;
-        CBigNum bnSerial;
-        CBigNum bnRandomness;
-        CKey key;
-        SeedToZerocoin(seedZerocoin, bnValue, bnSerial, bnRandomness, key);
+    if (ShutdownRequested())
+        return;
 
-        mintPool.Add(bnValue, i);
-        WalletBatch(*walletDatabase).WriteMintPoolPair(seedMasterID, GetPubCoinHash(bnValue), i);
-        LogPrintf("%s : %s count=%d\n", __func__, bnValue.GetHex().substr(0, 6), i);
+    // Add in count order, so the pool and the db end up the same as when generating one at a time
+    WalletBatch walletdb(*walletDatabase);
+    for (size_t j = 0; j < vCounts.size(); j++) {
+        mintPool.Add(vValues[j], vCounts[j]);
+        walletdb.WriteMintPoolPair(seedMasterID, GetPubCoinHash(vValues[j]), vCounts[j]);
+        LogPrintf("%s : %s count=%d\n", __func__, vValues[j].GetHex().substr(0, 6), vCounts[j]);
     }
 }
 
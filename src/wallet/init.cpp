@@ -46,6 +46,7 @@ void WalletInit::AddWalletOptions() const
     gArgs.AddArg("-salvagewallet", "Attempt to recover private keys from a corrupt wallet on startup", false, OptionsCategory::WALLET);
     gArgs.AddArg("-spendzeroconfchange", strprintf("Spend unconfirmed change when sending transactions (default: %u)", DEFAULT_SPEND_ZEROCONF_CHANGE), false, OptionsCategory::WALLET);
     gArgs.AddArg("-staking", strprintf("Enable stake mining (default: %d)", true), false, OptionsCategory::WALLET);
+    gArgs.AddArg("-stakeprepare=<n>", strprintf("Build the spend proofs of the <n> largest staking candidates ahead of the kernel search, 0 to disable (default: %d)", DEFAULT_STAKE_PREPARE), false, OptionsCategory::WALLET);
     gArgs.AddArg("-txconfirmtarget=<n>", strprintf("If paytxfee is not set, include enough fee so transactions begin confirmation on average within n blocks (default: %u)", DEFAULT_TX_CONFIRM_TARGET), false, OptionsCategory::WALLET);
     gArgs.AddArg("-upgradewallet", "Upgrade wallet to latest format on startup", false, OptionsCategory::WALLET);
     gArgs.AddArg("-wallet=<path>", "Specify wallet database path. Can be specified multiple times to load multiple wallets. Path is interpreted relative to <walletdir> if it is not absolute, and will be created if it does not exist (as a directory containing a wallet.dat file and log files). For backwards compatibility this will also accept names of existing data files in <walletdir>.)", false, OptionsCategory::WALLET);
@@ -67,6 +68,8 @@ void WalletInit::AddWalletOptions() const
 
     gArgs.AddArg("-precompute=<n>", strprintf("Enable the wallet to start solving zerocoin spend proofs inorder to make staking and spending zerocoin faster (default: %u)", false), false, OptionsCategory::WALLET);
     gArgs.AddArg("-precomputeblockpercycle=<n>", strprintf("Set the number of included blocks to precompute per cycle. (minimum: %d) (maximum: %d) (default: %d)", MIN_PRECOMPUTE_BPC, DEFAULT_PRECOMPUTE_BPC, MIN_PRECOMPUTE_BPC), false, OptionsCategory::WALLET);
+    gArgs.AddArg("-precomputecachesize=<n>", strprintf("Set the memory used to cache precomputed zerocoin spend proofs in MiB (minimum: %d) (default: %d)", MIN_PRECOMPUTE_CACHE_SIZE, DEFAULT_PRECOMPUTE_CACHE_SIZE), false, OptionsCategory::WALLET);
+    gArgs.AddArg("-precomputethreads=<n>", strprintf("Set the number of threads that precompute zerocoin spend proofs, each one takes a share of the mints (maximum: %d) (default: %d)", MAX_PRECOMPUTE_THREADS, DEFAULT_PRECOMPUTE_THREADS), false, OptionsCategory::WALLET);
 
 }
 
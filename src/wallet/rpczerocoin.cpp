@@ -1354,6 +1354,16 @@ UniValue showspendcaching(const JSONRPCRequest& request)
                                                    "    \"total_blocks_computed\": n,      (numeric) Number of blocks precomputed.\n"
                                                    "    \"total_blocks_to_compute\": n,    (numeric) Number of blocks to precompute\n"
                                                    "    \"percent_precomputed\": n,        (numeric) Number representing total precomputed percentage\n"
+                                                   "    \"workers\": [                     (array) Progress of each precompute thread\n"
+                                                   "      {\n"
+                                                   "        \"worker\": n,                 (numeric) Index of the precompute thread\n"
+                                                   "        \"mints\": n,                  (numeric) Number of zerocoins assigned to the thread\n"
+                                                   "        \"mints_updated\": n,          (numeric) Number of zerocoins precomputed further in the last round\n"
+                                                   "        \"precomputed_to\": n,         (numeric) Lowest block height the zerocoins of the thread are precomputed to\n"
+                                                   "        \"round_time_ms\": n,          (numeric) Duration of the last round in milliseconds\n"
+                                                   "      }\n"
+                                                   "      ,...\n"
+                                                   "    ]\n"
                                                    "  }\n"
 
                                                    "\nResult: if fVerbose is true\n"
@@ -1418,6 +1428,21 @@ UniValue showspendcaching(const JSONRPCRequest& request)
         objTotal.pushKV("total_blocks_computed", nTotalAccumulated);
         objTotal.pushKV("total_blocks_to_compute", nTotalToAccumulate);
         objTotal.pushKV("percent_precomputed", (nTotalAccumulated / nTotalToAccumulate) * 100);
+
+        UniValue arrWorkers(UniValue::VARR);
+        if (pprecompute) {
+            std::vector<PrecomputeWorkerProgress> vProgress = pprecompute->GetWorkerProgress();
+            for (unsigned int i = 0; i < vProgress.size(); i++) {
+                UniValue objWorker(UniValue::VOBJ);
+                objWorker.pushKV("worker", (int)i);
+                objWorker.pushKV("mints", vProgress[i].nMints);
+                objWorker.pushKV("mints_updated", vProgress[i].nMintsUpdated);
+                objWorker.pushKV("precomputed_to", vProgress[i].nHeightPrecomputed);
+                objWorker.pushKV("round_time_ms", vProgress[i].nRoundTime);
+                arrWorkers.push_back(objWorker);
+            }
+        }
+        objTotal.pushKV("workers", arrWorkers);
         arrRet.push_back(objTotal);
     }
 
@@ -1508,6 +1533,52 @@ UniValue searchdeterministiczerocoin(const JSONRPCRequest& request)
     return "done";
 }
 
+UniValue getprecomputecacheinfo(const JSONRPCRequest& request)
+{
+    UniValue params = request.params;
+    if(request.fHelp || params.size() != 0)
+        throw runtime_error(
+                "getprecomputecacheinfo\n"
+                "\nReturns the state of the cache of precomputed zerocoin spend proofs\n"
+
+                "\nResult:\n"
+                "{\n"
+                "  \"entries\": n,              (numeric) Number of precomputes in the cache\n"
+                "  \"dirty_entries\": n,        (numeric) Number of precomputes that are not written to the database yet\n"
+                "  \"usage\": n,                (numeric) Memory used by the cache in bytes\n"
+                "  \"max_usage\": n,            (numeric) Memory budget of the cache in bytes\n"
+                "  \"hits\": n,                 (numeric) Number of lookups that found the precompute in the cache\n"
+                "  \"misses\": n,               (numeric) Number of lookups that did not find the precompute in the cache\n"
+                "  \"evictions\": n,            (numeric) Number of precomputes evicted to stay within the budget\n"
+                "  \"flushes\": n,              (numeric) Number of times the dirty precomputes were written to the database\n"
+                "  \"flushed_entries\": n,      (numeric) Number of precomputes written to the database\n"
+                "  \"last_flush_ms\": n,        (numeric) Duration of the last flush in milliseconds\n"
+                "  \"total_flush_ms\": n,       (numeric) Total duration of the flushes in milliseconds\n"
+                "}\n"
+
+                "\nExamples\n" +
+                HelpExampleCli("getprecomputecacheinfo", "") + HelpExampleRpc("getprecomputecacheinfo", ""));
+
+    if (!pprecompute)
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Precompute pointer not initialized");
+
+    PrecomputeCacheStats stats = pprecompute->lru.GetStats();
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("entries", (uint64_t)stats.nEntries);
+    ret.pushKV("dirty_entries", (uint64_t)stats.nDirtyEntries);
+    ret.pushKV("usage", (uint64_t)stats.nUsage);
+    ret.pushKV("max_usage", (uint64_t)stats.nMaxUsage);
+    ret.pushKV("hits", stats.nHits);
+    ret.pushKV("misses", stats.nMisses);
+    ret.pushKV("evictions", stats.nEvictions);
+    ret.pushKV("flushes", stats.nFlushes);
+    ret.pushKV("flushed_entries", stats.nEntriesFlushed);
+    ret.pushKV("last_flush_ms", stats.nLastFlushTime / 1000);
+    ret.pushKV("total_flush_ms", stats.nTotalFlushTime / 1000);
+
+    return ret;
+}
+
 UniValue startprecomputing(const JSONRPCRequest& request)
 {
     std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
@@ -1637,28 +1708,38 @@ UniValue clearspendcache(const JSONRPCRequest& request)
     if (!zTracker)
         throw JSONRPCError(RPC_WALLET_ERROR, "zTracker pointer is null");
 
-    {
-        int nTries = 0;
-        fClearSpendCache = true;
-        // In order to make it so other processes don't use the cache and cause pointer failures.
-        // Sleep the main thread, while the precompute thread clears the cache
-        MilliSleep(3000);
-        while (nTries < 100) {
-            TRY_LOCK(zTracker->cs_modify_lock, fLocked);
-            if (fLocked) {
-                zTracker->ClearSpendCache();
-                if(!pprecomputeDB->EraseAllPrecomputes())
-                    throw JSONRPCError(RPC_WALLET_ERROR, "Spend database not cleared");
+    if (!pprecompute)
+        throw JSONRPCError(RPC_WALLET_ERROR, "Precompute pointer is null");
+
+    // In order to make it so other processes don't use the cache and cause pointer failures,
+    // wait until every precompute worker has let go of the cache before clearing it
+    uint64_t nClearGeneration = pprecompute->RequestClear();
+    if (!pprecompute->WaitForWorkers(nClearGeneration, 60 * 1000)) {
+        pprecompute->FinishClear(nClearGeneration);
+        throw JSONRPCError(RPC_WALLET_ERROR, "Error: Spend cache not cleared, the precompute workers are busy");
+    }
 
+    std::string strError = "Error: Spend cache not cleared!";
+    int nTries = 0;
+    while (nTries < 100) {
+        TRY_LOCK(zTracker->cs_modify_lock, fLocked);
+        if (fLocked) {
+            zTracker->ClearSpendCache();
+            pprecompute->lru.Clear();
+            if (pprecomputeDB->EraseAllPrecomputes()) {
+                pprecompute->FinishClear(nClearGeneration);
                 return "Successfully Cleared the Precompute Spend Cache and Database";
-            } else {
-                fGlobalUnlockSpendCache = true;
-                nTries++;
-                MilliSleep(100);
             }
+            strError = "Spend database not cleared";
+            break;
+        } else {
+            fGlobalUnlockSpendCache = true;
+            nTries++;
+            MilliSleep(100);
         }
     }
-    throw JSONRPCError(RPC_WALLET_ERROR, "Error: Spend cache not cleared!");
+    pprecompute->FinishClear(nClearGeneration);
+    throw JSONRPCError(RPC_WALLET_ERROR, strError);
 }
 
 static const CRPCCommand commands[] =
@@ -1685,6 +1766,7 @@ static const CRPCCommand commands[] =
     { "zerocoin",           "getzerocoinbalance",               &getzerocoinbalance,            {} },
     { "zerocoin",           "showspendcaching",                 &showspendcaching,              {"fVerbose"} },
     { "zerocoin",           "startprecomputing",                &startprecomputing,             {"nBlockPerCycle"} },
+    { "zerocoin",           "getprecomputecacheinfo",           &getprecomputecacheinfo,        {} },
     { "zerocoin",           "stopprecomputing",                 &stopprecomputing,              {} },
     { "zerocoin",           "setprecomputeblockpercycle",       &setprecomputeblockpercycle,    {"nBlockPerCycle"} },
     { "zerocoin",           "getprecomputeblockpercycle",       &getprecomputeblockpercycle,    {} },
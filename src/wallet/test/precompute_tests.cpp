@@ -0,0 +1,138 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/server.h>
+#include <util.h>
+#include <validation.h>
+#include <veil/zerocoin/lrucache.h>
+#include <veil/zerocoin/precompute.h>
+#include <wallet/test/wallet_test_fixture.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(precompute_tests, WalletTestingSetup)
+
+static CoinWitnessCacheData RandomCacheData()
+{
+    CoinWitnessCacheData data;
+    data.nHeightPrecomputed = 100;
+    data.coinAmount = CBigNum::randKBitBignum(1024);
+    data.accumulatorAmount = CBigNum::randKBitBignum(3072);
+    return data;
+}
+
+BOOST_AUTO_TEST_CASE(precompute_cache_eviction)
+{
+    PrecomputeLRUCache lru;
+    lru.SetMaxUsage(MIN_PRECOMPUTE_CACHE_SIZE << 20);
+    const size_t nMaxUsage = lru.GetStats().nMaxUsage;
+    BOOST_CHECK_EQUAL(nMaxUsage, (size_t)MIN_PRECOMPUTE_CACHE_SIZE << 20);
+
+    // Fill the cache with clean entries, touching the first one so that it is the most recently used
+    std::vector<uint256> vHashes;
+    while (lru.GetStats().nEvictions == 0) {
+        vHashes.emplace_back(GetRandHash());
+        lru.AddNew(vHashes.back(), RandomCacheData());
+        if (vHashes.size() > 1)
+            lru.AddNew(vHashes[0], RandomCacheData());
+    }
+
+    //! The budget holds and the least recently used entry went first
+    BOOST_CHECK(lru.DynamicMemoryUsage() <= nMaxUsage);
+    BOOST_CHECK(lru.Contains(vHashes[0]));
+    BOOST_CHECK(!lru.Contains(vHashes[1]));
+    BOOST_CHECK(lru.Contains(vHashes.back()));
+    BOOST_CHECK_EQUAL(lru.DirtyCacheSize(), 0);
+    BOOST_CHECK(!lru.IsFlushNeeded());
+
+    // Dirty entries are not evicted, even over the budget
+    std::vector<uint256> vDirty;
+    for (size_t i = 0; i < vHashes.size(); i++) {
+        vDirty.emplace_back(GetRandHash());
+        lru.AddToCache(vDirty.back(), RandomCacheData());
+    }
+    BOOST_CHECK(lru.DynamicMemoryUsage() > nMaxUsage);
+    BOOST_CHECK(lru.IsFlushNeeded());
+    for (const uint256& hash : vDirty)
+        BOOST_CHECK(lru.Contains(hash));
+
+    //! Shrinking to the minimum budget evicts every clean entry and keeps the dirty ones
+    lru.SetMaxUsage(0);
+    BOOST_CHECK_EQUAL(lru.DirtyCacheSize(), (int)vDirty.size());
+    BOOST_CHECK_EQUAL(lru.Size(), (int)vDirty.size());
+
+    lru.Clear();
+    BOOST_CHECK_EQUAL(lru.Size(), 0);
+    BOOST_CHECK_EQUAL(lru.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK_EQUAL(lru.DirtyCacheSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(precompute_cache_flush)
+{
+    CPrecomputeDB db(1 << 20, true, true);
+    PrecomputeLRUCache lru;
+
+    std::vector<uint256> vHashes;
+    for (int i = 0; i < 10; i++) {
+        vHashes.emplace_back(GetRandHash());
+        lru.AddToCache(vHashes.back(), RandomCacheData());
+    }
+
+    //! The flush writes the dirty entries and leaves them clean
+    BOOST_CHECK(lru.FlushToDisk(&db));
+    BOOST_CHECK_EQUAL(lru.DirtyCacheSize(), 0);
+    CoinWitnessCacheData data;
+    for (const uint256& hash : vHashes)
+        BOOST_CHECK(db.ReadPrecompute(hash, data));
+    BOOST_CHECK_EQUAL(lru.GetStats().nEntriesFlushed, vHashes.size());
+
+    // An entry removed from the cache and the database stays removed after the next flush
+    lru.AddToCache(vHashes[0], RandomCacheData());
+    lru.AddToCache(vHashes[1], RandomCacheData());
+    lru.Remove(vHashes[0]);
+    BOOST_CHECK(db.ErasePrecompute(vHashes[0]));
+    BOOST_CHECK(lru.FlushToDisk(&db));
+    BOOST_CHECK(!db.ReadPrecompute(vHashes[0], data));
+    BOOST_CHECK(db.ReadPrecompute(vHashes[1], data));
+
+    // Removals made while the flush writes are erased by the flush, see PrecomputeLRUCache::FlushToDisk
+    std::vector<std::pair<uint256, CoinWitnessCacheData>> vWrite(1, std::make_pair(vHashes[2], RandomCacheData()));
+    BOOST_CHECK(db.WritePrecomputes(vWrite, std::vector<uint256>(1, vHashes[3])));
+    BOOST_CHECK(db.ReadPrecompute(vHashes[2], data));
+    BOOST_CHECK(!db.ReadPrecompute(vHashes[3], data));
+}
+
+BOOST_AUTO_TEST_CASE(precompute_cache_size_arg)
+{
+    Precompute precompute;
+    for (const auto& arg : std::vector<std::pair<std::string, int64_t>>{{"16", 16}, {"1", 1}, {"0", MIN_PRECOMPUTE_CACHE_SIZE}, {"-5", MIN_PRECOMPUTE_CACHE_SIZE}}) {
+        gArgs.ForceSetArg("-precomputecachesize", arg.first);
+        precompute.ReadArgs();
+        BOOST_CHECK_EQUAL(precompute.lru.GetStats().nMaxUsage, (size_t)arg.second << 20);
+    }
+    gArgs.ForceSetArg("-precomputecachesize", std::to_string(DEFAULT_PRECOMPUTE_CACHE_SIZE));
+}
+
+BOOST_AUTO_TEST_CASE(precompute_cache_info)
+{
+    pprecompute.reset(new Precompute());
+    pprecompute->lru.AddNew(GetRandHash(), RandomCacheData());
+    pprecompute->lru.AddToCache(GetRandHash(), RandomCacheData());
+
+    JSONRPCRequest request;
+    request.strMethod = "getprecomputecacheinfo";
+    request.params = UniValue(UniValue::VARR);
+    UniValue info = tableRPC["getprecomputecacheinfo"]->actor(request);
+    BOOST_CHECK_EQUAL(find_value(info, "entries").get_int(), 2);
+    BOOST_CHECK_EQUAL(find_value(info, "dirty_entries").get_int(), 1);
+    BOOST_CHECK_EQUAL(find_value(info, "usage").get_int64(), (int64_t)pprecompute->lru.DynamicMemoryUsage());
+    BOOST_CHECK_EQUAL(find_value(info, "max_usage").get_int64(), DEFAULT_PRECOMPUTE_CACHE_SIZE << 20);
+    BOOST_CHECK_EQUAL(find_value(info, "evictions").get_int(), 0);
+
+    request.params.push_back(1);
+    BOOST_CHECK_THROW(tableRPC["getprecomputecacheinfo"]->actor(request), std::runtime_error);
+    pprecompute.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -67,7 +67,7 @@ static const int ZQ_11110 = 11110;
 static CCriticalSection cs_wallets;
 static std::vector<std::shared_ptr<CWallet>> vpwallets GUARDED_BY(cs_wallets);
 
-bool fGlobalUnlockSpendCache = false;
+std::atomic<bool> fGlobalUnlockSpendCache(false);
 
 bool AddWallet(const std::shared_ptr<CWallet>& wallet)
 {
@@ -3890,6 +3890,107 @@ bool CWallet::SelectStakeCoins(std::list<std::unique_ptr<ZerocoinStake> >& listI
     return true;
 }
 
+//Figure out if limp mod is enabled. If this is a PoS tx need to see if the next block will have it enabled too
+static bool IsZCLimpModeForSpend(libzerocoin::SpendType spendType)
+{
+    ThresholdState thresholdState = VersionBitsTipState(Params().GetConsensus(), Consensus::DEPLOYMENT_ZC_LIMP);
+    if (thresholdState == ThresholdState::LOCKED_IN && spendType == libzerocoin::STAKE) {
+        int nHeightSince = VersionBitsTipStateSinceHeight(Params().GetConsensus(), Consensus::DEPLOYMENT_ZC_LIMP);
+        if (chainActive.Height()+1 - nHeightSince == Params().BIP9Period())
+            return true;
+    } else if (thresholdState == ThresholdState::ACTIVE) {
+        return true;
+    }
+    return false;
+}
+
+void CWallet::PrepareStakeSpends(int nCandidates)
+{
+    std::list<std::unique_ptr<ZerocoinStake> > listInputs;
+    if (!SelectStakeCoins(listInputs, GetBalance()))
+        return;
+
+    // The chance of finding a kernel grows with the value of the input, so the largest denominations go first
+    listInputs.sort([](const std::unique_ptr<ZerocoinStake>& a, const std::unique_ptr<ZerocoinStake>& b) {
+        return a->GetValue() > b->GetValue();
+    });
+
+    std::set<uint256> setCandidates;
+    for (std::unique_ptr<ZerocoinStake>& stakeInput : listInputs) {
+        if ((int)setCandidates.size() >= nCandidates)
+            break;
+        boost::this_thread::interruption_point();
+        if (IsLocked() || ShutdownRequested())
+            return;
+
+        CBlockIndex* pindexFrom;
+        {
+            LOCK(cs_main);
+            pindexFrom = stakeInput->GetIndexFrom();
+        }
+        if (!pindexFrom || pindexFrom->nHeight < 1)
+            continue;
+
+        // The spend stays valid until the accumulator checkpoint of the stake moves on
+        uint256 hashStake = stakeInput->GetSerialStakeHash();
+        setCandidates.emplace(hashStake);
+        {
+            LOCK(cs_preparedstakes);
+            auto it = mapPreparedStakes.find(hashStake);
+            if (it != mapPreparedStakes.end() && it->second->pindexCheckpoint == pindexFrom)
+                continue;
+        }
+
+        CZerocoinMint mint;
+        if (!GetMintFromStakeHash(hashStake, mint))
+            continue;
+
+        int64_t nTimeStart = GetTimeMillis();
+        int nSecurityLevel = 100;
+        CZerocoinSpendReceipt receipt;
+        std::shared_ptr<CPreparedMintSpend> prepared = std::make_shared<CPreparedMintSpend>();
+        if (!PrepareMintSpend(mint, nSecurityLevel, receipt, libzerocoin::SpendType::STAKE, pindexFrom, *prepared)) {
+            LogPrint(BCLog::BLOCKCREATION, "%s: failed to prepare stake %s: %s\n", __func__, hashStake.GetHex(), receipt.GetStatusMessage());
+            continue;
+        }
+        LogPrint(BCLog::BLOCKCREATION, "%s: prepared stake %s at checkpoint %d in %dms\n", __func__, hashStake.GetHex(),
+                pindexFrom->nHeight, GetTimeMillis() - nTimeStart);
+
+        LOCK(cs_preparedstakes);
+        mapPreparedStakes[hashStake] = prepared;
+    }
+
+    // Drop the spends of inputs that are no longer candidates
+    LOCK(cs_preparedstakes);
+    for (auto it = mapPreparedStakes.begin(); it != mapPreparedStakes.end();) {
+        if (!setCandidates.count(it->first))
+            it = mapPreparedStakes.erase(it);
+        else
+            ++it;
+    }
+}
+
+bool CWallet::TakePreparedStake(const uint256& hashStake, const CBlockIndex* pindexCheckpoint, std::shared_ptr<CPreparedMintSpend>& prepared)
+{
+    {
+        // The commitments of the serial number SoK can only be used once, so the spend is removed even if it is not used
+        LOCK(cs_preparedstakes);
+        auto it = mapPreparedStakes.find(hashStake);
+        if (it == mapPreparedStakes.end())
+            return false;
+        prepared = it->second;
+        mapPreparedStakes.erase(it);
+    }
+
+    return prepared->pindexCheckpoint == pindexCheckpoint && prepared->fZCLimpMode == IsZCLimpModeForSpend(libzerocoin::SpendType::STAKE);
+}
+
+void CWallet::ClearPreparedStakes()
+{
+    LOCK(cs_preparedstakes);
+    mapPreparedStakes.clear();
+}
+
 
 /**
  * Call after CreateTransaction unless you want to abort
@@ -5545,6 +5646,16 @@ CScript GetLargestContributor(std::set<CInputCoin>& setCoins)
 
 bool CWallet::MintToTxIn(CZerocoinMint zerocoinSelected, int nSecurityLevel, const uint256& hashTxOut, CTxIn& newTxIn,
                          CZerocoinSpendReceipt& receipt, libzerocoin::SpendType spendType, CBlockIndex* pindexCheckpoint)
+{
+    CPreparedMintSpend prepared;
+    if (!PrepareMintSpend(zerocoinSelected, nSecurityLevel, receipt, spendType, pindexCheckpoint, prepared))
+        return false;
+
+    return SignMintSpend(prepared, hashTxOut, newTxIn, receipt);
+}
+
+bool CWallet::PrepareMintSpend(CZerocoinMint zerocoinSelected, int nSecurityLevel, CZerocoinSpendReceipt& receipt,
+                               libzerocoin::SpendType spendType, CBlockIndex* pindexCheckpoint, CPreparedMintSpend& prepared, bool fProve)
 {
     auto hashSerial = GetSerialHash(zerocoinSelected.GetSerialNumber());
     CMintMeta meta = zTracker->Get(hashSerial);
@@ -5577,7 +5688,6 @@ bool CWallet::MintToTxIn(CZerocoinMint zerocoinSelected, int nSecurityLevel, con
     receipt.SetStatus(_("Transaction Mint Started"), ZTXMINT_GENERAL);
 
     // 2. Get pubcoin from the private coin
-    libzerocoin::CoinDenomination denomination = zerocoinSelected.GetDenomination();
     libzerocoin::PublicCoin pubCoinSelected = *coinwitness.coin;
     if (!pubCoinSelected.validate()) {
         receipt.SetStatus(_("The selected mint coin is an invalid coin"), ZINVALID_COIN);
@@ -5593,7 +5703,8 @@ bool CWallet::MintToTxIn(CZerocoinMint zerocoinSelected, int nSecurityLevel, con
     }
 
     // Construct the CoinSpend object. This acts like a signature on the transaction.
-    libzerocoin::PrivateCoin privateCoin(Params().Zerocoin_Params(), coinwitness.denom, false);
+    prepared.privateCoin.reset(new libzerocoin::PrivateCoin(Params().Zerocoin_Params(), coinwitness.denom, false));
+    libzerocoin::PrivateCoin& privateCoin = *prepared.privateCoin;
     privateCoin.setPublicCoin(*coinwitness.coin);
     privateCoin.setRandomness(zerocoinSelected.GetRandomness());
     privateCoin.setSerialNumber(zerocoinSelected.GetSerialNumber());
@@ -5606,35 +5717,60 @@ bool CWallet::MintToTxIn(CZerocoinMint zerocoinSelected, int nSecurityLevel, con
         return error("%s: failed to set zerocoin privkey mint version=%d", __func__, nVersion);
     privateCoin.setPrivKey(key.GetPrivKey());
 
-    libzerocoin::Accumulator accumulator = mapAccumulators.GetAccumulator(coinwitness.denom);
+    prepared.accumulator.reset(new libzerocoin::Accumulator(mapAccumulators.GetAccumulator(coinwitness.denom)));
+    libzerocoin::Accumulator& accumulator = *prepared.accumulator;
     auto nChecksum = GetChecksum(accumulator.getValue());
     CBigNum bnValue;
     if (!GetAccumulatorValueFromChecksum(nChecksum, false, bnValue) || bnValue == 0)
         return error("%s: could not find checksum used for spend\n", __func__);
 
+    prepared.witness = std::move(coinwitness.pWitness);
+    prepared.nChecksum = nChecksum;
     try {
+        prepared.fZCLimpMode = IsZCLimpModeForSpend(spendType);
+        uint8_t nVersion = prepared.fZCLimpMode ? libzerocoin::CoinSpend::V4_LIMP : libzerocoin::CoinSpend::V3_SMALL_SOK;
 
-        //Figure out if limp mod is enabled. If this is a PoS tx need to see if the next block will have it enabled too
-        bool fZCLimpMode = false;
-        BIP9Stats statsStruct = VersionBitsTipStatistics(Params().GetConsensus(), Consensus::DEPLOYMENT_ZC_LIMP);
-        ThresholdState thresholdState = VersionBitsTipState(Params().GetConsensus(), Consensus::DEPLOYMENT_ZC_LIMP);
-        if (thresholdState == ThresholdState::LOCKED_IN && spendType == libzerocoin::STAKE) {
-            int nHeightSince = VersionBitsTipStateSinceHeight(Params().GetConsensus(), Consensus::DEPLOYMENT_ZC_LIMP);
-            if (chainActive.Height()+1 - nHeightSince == Params().BIP9Period())
-                fZCLimpMode = true;
-        } else if (thresholdState == ThresholdState::ACTIVE) {
-            fZCLimpMode = true;
-        }
+        // Everything but the parts of the proof that are bound to the transaction hash
+        if (fProve)
+            prepared.spend.reset(new libzerocoin::CoinSpend(Params().Zerocoin_Params(), privateCoin, accumulator, nChecksum, *prepared.witness, spendType, nVersion));
+    } catch (const std::exception&) {
+        receipt.SetStatus(_("CoinSpend: Accumulator witness does not verify"), ZINVALID_WITNESS);
+        return false;
+    }
 
-        uint8_t nVersion = fZCLimpMode ? libzerocoin::CoinSpend::V4_LIMP : libzerocoin::CoinSpend::V3_SMALL_SOK;
+    prepared.mint = zerocoinSelected;
+    prepared.pindexCheckpoint = pindexCheckpoint;
+    prepared.nMintsAdded = coinwitness.nMintsAdded;
+    return true;
+}
 
-        libzerocoin::CoinSpend spend(Params().Zerocoin_Params(), privateCoin, accumulator, nChecksum, *coinwitness.pWitness, hashTxOut, spendType, nVersion);
+bool CWallet::SignMintSpend(CPreparedMintSpend& prepared, const uint256& hashTxOut, CTxIn& newTxIn, CZerocoinSpendReceipt& receipt)
+{
+    try {
+        libzerocoin::CoinSpend& spend = *prepared.spend;
+        spend.Sign(*prepared.privateCoin, hashTxOut);
 
         std::string strError;
-        if (!spend.Verify(accumulator, strError, true, fZCLimpMode)) {
+        if (!spend.Verify(*prepared.accumulator, strError, true, prepared.fZCLimpMode)) {
             receipt.SetStatus(_("The new spend coin transaction did not verify"), ZINVALID_WITNESS);
             return false;
         }
+    } catch (const std::exception&) {
+        receipt.SetStatus(_("CoinSpend: Accumulator witness does not verify"), ZINVALID_WITNESS);
+        return false;
+    }
+
+    return MintSpendToTxIn(prepared, newTxIn, receipt);
+}
+
+bool CWallet::MintSpendToTxIn(const CPreparedMintSpend& prepared, CTxIn& newTxIn, CZerocoinSpendReceipt& receipt)
+{
+    const CZerocoinMint& zerocoinSelected = prepared.mint;
+    libzerocoin::CoinDenomination denomination = zerocoinSelected.GetDenomination();
+    const libzerocoin::Accumulator& accumulator = *prepared.accumulator;
+
+    try {
+        const libzerocoin::CoinSpend& spend = *prepared.spend;
         // Deserialize the CoinSpend intro a fresh object
         CDataStream serializedCoinSpend(SER_NETWORK, PROTOCOL_VERSION);
         serializedCoinSpend << spend;
@@ -5674,7 +5810,7 @@ bool CWallet::MintToTxIn(CZerocoinMint zerocoinSelected, int nSecurityLevel, con
         auto nAccumulatorChecksum = GetChecksum(accumulator.getValue());
         CZerocoinSpend zcSpend(spend.getCoinSerialNumber(), uint256(), zerocoinSelected.GetValue(),
                 zerocoinSelected.GetDenomination(), nAccumulatorChecksum);
-        zcSpend.SetMintCount(coinwitness.nMintsAdded);
+        zcSpend.SetMintCount(prepared.nMintsAdded);
         receipt.AddSpend(zcSpend);
     } catch (const std::exception&) {
         receipt.SetStatus(_("CoinSpend: Accumulator witness does not verify"), ZINVALID_WITNESS);
@@ -6508,12 +6644,49 @@ bool CWallet::CreateZerocoinSpendTransaction(CAmount nValue, int nSecurityLevel,
             //hash with only the output info in it to be used in Signature of Knowledge
             uint256 hashTxOut = wtxNew.tx->GetOutputsHash();
 
+            //the witnesses read the chain and the wallet, so they are generated here while holding the locks
+            std::vector<CPreparedMintSpend> vPrepared(vSelectedMints.size());
+            std::vector<CoinSpendJob> vJobs(vSelectedMints.size());
+            for (unsigned int i = 0; i < vSelectedMints.size(); i++) {
+                CPreparedMintSpend& prepared = vPrepared[i];
+                if (!PrepareMintSpend(vSelectedMints[i], nSecurityLevel, receipt, libzerocoin::SpendType::SPEND, nullptr, prepared, /*fProve*/false))
+                    return error("%s: %s", __func__, receipt.GetStatusMessage());
+
+                CoinSpendJob& job = vJobs[i];
+                job.coin = prepared.privateCoin.get();
+                job.accumulator = prepared.accumulator.get();
+                job.nChecksum = prepared.nChecksum;
+                job.witness = prepared.witness.get();
+                job.spendType = libzerocoin::SpendType::SPEND;
+                job.nVersion = prepared.fZCLimpMode ? libzerocoin::CoinSpend::V4_LIMP : libzerocoin::CoinSpend::V3_SMALL_SOK;
+            }
+
+            //the proofs of the inputs don't depend on each other, so they are built on all cores
+            int64_t nTimeProofs = GetTimeMillis();
+            int nThreads = std::max(1, std::min(GetNumCores(), (int)vJobs.size()));
+            std::string strProgress = strprintf("%s " + _("Building zerocoin spend proofs..."), GetDisplayName());
+            uiInterface.ShowProgress(strProgress, 0, false);
+            bool fProved = ThreadedCreateCoinSpends(Params().Zerocoin_Params(), vJobs, hashTxOut, nThreads, [&](size_t nDone) {
+                uiInterface.ShowProgress(strProgress, std::min(99, (int)(nDone * 100 / vJobs.size())), false);
+            });
+            uiInterface.ShowProgress(strProgress, 100, false);
+            LogPrintf("%s: built %u spend proofs on %d threads in %dms\n", __func__, vJobs.size(), nThreads, GetTimeMillis() - nTimeProofs);
+            if (!fProved) {
+                for (const CoinSpendJob& job : vJobs) {
+                    if (!job.spend) {
+                        receipt.SetStatus(_("The new spend coin transaction did not verify"), ZINVALID_WITNESS);
+                        return error("%s: %s: %s", __func__, receipt.GetStatusMessage(), job.strError);
+                    }
+                }
+            }
+
             //add all of the mints to the transaction as inputs
-            for (CZerocoinMint& mint : vSelectedMints) {
+            for (unsigned int i = 0; i < vPrepared.size(); i++) {
+                vPrepared[i].spend = std::move(vJobs[i].spend);
+
                 CTxIn newTxIn;
-                if (!MintToTxIn(mint, nSecurityLevel, hashTxOut, newTxIn, receipt, libzerocoin::SpendType::SPEND)) {
+                if (!MintSpendToTxIn(vPrepared[i], newTxIn, receipt))
                     return error("%s: %s", __func__, receipt.GetStatusMessage());
-                }
                 mtx.vin.push_back(newTxIn);
             }
 
@@ -6616,10 +6789,13 @@ void CWallet::StopPrecomputing()
     pprecompute->StopPrecomputing();
 }
 
-void CWallet::PrecomputeSpends()
+void CWallet::PrecomputeSpends(int nWorker, int nWorkers)
 {
-    LogPrintf("Veil Precomputing Started\n");
-    RenameThread("veil-precomputer");
+    LogPrintf("Veil Precomputing Started (worker %d of %d)\n", nWorker + 1, nWorkers);
+    if (nWorker)
+        RenameThread(strprintf("veil-precomp-%d", nWorker).c_str());
+    else
+        RenameThread("veil-precomputer");
     boost::this_thread::interruption_point();
     if (!pprecomputeDB) {
         LogPrintf("Veil Precomputing failed to get database pointer\n");
@@ -6631,23 +6807,31 @@ void CWallet::PrecomputeSpends()
         return;
     }
 
-    pprecompute->lru.Clear();
-
     // Initialize Variables
     bool fLoadedDB = false;
     int64_t nLastCacheCleanUpTime = GetTime();
     int64_t nLastCacheWriteDB = nLastCacheCleanUpTime;
     int nRequiredStakeDepthBuffer = Params().Zerocoin_RequiredStakeDepth() + 10;
+    std::map<libzerocoin::CoinDenomination, CWitnessBatch> mapWitnessBatch;
+
+    // Wait for a clear of the spend cache that is in progress before using it
+    uint64_t nClearGeneration = pprecompute->GetClearGeneration();
+    pprecompute->AcknowledgeClear(nWorker, nClearGeneration);
+
+    // The mints are shared out between the workers by serial hash
+    auto fWorkerMint = [nWorker, nWorkers](const CMintMeta& meta) {
+        return nWorkers < 2 || meta.hashSerial.GetCheapHash() % nWorkers == (uint64_t)nWorker;
+    };
 
     while (true) {
         boost::this_thread::interruption_point();
-        // Check to see if we need to clear the cache
-        if (fClearSpendCache) {
-            fClearSpendCache = false;
-            pprecompute->lru.Clear();
+        // When the spend cache is being cleared, drop everything taken from it and wait until the clear is done
+        if (pprecompute->GetClearGeneration() != nClearGeneration) {
+            mapWitnessBatch.clear();
+            nClearGeneration = pprecompute->GetClearGeneration();
+            pprecompute->AcknowledgeClear(nWorker, nClearGeneration);
             nLastCacheCleanUpTime = GetTime();
             nLastCacheWriteDB = nLastCacheCleanUpTime;
-            MilliSleep(5000);
         }
 
         if (ShutdownRequested())
@@ -6665,16 +6849,15 @@ void CWallet::PrecomputeSpends()
             continue;
         }
 
-        // If we haven't loaded from database yet, load the precomputes from the database
+        // The precompute database is loaded into the LRU cache by Precompute::StartPrecomputing
         if (!fLoadedDB) {
-            // Load the precomputes into the LRU cache
-            if (!pprecomputeDB->LoadPrecomputes(&(pprecompute->lru)))
-                LogPrint(BCLog::PRECOMPUTE, "%s: Failed to load precompute database\n", __func__);
             fLoadedDB = true;
 
             // Link LRU cache and Database to zTracker on first load
             LOCK(zTracker->cs_readlock);
             for (const auto& meta : setMints) {
+                if (!fWorkerMint(meta))
+                    continue;
 
                 CoinWitnessData *witnessData;
                 if (zTracker->HasSpendCache(meta.hashSerial)) {
@@ -6685,50 +6868,60 @@ void CWallet::PrecomputeSpends()
                 }
 
                 CoinWitnessCacheData cacheData;
-                if (pprecompute->lru.Contains(meta.hashSerial)) {
-                    *witnessData = pprecompute->lru.GetWitnessData(meta.hashSerial);
-                } else if (pprecomputeDB->ReadPrecompute(meta.hashSerial, cacheData)) {
+                if (!pprecompute->lru.GetWitnessData(meta.hashSerial, *witnessData) && pprecomputeDB->ReadPrecompute(meta.hashSerial, cacheData)) {
                     *witnessData = CoinWitnessData(cacheData);
                     pprecompute->lru.AddNew(meta.hashSerial, cacheData);
                 }
             }
         }
 
-        // Do some precomputing of zerocoin spend knowledge proofs
+        // Do some precomputing of zerocoin spend knowledge proofs, the witnesses of a denomination are advanced together
+        int64_t nTimeRoundStart = GetTimeMillis();
+        PrecomputeWorkerProgress progress;
+        progress.nHeightPrecomputed = std::numeric_limits<int>::max();
+        std::map<libzerocoin::CoinDenomination, std::vector<uint256>> mapDenomSerials;
         for (const CMintMeta& meta : setMints) {
+            if (!fWorkerMint(meta))
+                continue;
+            mapDenomSerials[meta.denom].emplace_back(meta.hashSerial);
+            progress.nMints++;
+        }
+
+        for (const auto& denomSerials : mapDenomSerials) {
             boost::this_thread::interruption_point();
             if (ShutdownRequested() || IsLocked())
                 break;
 
-            CoinWitnessCacheData tempDataHolder;
-            {
+            if (fGlobalUnlockSpendCache) {
+                break;
+            }
+
+            // When a clear of the spend cache is requested, break out of the loop
+            // All cache data will be dropped at the beginning of the while loop above
+            if (pprecompute->GetClearGeneration() != nClearGeneration) {
+                break;
+            }
+
+            // Work on copies of the witnesses, so that the spend cache is not locked during the exponentiations
+            std::vector<uint256> vHashSerials;
+            std::vector<CoinWitnessData> vWitnesses;
+            vWitnesses.reserve(denomSerials.second.size());
+            for (const uint256& hashSerial : denomSerials.second) {
+                CoinWitnessCacheData tempDataHolder;
                 CoinWitnessData* witnessData;
                 {
                     TRY_LOCK(zTracker->cs_readlock, fLocked);
                     if (!fLocked)
                         continue;
 
-                    if (fGlobalUnlockSpendCache) {
-                        break;
-                    }
-
-                    // When we see a clear spend cache bool set to true, break out of the loop
-                    // All cache data will be cleared at the beginning of the while loop above
-                    if (fClearSpendCache) {
-                        break;
-                    }
-
-                    if (zTracker->HasSpendCache(meta.hashSerial)) {
-                        witnessData = zTracker->GetSpendCache(meta.hashSerial);
+                    if (zTracker->HasSpendCache(hashSerial)) {
+                        witnessData = zTracker->GetSpendCache(hashSerial);
                     } else {
                         LOCK(zTracker->cs_modify_lock);
-                        witnessData = zTracker->CreateSpendCache(meta.hashSerial);
+                        witnessData = zTracker->CreateSpendCache(hashSerial);
                     }
                 }
 
-                // Initialize nHeightStop so it can be set below
-                int nHeightStop = 0;
-
                 // Precomputes takes a lower priority than the use (spend/stake) of a precompute, just move on in the rare
                 // case that this is locked somewhere else
                 TRY_LOCK(witnessData->cs, fLockWitness);
@@ -6737,70 +6930,129 @@ void CWallet::PrecomputeSpends()
 
                 /** If Witness is not already valid and loaded, then load/create it **/
                 if (!witnessData->nHeightAccStart) {
-                    if (pprecompute->lru.Contains(meta.hashSerial)) {
-                        /** Load witness from cache **/
-                        *witnessData = pprecompute->lru.GetWitnessData(meta.hashSerial);
+                    if (pprecompute->lru.GetWitnessData(hashSerial, *witnessData)) {
+                        /** Loaded witness from cache **/
                         LogPrint(BCLog::PRECOMPUTE, "%s: Got Witness Data from lru cache: %s\n", __func__, witnessData->ToString());
-                    } else if (pprecomputeDB->ReadPrecompute(meta.hashSerial, tempDataHolder)) {
+                    } else if (pprecomputeDB->ReadPrecompute(hashSerial, tempDataHolder)) {
                         /** Precompute was found on disk but not loaded to LRU **/
                         *witnessData = CoinWitnessData(tempDataHolder);
-                        pprecompute->lru.AddNew(meta.hashSerial, tempDataHolder);
+                        pprecompute->lru.AddNew(hashSerial, tempDataHolder);
                         LogPrint(BCLog::PRECOMPUTE, "%s: Got Witness Data from precompute database: %s\n", __func__, witnessData->ToString());
                     } else {
                         /** No cache, so initialize new **/
                         CZerocoinMint mint;
-                        if (!GetMint(meta.hashSerial, mint))
+                        if (!GetMint(hashSerial, mint))
                             continue;
                         *witnessData = CoinWitnessData(mint);
-                        nHeightStop = std::min(chainActive.Height() - nRequiredStakeDepthBuffer,
-                                               mint.GetHeight() + pprecompute->GetBlocksPerCycle());
                     }
                 }
 
-                if (!nHeightStop) {
-                    // Set the stop height from the variables received from the database cache
-                    int nStakeHeight = chainActive.Height() - nRequiredStakeDepthBuffer;
-                    int nAdjustableHeight = (witnessData->nHeightPrecomputed ? witnessData->nHeightPrecomputed : witnessData->nHeightAccStart) + pprecompute->GetBlocksPerCycle();
-                    nHeightStop = std::min(nStakeHeight, nAdjustableHeight);
-                }
+                if (!witnessData->coin)
+                    continue;
 
-                LogPrint(BCLog::PRECOMPUTE, "%s: StopHeight: %d already precomputedheight: %d\n", __func__, nHeightStop, witnessData->nHeightPrecomputed);
+                vHashSerials.emplace_back(hashSerial);
+                vWitnesses.emplace_back(*witnessData);
+            }
 
-                // Leave a buffer of 20 blocks between what to precompute
-                if (nHeightStop - (witnessData->nHeightPrecomputed ? witnessData->nHeightPrecomputed : witnessData->nHeightAccStart) < 20)
-                    continue;
+            if (vWitnesses.empty())
+                continue;
+
+            // Continue from where the batch stopped, or from the least precomputed witness when starting over
+            CWitnessBatch& batch = mapWitnessBatch.emplace(denomSerials.first, CWitnessBatch(denomSerials.first)).first->second;
+            int nHeightFrom = batch.GetHeightPrecomputed();
+            if (batch.IsNull()) {
+                nHeightFrom = std::numeric_limits<int>::max();
+                for (const CoinWitnessData& witness : vWitnesses)
+                    nHeightFrom = std::min(nHeightFrom, witness.nHeightPrecomputed ? witness.nHeightPrecomputed : witness.nHeightAccStart);
+            }
+
+            int nStakeHeight = chainActive.Height() - nRequiredStakeDepthBuffer;
+            int nHeightStop = std::min(nStakeHeight, nHeightFrom + pprecompute->GetBlocksPerCycle());
+
+            LogPrint(BCLog::PRECOMPUTE, "%s: StopHeight: %d already precomputedheight: %d\n", __func__, nHeightStop, nHeightFrom);
+
+            // Leave a buffer of 20 blocks between what to precompute
+            if (nHeightStop - nHeightFrom < 20)
+                continue;
+
+            // Accumulate up to the checkpoint that is at least ten blocks before the stop height
+            nHeightStop -= 10;
+            nHeightStop -= nHeightStop % 10;
+            LogPrint(BCLog::PRECOMPUTE,"%s: caching %d mints of denom %d stop=%d precomputed_to=%d\n", __func__,
+                     vWitnesses.size(), ZerocoinDenominationToInt(denomSerials.first), nHeightStop, nHeightFrom);
+
+            /** Add to the current precomputed witnesses **/
+            std::vector<CoinWitnessData*> vBatch;
+            for (CoinWitnessData& witness : vWitnesses)
+                vBatch.emplace_back(&witness);
+            if (!batch.Advance(vBatch, nHeightStop - 1)) {
+                LogPrintf("%s: Generate witnesses of denom %d failed!\n", __func__, ZerocoinDenominationToInt(denomSerials.first));
+                batch.SetNull();
+                continue;
+            }
 
-                CBlockIndex* pindexStop = chainActive[nHeightStop];
-                AccumulatorMap mapAccumulators(Params().Zerocoin_Params());
-                LogPrint(BCLog::PRECOMPUTE,"%s: caching mint %s of denom %d start=%d stop=%d precomputed_to=%s\n", __func__,
-                         witnessData->coin->getValue().GetHex().substr(0, 6),
-                         ZerocoinDenominationToInt(witnessData->denom),
-                         witnessData->nHeightAccStart, nHeightStop, witnessData->nHeightPrecomputed);
+            AccumulatorMap mapAccumulators(Params().Zerocoin_Params());
+            {
+                LOCK(cs_main);
+                mapAccumulators.Load(chainActive[nHeightStop + 10]->GetAccumulatorHashes());
+            }
+            libzerocoin::Accumulator accumulator = mapAccumulators.GetAccumulator(denomSerials.first);
 
-                /** Add to current precomputed witness **/
-                std::string strError;
-                if (!GenerateAccumulatorWitness(witnessData, mapAccumulators, 100, strError, pindexStop)) {
+            for (unsigned int i = 0; i < vWitnesses.size(); i++) {
+                boost::this_thread::interruption_point();
+                CoinWitnessData& witness = vWitnesses[i];
+                if (witness.nHeightPrecomputed != batch.GetHeightPrecomputed())
+                    continue;
+
+                witness.pWitness->resetValue(*witness.pAccumulator, *witness.coin);
+                if (!witness.pWitness->VerifyWitness(accumulator, *witness.coin)) {
                     LogPrintf("%s: Generate witness failed!\n", __func__);
                     // If we fail this check, we need to make sure we remove this from the LRU cache
-                    pprecompute->lru.Remove(meta.hashSerial);
-                    pprecomputeDB->ErasePrecompute(meta.hashSerial);
+                    pprecompute->lru.Remove(vHashSerials[i]);
+                    pprecomputeDB->ErasePrecompute(vHashSerials[i]);
+                    batch.SetNull();
                     continue;
                 }
 
+                // Only replace the cached witness if it was not advanced further while this one was computed
+                LOCK(zTracker->cs_readlock);
+                if (!zTracker->HasSpendCache(vHashSerials[i]))
+                    continue;
+                CoinWitnessData* witnessData = zTracker->GetSpendCache(vHashSerials[i]);
+                TRY_LOCK(witnessData->cs, fLockWitness);
+                if (!fLockWitness || witnessData->nHeightPrecomputed >= witness.nHeightPrecomputed)
+                    continue;
+                *witnessData = witness;
+
                 /** Update LRU with new data **/
                 CoinWitnessCacheData serialData(witnessData);
-                pprecompute->lru.AddToCache(meta.hashSerial, serialData);
+                pprecompute->lru.AddToCache(vHashSerials[i], serialData);
+                progress.nMintsUpdated++;
             }
-            // Sleep for 150ms to allow any potential spend attempt
-            MilliSleep(150);
+
+            // Write the dirty part of the cache out once it takes half of the cache budget
+            if (pprecompute->lru.IsFlushNeeded())
+                DumpPrecomputes();
         }
 
-        if (fGlobalUnlockSpendCache) {
-            fGlobalUnlockSpendCache = false;
+        {
+            LOCK(zTracker->cs_readlock);
+            for (const auto& denomSerials : mapDenomSerials) {
+                for (const uint256& hashSerial : denomSerials.second) {
+                    int nHeightPrecomputed = zTracker->HasSpendCache(hashSerial) ? zTracker->GetSpendCache(hashSerial)->nHeightPrecomputed : 0;
+                    progress.nHeightPrecomputed = std::min(progress.nHeightPrecomputed, nHeightPrecomputed);
+                }
+            }
         }
+        if (progress.nHeightPrecomputed == std::numeric_limits<int>::max())
+            progress.nHeightPrecomputed = 0;
+        progress.nRoundTime = GetTimeMillis() - nTimeRoundStart;
+        pprecompute->SetWorkerProgress(nWorker, progress);
+
+        fGlobalUnlockSpendCache = false;
 
         // Every 2 hours clean up our database and cache with only valid unspent inputs
-        if (nLastCacheCleanUpTime < (GetTime() - (PRECOMPUTE_FLUSH_TIME * 2))) {
+        if (!nWorker && nLastCacheCleanUpTime < (GetTime() - (PRECOMPUTE_FLUSH_TIME * 2))) {
             LogPrint(BCLog::PRECOMPUTE, "%s: Cleaning up precompute cache\n", __func__);
 
             std::set<CMintMeta> setMints = zTracker->ListMints(/*fUnusedOnly*/true, /*fMatureOnly*/true, /*fUpdate*/true);
@@ -6828,8 +7080,8 @@ void CWallet::PrecomputeSpends()
             }
         }
 
-        // On first load, and every 5 minutes write the cache to database
-        if (pprecompute->lru.DirtyCacheSize() > PRECOMPUTE_MAX_DIRTY_CACHE_SIZE || nLastCacheWriteDB < GetTime() - PRECOMPUTE_FLUSH_TIME || ShutdownRequested()) {
+        // On first load, and every hour write the dirty cache entries to database
+        if (!nWorker && (nLastCacheWriteDB < GetTime() - PRECOMPUTE_FLUSH_TIME || ShutdownRequested())) {
             DumpPrecomputes();
             nLastCacheWriteDB = GetTime();
         }
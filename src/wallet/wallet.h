@@ -49,7 +49,7 @@ std::shared_ptr<CWallet> GetMainWallet();
 
 extern CCriticalSection cs_main;
 
-extern bool fGlobalUnlockSpendCache; // Bool used for letting the precomputing thread know that zerospends need to use the cs_spendcache
+extern std::atomic<bool> fGlobalUnlockSpendCache; // Bool used for letting the precomputing thread know that zerospends need to use the cs_spendcache
 
 //! Default for -keypool
 static const unsigned int DEFAULT_KEYPOOL_SIZE = 1000;
@@ -75,11 +75,27 @@ static const unsigned int DEFAULT_TX_CONFIRM_TARGET = 6;
 static const bool DEFAULT_WALLET_RBF = false;
 static const bool DEFAULT_WALLETBROADCAST = true;
 static const bool DEFAULT_DISABLE_WALLET = false;
+//! Number of staking candidates that have their spend proofs built ahead of the kernel search
+static const int DEFAULT_STAKE_PREPARE = 4;
 
 typedef std::vector<std::pair<uint32_t, bool> > BIP32Path;
 typedef std::map<libzerocoin::CoinDenomination, CAmount> ZerocoinSpread;
 typedef std::tuple<CWalletTx, std::vector<CDeterministicMint>, std::vector<CZerocoinMint>> CommitData;
 
+/** A zerocoin spend with the proofs that do not depend on its transaction, waiting to be signed with the outputs hash */
+struct CPreparedMintSpend
+{
+    CZerocoinMint mint;
+    std::unique_ptr<libzerocoin::PrivateCoin> privateCoin;
+    std::unique_ptr<libzerocoin::Accumulator> accumulator;
+    std::unique_ptr<libzerocoin::AccumulatorWitness> witness;
+    uint256 nChecksum;
+    std::unique_ptr<libzerocoin::CoinSpend> spend;
+    CBlockIndex* pindexCheckpoint = nullptr;
+    bool fZCLimpMode = false;
+    int nMintsAdded = 0;
+};
+
 class CBlockIndex;
 class CCoinControl;
 class COutput;
@@ -688,6 +704,10 @@ protected:
     bool fStakingEnabled = true;
     bool fPrecomputingEnabled = false;
 
+    //! Prepared spends of the staking candidates, by stake hash. Each one is removed when it is used.
+    CCriticalSection cs_preparedstakes;
+    std::map<uint256, std::shared_ptr<CPreparedMintSpend>> mapPreparedStakes GUARDED_BY(cs_preparedstakes);
+
 
     WalletBatch *encrypted_batch = nullptr;
 
@@ -832,6 +852,13 @@ public:
             std::vector<CDeterministicMint>& vNewMints, bool fMintChange,  bool fMinimizeChange, CTxDestination* address = NULL);
     bool MintToTxIn(CZerocoinMint zerocoinSelected, int nSecurityLevel, const uint256& hashTxOut, CTxIn& newTxIn,
             CZerocoinSpendReceipt& receipt, libzerocoin::SpendType spendType, CBlockIndex* pindexCheckpoint = nullptr);
+    bool PrepareMintSpend(CZerocoinMint zerocoinSelected, int nSecurityLevel, CZerocoinSpendReceipt& receipt,
+            libzerocoin::SpendType spendType, CBlockIndex* pindexCheckpoint, CPreparedMintSpend& prepared, bool fProve = true);
+    bool SignMintSpend(CPreparedMintSpend& prepared, const uint256& hashTxOut, CTxIn& newTxIn, CZerocoinSpendReceipt& receipt);
+    bool MintSpendToTxIn(const CPreparedMintSpend& prepared, CTxIn& newTxIn, CZerocoinSpendReceipt& receipt);
+    void PrepareStakeSpends(int nCandidates);
+    bool TakePreparedStake(const uint256& hashStake, const CBlockIndex* pindexCheckpoint, std::shared_ptr<CPreparedMintSpend>& prepared);
+    void ClearPreparedStakes();
     std::string MintZerocoinFromOutPoint(CAmount nValue, CWalletTx& wtxNew, std::vector<CDeterministicMint>& vDMints,
             const std::vector<COutPoint> vOutpts);
     std::string MintZerocoin(CAmount nValue, CWalletTx& wtxNew, std::vector<CDeterministicMint>& vDMints, OutputTypes inputtype,
@@ -863,7 +890,7 @@ public:
     void SetSerialSpent(const uint256& bnSerial, const uint256& txid);
     void ArchiveZerocoin(CMintMeta& meta);
     void AutoZeromint();
-    void PrecomputeSpends();
+    void PrecomputeSpends(int nWorker = 0, int nWorkers = 1);
 
     CzTracker* GetZTrackerPointer() {
         return zTracker.get();